@@ -0,0 +1,235 @@
+//
+// bench.cpp --- Benchmark driver.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 21:27:43 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 21:27:43
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file bench.cpp
+ * @author Paul Ward
+ * @brief Benchmark driver.
+ *
+ * Run with no arguments to run every suite, or with the names of
+ * the suites to run.  The exit status is non-zero if a suite is not
+ * known or any check fails.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "bench.hpp"
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#endif
+
+/**
+ * @brief A benchmark suite.
+ */
+struct suite
+{
+  const char *name;                     //!< Name to run it by.
+  void      (*run)();                   //!< The suite.
+};
+
+/**
+ * @brief Every suite, in the order they are run.
+ */
+static const suite Suites[] = {
+  { "drawbuffer", bench::drawbuffer },
+  { "kernels",    bench::kernels    },
+  { "idle",       bench::idle       },
+  { "text",       bench::text       },
+  { "format",     bench::format     },
+  { "style",      bench::style      },
+  { "game",       bench::game       }
+};
+
+/**
+ * @brief The number of suites.
+ */
+static const std::size_t SuiteCount = sizeof(Suites) / sizeof(Suites[0]);
+
+volatile std::size_t bench::sink = 0;
+
+/**
+ * @brief The number of checks that have failed.
+ */
+static std::size_t Failures = 0;
+
+/**
+ * @brief Return the processor time used by the process so far.
+ *
+ * @c std::clock measures wall time with Microsoft's library, so the
+ * kernel and user times are asked for directly there.
+ */
+double
+bench::cpu_seconds()
+{
+#if defined(_WIN32)
+  FILETIME created, exited, kernel, user;
+
+  if (!GetProcessTimes(GetCurrentProcess(),
+                       &created,
+                       &exited,
+                       &kernel,
+                       &user))
+  {
+    return 0;
+  }
+
+  return (__CAST(double, kernel.dwLowDateTime) +
+          __CAST(double, kernel.dwHighDateTime) * 4294967296.0 +
+          __CAST(double, user.dwLowDateTime) +
+          __CAST(double, user.dwHighDateTime) * 4294967296.0) / 1e7;
+#else
+  return __CAST(double, std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * @brief Return the name of the cell layout this was built with.
+ */
+const char *
+bench::cell_layout()
+{
+#if defined(OVISION_DRAWBUFFER_SOA)
+  return "soa";
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+  return "packed";
+#else
+  return "aos";
+#endif
+}
+
+/**
+ * @brief Print a result.
+ * @param suite The suite the result is from.
+ * @param what What was measured.
+ * @param value The measurement.
+ * @param unit The unit of the measurement.
+ */
+void
+bench::report(const char *suite,
+              const char *what,
+              double      value,
+              const char *unit)
+{
+  std::printf("%-12s %-6s %-36s %14.3f %s\n",
+              suite,
+              cell_layout(),
+              what,
+              value,
+              unit);
+  std::fflush(stdout);
+}
+
+/**
+ * @brief Report the result of a check.
+ * @param suite The suite the check is from.
+ * @param what What was checked.
+ * @param mismatches The number of cells, values or the like that
+ *                   differed from what was expected.
+ *
+ * Any mismatch counts as a failure, and is reported on standard
+ * error as well so that it is not lost among the timings.
+ */
+void
+bench::expect(const char  *suite,
+              const char  *what,
+              std::size_t  mismatches)
+{
+  report(suite, what, __CAST(double, mismatches), "mismatches");
+
+  if (mismatches != 0) {
+    std::fprintf(stderr,
+                 "%s: %s: %s: FAILED\n",
+                 suite,
+                 cell_layout(),
+                 what);
+    ++Failures;
+  }
+}
+
+/**
+ * @brief Return the number of checks that have failed.
+ */
+std::size_t
+bench::failures()
+{
+  return Failures;
+}
+
+/**
+ * @brief Main routine.
+ * @param argc Number of arguments.
+ * @param argv The names of the suites to run.
+ */
+int
+main(int argc, char *argv[])
+{
+  int status = 0;
+
+  if (argc < 2) {
+    for (std::size_t i = 0; i < SuiteCount; ++i) {
+      Suites[i].run();
+    }
+
+    return bench::failures() == 0 ? 0 : 1;
+  }
+
+  for (int arg = 1; arg < argc; ++arg) {
+    std::size_t i = 0;
+
+    while (i < SuiteCount && std::strcmp(Suites[i].name, argv[arg]) != 0) {
+      ++i;
+    }
+
+    if (i == SuiteCount) {
+      std::fprintf(stderr, "%s: no such suite\n", argv[arg]);
+      status = 1;
+      continue;
+    }
+
+    Suites[i].run();
+  }
+
+  if (bench::failures() != 0) {
+    status = 1;
+  }
+
+  return status;
+}
+
+// bench.cpp ends here
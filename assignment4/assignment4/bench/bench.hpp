@@ -0,0 +1,149 @@
+//
+// bench.hpp --- Benchmark harness.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 12:33:48 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 12:33:48
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file bench.hpp
+ * @author Paul Ward
+ * @brief Benchmark harness.
+ *
+ * The benchmarks are built by bench.vcxproj, against the library
+ * sources with @c OVISION_HEADLESS defined, so they draw to the
+ * in-memory screen and read keys from a script.  Define
+ * @c OVISION_DRAWBUFFER_SOA or @c OVISION_DRAWBUFFER_PACKED as well
+ * to measure the other cell layouts; every result line says which
+ * layout it was taken with.
+ *
+ * Alongside the timings, the suites check that what they time gives
+ * the right answer, comparing each layout and code path against a
+ * plain reference.  The program exits with a non-zero status if any
+ * check finds a mismatch.
+ */
+
+#pragma once
+#ifndef _bench_hpp_
+#define _bench_hpp_
+
+#include <chrono>
+#include <cstddef>
+
+#include "compiler.hpp"
+
+namespace bench
+{
+
+  /**
+   * @typedef clock
+   * @brief The clock benchmarks are timed with.
+   */
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * @brief Somewhere to put results so the optimiser keeps the work
+   *        that made them.
+   */
+  extern volatile std::size_t sink;
+
+  // Timing functions.
+  double cpu_seconds();
+
+  // Reporting functions.
+  const char *cell_layout();
+  void        report(const char *suite,
+                     const char *what,
+                     double      value,
+                     const char *unit);
+
+  // Checking functions.
+  void        expect(const char  *suite,
+                     const char  *what,
+                     std::size_t  mismatches);
+  std::size_t failures();
+
+  /**
+   * @brief Return the seconds since a point in time.
+   * @param start The point in time.
+   */
+  inline
+  double
+  seconds_since(const clock::time_point &start)
+  {
+    return std::chrono::duration<double>(clock::now() - start).count();
+  }
+
+  /**
+   * @brief Time a piece of work.
+   * @param iterations The number of times to do the work per pass.
+   * @param fn The work.
+   * @returns The nanoseconds per iteration of the fastest of three
+   *          passes.
+   */
+  template <class _Fn>
+  double
+  nanoseconds(std::size_t iterations, _Fn fn)
+  {
+    double best = 0;
+
+    for (int pass = 0; pass < 3; ++pass) {
+      clock::time_point start = clock::now();
+      double            ns    = 0;
+
+      for (std::size_t i = 0; i < iterations; ++i) {
+        fn();
+      }
+
+      ns = seconds_since(start) * 1e9 / __CAST(double, iterations);
+
+      if (pass == 0 || ns < best) {
+        best = ns;
+      }
+    }
+
+    return best;
+  }
+
+  // Suites.
+  void drawbuffer();
+  void format();
+  void game();
+  void kernels();
+  void idle();
+  void style();
+  void text();
+
+}                                       // namespace bench
+
+#endif // !_bench_hpp_
+
+// bench.hpp ends here
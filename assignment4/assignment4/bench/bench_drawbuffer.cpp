@@ -0,0 +1,750 @@
+//
+// bench_drawbuffer.cpp --- Draw buffer benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 17:45:24 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 17:45:24
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file bench_drawbuffer.cpp
+ * @author Paul Ward
+ * @brief Draw buffer benchmarks.
+ *
+ * These time the draw buffer operations that the cell layout
+ * affects, on a classic 80 by 25 console and on a large 300 by 100
+ * one.  Build once per layout and compare the lines.
+ *
+ * Before timing anything, the same operations are checked against
+ * a frame kept as a plain array of attributed characters, which is
+ * the default layout written out by hand.  A layout that agrees with
+ * it agrees with every other layout.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "application.hpp"
+#include "drawbuffer.hpp"
+#include "frame.hpp"
+#include "keyboard.hpp"
+#include "picmap.hpp"
+#include "picpack.hpp"
+#include "picture.hpp"
+#include "screen.hpp"
+#include "text.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief A frame held as a plain array of attributed characters.
+ */
+typedef std::vector<achar> reference;
+
+/**
+ * @brief Count the cells of a buffer that differ from a reference.
+ * @param cells The cells.
+ * @param expect The reference.
+ */
+static
+std::size_t
+mismatches(const cell_buffer &cells, const reference &expect)
+{
+  std::size_t count = 0;
+
+  if (cells.size() != expect.size()) {
+    return expect.size();
+  }
+
+  for (std::size_t i = 0; i < expect.size(); ++i) {
+    achar cell = cells.get(i);
+
+    if (cell.character != expect[i].character ||
+        cell.attribute != expect[i].attribute)
+    {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+/**
+ * @brief Return a cell of a reference, if it may be drawn on.
+ * @param expect The reference.
+ * @param extent The size of the frame.
+ * @param clip The rectangle that may be drawn on.
+ * @param x The column.
+ * @param y The row.
+ * @returns The cell, or a null pointer if it is outside the frame or
+ *          the clip rectangle.
+ */
+static
+achar *
+cell_at(reference         &expect,
+        const screen_size &extent,
+        const rect        &clip,
+        signed             x,
+        signed             y)
+{
+  if (x < 0 || y < 0 ||
+      x >= __CAST(signed, extent.width) ||
+      y >= __CAST(signed, extent.height) ||
+      x < clip.left() || x >= clip.right() ||
+      y < clip.top()  || y >= clip.bottom())
+  {
+    return 0;
+  }
+
+  return &expect[__CAST(std::size_t, y) * extent.width +
+                 __CAST(std::size_t, x)];
+}
+
+/**
+ * @brief Fill a rectangle of a reference.
+ * @param expect The reference.
+ * @param extent The size of the frame.
+ * @param clip The rectangle that may be drawn on.
+ * @param area The rectangle to fill.
+ * @param c The character, or zero to leave the characters alone.
+ * @param attr The attribute.
+ */
+static
+void
+fill_reference(reference         &expect,
+               const screen_size &extent,
+               const rect        &clip,
+               const rect        &area,
+               char_t             c,
+               attr_t             attr)
+{
+  for (signed y = area.top(); y < area.bottom(); ++y) {
+    for (signed x = area.left(); x < area.right(); ++x) {
+      achar *cell = cell_at(expect, extent, clip, x, y);
+
+      if (cell != 0) {
+        cell->character = c != 0 ? c : cell->character;
+        cell->attribute = attr;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Write a run of characters to a reference.
+ * @param expect The reference.
+ * @param extent The size of the frame.
+ * @param clip The rectangle that may be drawn on.
+ * @param indent The offset of the first cell.
+ * @param str The characters.
+ * @param count The number of characters.
+ * @param attr The attribute.
+ *
+ * The run wraps from one row to the next, just as the buffer's own
+ * runs do.
+ */
+static
+void
+run_reference(reference         &expect,
+              const screen_size &extent,
+              const rect        &clip,
+              std::size_t        indent,
+              const char_t      *str,
+              std::size_t        count,
+              attr_t             attr)
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t at   = indent + i;
+    achar      *cell = cell_at(expect,
+                               extent,
+                               clip,
+                               __CAST(signed, at % extent.width),
+                               __CAST(signed, at / extent.width));
+
+    if (cell != 0) {
+      cell->character = str[i];
+      cell->attribute = attr;
+    }
+  }
+}
+
+/**
+ * @brief Draw a picture onto a reference.
+ * @param expect The reference.
+ * @param extent The size of the frame.
+ * @param clip The rectangle that may be drawn on.
+ * @param source The picture.
+ * @param from The rectangle of the picture to draw.
+ * @param to Where the top-left corner of @c from lands.
+ * @returns The number of cells drawn.
+ */
+static
+std::size_t
+blit_reference(reference         &expect,
+               const screen_size &extent,
+               const rect        &clip,
+               const picmap      &source,
+               const rect        &from,
+               const point       &to)
+{
+  signed      pw    = __CAST(signed, source.get_size().width);
+  signed      ph    = __CAST(signed, source.get_size().height);
+  std::size_t drawn = 0;
+
+  for (signed sy = from.top(); sy < from.bottom(); ++sy) {
+    for (signed sx = from.left(); sx < from.right(); ++sx) {
+      std::size_t index = __CAST(std::size_t, sy * pw + sx);
+      achar      *cell  = 0;
+
+      if (sx < 0 || sy < 0 || sx >= pw || sy >= ph ||
+          !source.is_opaque(index))
+      {
+        continue;
+      }
+
+      cell = cell_at(expect,
+                     extent,
+                     clip,
+                     to.x + sx - from.left(),
+                     to.y + sy - from.top());
+
+      if (cell != 0) {
+        *cell = source.get(index);
+        ++drawn;
+      }
+    }
+  }
+
+  return drawn;
+}
+
+/**
+ * @brief Make a patterned picture.
+ * @param width The width of the picture.
+ * @param height The height of the picture.
+ * @param masked Make some of its cells transparent?
+ */
+static
+picmap
+make_picture(unsigned width, unsigned height, bool masked)
+{
+  picmap picture(width, height);
+
+  for (std::size_t i = 0; i < picture.size(); ++i) {
+    picture.put(i, achar(__CAST(char_t, 'a' + i % 26),
+                         attr_t(__CAST(unsigned long, i % 256))));
+
+    if (masked) {
+      picture.set_opaque(i, (i % 3) != 0 && (i % 7) != 0);
+    }
+  }
+
+  return picture;
+}
+
+/**
+ * @brief Check the drawing operations against the reference.
+ * @param extent The size of the buffer.
+ *
+ * The buffer is drawn on with and without a clip rectangle, and
+ * after each step every cell must match the reference.
+ */
+static
+void
+check_layout(const screen_size &extent)
+{
+  signed      width  = __CAST(signed, extent.width);
+  signed      height = __CAST(signed, extent.height);
+  rect        whole(0, 0, width, height);
+  rect        box(2, 2, width - 4, height - 4);
+  rect        clip(width / 3, height / 4, width / 2, height / 2);
+  string_t    line(extent.width + 7, 'x');
+  picmap      picture(make_picture(extent.width / 2,
+                                   extent.height / 2,
+                                   false));
+  rect        from(0, 0, width / 2, height / 2);
+  point       to(width - width / 4, height / 3);
+  reference   expect(extent.width * extent.height);
+  std::size_t bad    = 0;
+  char        what[64];
+
+  screen::get_instance().set_size(extent);
+
+  draw_buffer buffer;
+
+  buffer.fill(whole, fg_grey | bg_blue, true);
+  fill_reference(expect, extent, whole, whole, ' ', fg_grey | bg_blue);
+  bad += mismatches(buffer.cells(), expect);
+
+  buffer.fill(box, fg_white | bg_blue, false);
+  fill_reference(expect, extent, whole, box, 0, fg_white | bg_blue);
+  bad += mismatches(buffer.cells(), expect);
+
+  // A run that starts near the end of a row wraps onto the next.
+  for (signed y = 0; y < height; y += 3) {
+    std::size_t indent = __CAST(std::size_t, y * width + width - 5);
+
+    buffer.move_str(indent, line, fg_green | bg_black);
+    run_reference(expect,
+                  extent,
+                  whole,
+                  indent,
+                  line.c_str(),
+                  std::min(line.size(), expect.size() - indent),
+                  fg_green | bg_black);
+  }
+  bad += mismatches(buffer.cells(), expect);
+
+  buffer.blit(picture, from, to);
+  blit_reference(expect, extent, whole, picture, from, to);
+  bad += mismatches(buffer.cells(), expect);
+
+  // The same again, inside a clip rectangle.
+  buffer.set_clip(clip);
+
+  buffer.fill(whole, fg_red | bg_black, true, '#');
+  fill_reference(expect, extent, clip, whole, '#', fg_red | bg_black);
+  bad += mismatches(buffer.cells(), expect);
+
+  for (signed y = 0; y < height; y += 2) {
+    std::size_t indent = __CAST(std::size_t, y * width + width / 4);
+
+    buffer.move_char(indent, '.', fg_cyan | bg_black, extent.width);
+    run_reference(expect,
+                  extent,
+                  clip,
+                  indent,
+                  string_t(extent.width, '.').c_str(),
+                  std::min(extent.width, expect.size() - indent),
+                  fg_cyan | bg_black);
+  }
+  bad += mismatches(buffer.cells(), expect);
+
+  buffer.blit(picture, from, point(width / 4, height / 5));
+  blit_reference(expect,
+                 extent,
+                 clip,
+                 picture,
+                 from,
+                 point(width / 4, height / 5));
+  bad += mismatches(buffer.cells(), expect);
+
+  std::sprintf(what, "%ux%u cells match reference",
+               __CAST(unsigned, extent.width),
+               __CAST(unsigned, extent.height));
+  bench::expect("drawbuffer", what, bad);
+}
+
+/**
+ * @brief Check that masked blits copy only the opaque cells.
+ * @param extent The size of the buffer.
+ *
+ * The picture is drawn partly off the buffer and through a clip
+ * rectangle, from both a picture and a pack image of the same cells,
+ * and only the cells copied may be counted as written.
+ */
+static
+void
+check_masked_blit(const screen_size &extent)
+{
+  signed                     width   = __CAST(signed, extent.width);
+  signed                     height  = __CAST(signed, extent.height);
+  rect                       whole(0, 0, width, height);
+  rect                       clip(1, 1, width - 9, height - 2);
+  picmap                     picture(make_picture(30, 12, true));
+  rect                       from(3, 2, 25, 12);
+  point                      to(width - 20, -3);
+  reference                  expect(extent.width * extent.height,
+                                    achar(' ', fg_grey | bg_blue));
+  std::vector<std::uint16_t> characters(picture.size());
+  std::vector<std::uint16_t> attributes(picture.size());
+  picpack_image              image;
+  std::size_t                drawn   = 0;
+  std::size_t                bad     = 0;
+  char                       what[64];
+
+  for (std::size_t i = 0; i < picture.size(); ++i) {
+    characters[i] = __CAST(std::uint16_t, picture.get(i).character);
+    attributes[i] = __CAST(std::uint16_t,
+                           picture.get(i).attribute.to_ulong());
+  }
+
+  image.name       = "check";
+  image.size       = picture.get_size();
+  image.characters = characters.data();
+  image.attributes = attributes.data();
+  image.mask       = picture.mask();
+
+  screen::get_instance().set_size(extent);
+
+  draw_buffer buffer;
+
+  drawn = blit_reference(expect, extent, clip, picture, from, to);
+
+  buffer.fill(whole, fg_grey | bg_blue, true);
+  buffer.reset_cell_writes();
+  buffer.blit(picture, from, to, clip);
+  bad += mismatches(buffer.cells(), expect);
+  bad += buffer.get_cell_writes() != drawn ? 1 : 0;
+
+  buffer.fill(whole, fg_grey | bg_blue, true);
+  buffer.reset_cell_writes();
+  buffer.blit(image, from, to, clip);
+  bad += mismatches(buffer.cells(), expect);
+  bad += buffer.get_cell_writes() != drawn ? 1 : 0;
+
+  std::sprintf(what, "%ux%u masked blit",
+               __CAST(unsigned, extent.width),
+               __CAST(unsigned, extent.height));
+  bench::expect("drawbuffer", what, bad);
+}
+
+/**
+ * @brief Check that cell views are clipped.
+ * @param extent The size of the buffer.
+ *
+ * A view of a rectangle that runs off the clip rectangle, and views
+ * of parts of it, may only write inside the clip rectangle.
+ */
+static
+void
+check_span_clip(const screen_size &extent)
+{
+  signed      width  = __CAST(signed, extent.width);
+  signed      height = __CAST(signed, extent.height);
+  rect        whole(0, 0, width, height);
+  rect        clip(5, 3, width / 2, height / 2);
+  rect        area(-4, 1, width / 2 + 6, height);
+  picmap      picture(make_picture(20, 6, false));
+  reference   expect(extent.width * extent.height);
+  std::size_t bad    = 0;
+  char        what[64];
+
+  screen::get_instance().set_size(extent);
+
+  draw_buffer buffer;
+
+  buffer.fill(whole, fg_grey | bg_blue, true);
+  fill_reference(expect, extent, whole, whole, ' ', fg_grey | bg_blue);
+
+  buffer.set_clip(clip);
+
+  // The view is what is left of the area inside the clip rectangle,
+  // and views of parts of it are relative to its corner.
+  cell_span2d view   = buffer.span(area);
+  rect        inside = view.get_area();
+  cell_span2d stripe = view.sub(rect(2, 2, width, 3));
+  cell_span2d corner = view.sub(rect(inside.extent.width - 4, 1, 10, 10));
+
+  view.fill('*', fg_yellow | bg_black);
+  fill_reference(expect, extent, clip, area, '*', fg_yellow | bg_black);
+  bad += mismatches(buffer.cells(), expect);
+
+  stripe.fill_attributes(fg_red | bg_black);
+  fill_reference(expect,
+                 extent,
+                 inside,
+                 rect(inside.left() + 2, inside.top() + 2, width, 3),
+                 0,
+                 fg_red | bg_black);
+  bad += mismatches(buffer.cells(), expect);
+
+  corner.copy(picture.span(rect(0, 0, 20, 6)));
+  blit_reference(expect,
+                 extent,
+                 inside,
+                 picture,
+                 rect(0, 0, 20, 6),
+                 point(inside.right() - 4, inside.top() + 1));
+  bad += mismatches(buffer.cells(), expect);
+
+  std::sprintf(what, "%ux%u span clipping",
+               __CAST(unsigned, extent.width),
+               __CAST(unsigned, extent.height));
+  bench::expect("drawbuffer", what, bad);
+}
+
+/**
+ * @brief Check that presenting a frame reproduces it.
+ * @param extent The size of the screen.
+ *
+ * The first frame is sent whole; the second only as the spans the
+ * shadow diff finds.  Either way the screen must end up showing the
+ * frame, and only the cells that changed may be counted as changed.
+ */
+static
+void
+check_present(const screen_size &extent)
+{
+  screen      &scr     = screen::get_instance();
+  signed       width   = __CAST(signed, extent.width);
+  signed       height  = __CAST(signed, extent.height);
+  rect         whole(0, 0, width, height);
+  std::size_t  changed = 0;
+  std::size_t  bad     = 0;
+  char         what[64];
+
+  scr.set_size(extent);
+  scr.init();
+
+  draw_buffer buffer;
+
+  buffer.fill(whole, fg_grey | bg_blue, true);
+  scr.render_buffer(buffer);
+  bad += mismatches(buffer.cells(),
+                    reference(scr.get_surface().begin(),
+                              scr.get_surface().end()));
+
+  // Scattered cells, some of them on the same row, and a block.
+  for (std::size_t i = 7; i < buffer.size(); i += 13 + i % 5) {
+    buffer.put_char(i, 'o', fg_white | bg_red);
+    ++changed;
+  }
+
+  for (signed y = 0; y < 3; ++y) {
+    for (signed x = 0; x < 4; ++x) {
+      std::size_t at = __CAST(std::size_t, (y + 2) * width + x + 1);
+
+      if (buffer.cells().get(at).character != 'o') {
+        ++changed;
+      }
+    }
+  }
+  buffer.fill(rect(1, 2, 4, 3), fg_green | bg_black, true, '+');
+
+  scr.reset_present_stats();
+  scr.render_buffer(buffer);
+  bad += mismatches(buffer.cells(),
+                    reference(scr.get_surface().begin(),
+                              scr.get_surface().end()));
+  bad += scr.get_present_stats().cells_changed != changed ? 1 : 0;
+
+  std::sprintf(what, "%ux%u present reproduces frame",
+               __CAST(unsigned, extent.width),
+               __CAST(unsigned, extent.height));
+  bench::expect("drawbuffer", what, bad);
+
+  scr.shutdown();
+}
+
+/**
+ * @brief Check that the painter writes each damaged cell once.
+ *
+ * A frame is drawn with a masked picture and a word wrapped text
+ * view over it, whose lines are of different lengths, and a short
+ * text view over that.  Every cell of the damage should be written
+ * exactly once.  Built with @c OVISION_COUNT_OVERDRAW, the draw
+ * buffer's own count of cells written over must be zero as well.
+ */
+static
+void
+check_painter()
+{
+  application app;
+  keyboard   &kbd = keyboard::get_instance();
+  frame       box(rect(0, 0, 80, 18));
+  picture     graphic(rect(5, 3, 24, 12));
+  picmap      image(10, 6);
+  text        wrapped(L"one two three four five six seven eight nine",
+                      screen_point(30, 4),
+                      12,
+                      AlignCenter,
+                      fg_yellow | bg_blue);
+  text        label(L"label", screen_point(31, 5), fg_green | bg_blue);
+  std::size_t writes = 0;
+  std::size_t area   = 0;
+
+  screen::get_instance().set_size(screen_size(80, 25));
+
+  for (std::size_t i = 0; i < image.size(); ++i) {
+    image.put(i, achar('#', fg_red | bg_black));
+    image.set_opaque(i, i % 3 != 0);
+  }
+
+  box.set_title(L"Painter");
+  graphic.set_picmap(image);
+  wrapped.set_word_wrap(true);
+  wrapped.set_width(12);
+
+  app.add_view(box);
+  app.add_view(graphic);
+  app.add_view(wrapped);
+  app.add_view(label);
+  app.add_key_callback([&app](char_t) { app.stop(); });
+
+  kbd.feed("x");
+  app.start();
+
+  writes = app.get_frame_writes();
+  area   = app.get_frame_area();
+
+  bench::expect("drawbuffer",
+                "painter writes damaged cells once",
+                writes > area ? writes - area : area - writes);
+#if defined(OVISION_COUNT_OVERDRAW)
+  bench::expect("drawbuffer",
+                "painter overdraw",
+                app.get_frame_overdraw());
+#endif
+}
+
+/**
+ * @brief Time the draw buffer at one size.
+ * @param extent The size of the buffer.
+ */
+static
+void
+run_size(const screen_size &extent)
+{
+  screen     &scr    = screen::get_instance();
+  signed      width  = __CAST(signed, extent.width);
+  signed      height = __CAST(signed, extent.height);
+  std::size_t cells  = extent.width * extent.height;
+  std::size_t loops  = 40000000 / cells;
+  rect        whole(0, 0, width, height);
+  rect        box(2, 2, width - 4, height - 4);
+  string_t    line(extent.width, 'x');
+  unsigned    w      = __CAST(unsigned, extent.width);
+  unsigned    h      = __CAST(unsigned, extent.height);
+  char        what[64];
+  double      ns     = 0;
+
+  scr.set_size(extent);
+
+  draw_buffer buffer;
+  picmap      picture(w, h);
+
+  std::sprintf(what, "%ux%u fill", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            buffer.fill(whole, fg_grey | bg_blue, true);
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  std::sprintf(what, "%ux%u fill attributes", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            buffer.fill(whole, fg_white | bg_blue, false);
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  std::sprintf(what, "%ux%u draw_rect", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            buffer.draw_rect(box,
+                                             fg_yellow | bg_blue,
+                                             fg_grey | bg_blue,
+                                             true);
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  std::sprintf(what, "%ux%u move_char rows", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            for (signed y = 0; y < height; ++y) {
+                              buffer.move_char(y * width,
+                                               '.',
+                                               fg_cyan | bg_black,
+                                               extent.width);
+                            }
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  std::sprintf(what, "%ux%u move_str rows", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            for (signed y = 0; y < height; ++y) {
+                              buffer.move_str(y * width,
+                                              line,
+                                              fg_green | bg_black);
+                            }
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  std::sprintf(what, "%ux%u blit picmap", w, h);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            buffer.blit(picture, whole, point(0, 0));
+                          });
+  bench::report("drawbuffer", what, cells / ns, "cells/ns");
+
+  // Alternate between two frames so that every present has the
+  // whole screen to send.
+  scr.init();
+
+  std::sprintf(what, "%ux%u present, all changed", w, h);
+  ns = bench::nanoseconds(loops / 10, [&]()
+                          {
+                            static bool flip = false;
+
+                            flip = !flip;
+                            buffer.fill(whole,
+                                        flip ? bg_blue : bg_red,
+                                        true);
+                            scr.render_buffer(buffer);
+                          });
+  bench::report("drawbuffer", what, ns / 1000, "us/frame");
+
+  std::sprintf(what, "%ux%u present, unchanged", w, h);
+  ns = bench::nanoseconds(loops / 10, [&]()
+                          {
+                            scr.render_buffer(buffer);
+                          });
+  bench::report("drawbuffer", what, ns / 1000, "us/frame");
+
+  bench::sink = bench::sink + buffer.cells().attribute(cells - 1);
+
+  scr.shutdown();
+}
+
+/**
+ * @brief Run the draw buffer benchmarks.
+ */
+void
+bench::drawbuffer()
+{
+  screen_size sizes[] = { screen_size(80, 25), screen_size(300, 100) };
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    check_layout(sizes[i]);
+    check_masked_blit(sizes[i]);
+    check_span_clip(sizes[i]);
+    check_present(sizes[i]);
+  }
+
+  check_painter();
+
+  run_size(sizes[0]);
+  run_size(sizes[1]);
+}
+
+// bench_drawbuffer.cpp ends here
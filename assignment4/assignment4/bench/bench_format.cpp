@@ -0,0 +1,187 @@
+//
+// bench_format.cpp --- Text formatting benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 11:55:32 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 11:55:32
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file bench_format.cpp
+ * @author Paul Ward
+ * @brief Text formatting benchmarks.
+ *
+ * These time the two status messages the game formats, the
+ * remaining-guesses line and the game-over line, with
+ * @c format_buffer and @c aformat against @c std::wstringstream,
+ * which is what the game used before.  The stream is timed both
+ * made afresh for each message, as the game did, and reused.
+ */
+
+#include <sstream>
+
+#include "bench.hpp"
+#include "char.hpp"
+#include "format.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief The word shown in the game-over message.
+ */
+static const string_t Word(L"HANGMAN");
+
+/**
+ * @brief Report a time per message as millions of messages per
+ *        second.
+ * @param what What was formatted.
+ * @param ns The nanoseconds per message.
+ */
+static
+void
+report_rate(const char *what, double ns)
+{
+  bench::report("format", what, 1e3 / ns, "M msgs/s");
+}
+
+/**
+ * @brief Write the remaining-guesses line.
+ * @tparam _Out The type written to.
+ * @param out What to write to.
+ * @param lives The number of guesses left.
+ */
+template <class _Out>
+static
+void
+put_guesses(_Out &out, int lives)
+{
+  out << lives << L" incorrect "
+      << (lives == 1 ? L"guess" : L"guesses")
+      << L" remaining.";
+}
+
+/**
+ * @brief Write the game-over line.
+ * @tparam _Out The type written to.
+ * @param out What to write to.
+ */
+template <class _Out>
+static
+void
+put_game_over(_Out &out)
+{
+  out << L"The word was: " << Word;
+}
+
+/**
+ * @brief Run the formatting benchmarks.
+ */
+void
+bench::format()
+{
+  std::wstringstream reused;
+  astring            cells;
+  int                lives = 0;
+  double             ns    = 0;
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            format_buffer<64> str;
+
+                            put_guesses(str, ++lives % 7);
+                            sink += str.length();
+                          });
+  report_rate("guesses, format_buffer", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            aformat str(cells);
+
+                            cells.clear();
+                            put_guesses(str, ++lives % 7);
+                            sink += cells.size();
+                          });
+  report_rate("guesses, aformat", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            std::wstringstream str;
+
+                            put_guesses(str, ++lives % 7);
+                            sink += str.str().length();
+                          });
+  report_rate("guesses, new wstringstream", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            reused.str(L"");
+                            put_guesses(reused, ++lives % 7);
+                            sink += reused.str().length();
+                          });
+  report_rate("guesses, reused wstringstream", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            format_buffer<128> str;
+
+                            put_game_over(str);
+                            sink += str.length();
+                          });
+  report_rate("game over, format_buffer", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            aformat str(cells);
+
+                            cells.clear();
+                            put_game_over(str);
+                            sink += cells.size();
+                          });
+  report_rate("game over, aformat", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            std::wstringstream str;
+
+                            put_game_over(str);
+                            sink += str.str().length();
+                          });
+  report_rate("game over, new wstringstream", ns);
+
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            reused.str(L"");
+                            put_game_over(reused);
+                            sink += reused.str().length();
+                          });
+  report_rate("game over, reused wstringstream", ns);
+}
+
+// bench_format.cpp ends here
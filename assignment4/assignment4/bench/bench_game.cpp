@@ -0,0 +1,265 @@
+//
+// bench_game.cpp --- Whole game allocation benchmark.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 21:43:29 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 21:43:29
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file bench_game.cpp
+ * @author Paul Ward
+ * @brief Whole game allocation benchmark.
+ *
+ * This plays several games of hangman through the scripted keyboard
+ * and counts the heap allocations made along the way: every call to
+ * @c operator @c new, and the ones attributed strings make for their
+ * cells.
+ *
+ * The word file holds a single word, so the script knows what to
+ * guess.  Games alternate between guessing the word and running out
+ * of guesses, and each lost game is followed by a pause so that the
+ * hanging graphic plays out from the idle callback.
+ *
+ * The calls are split up by when they are made.  The game sets
+ * itself up before the first key, and its buffers grow to fit during
+ * the first won and lost games.  After that, play is in a steady
+ * state and must not go to the heap at all; the bench fails if it
+ * does.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "bench.hpp"
+#include "game.hpp"
+#include "keyboard.hpp"
+#include "screen.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief The number of calls to @c operator @c new so far.
+ */
+static std::size_t Allocations = 0;
+
+/**
+ * @brief The number of those calls made before the first key.
+ */
+static std::size_t SetUp = 0;
+
+/**
+ * @brief The number of those calls made in the steady state.
+ */
+static std::size_t Steady = 0;
+
+/**
+ * @brief The keyboard, once the game is running.
+ */
+static const keyboard *Keys = 0;
+
+/**
+ * @brief The number of key events read before the steady state.
+ */
+static std::size_t SteadyFrom = 0;
+
+/**
+ * @brief Count and make a heap allocation.
+ * @param bytes The size of the allocation.
+ *
+ * This replaces the library's allocation function for the whole
+ * bench program, so every container and string is counted.
+ */
+void *
+operator new(std::size_t bytes)
+{
+  void *ptr = std::malloc(bytes ? bytes : 1);
+
+  if (ptr == 0) {
+    throw std::bad_alloc();
+  }
+
+  ++Allocations;
+
+  if (Keys != 0 && Keys->get_events() == 0) {
+    ++SetUp;
+  } else if (Keys != 0 && Keys->get_events() >= SteadyFrom) {
+    ++Steady;
+  }
+
+  return ptr;
+}
+
+/**
+ * @brief Count and make an array heap allocation.
+ * @param bytes The size of the allocation.
+ */
+void *
+operator new[](std::size_t bytes)
+{
+  return operator new(bytes);
+}
+
+/**
+ * @brief Free a heap allocation.
+ * @param ptr The allocation.
+ */
+void
+operator delete(void *ptr) throw()
+{
+  std::free(ptr);
+}
+
+/**
+ * @brief Free an array heap allocation.
+ * @param ptr The allocation.
+ */
+void
+operator delete[](void *ptr) throw()
+{
+  std::free(ptr);
+}
+
+/**
+ * @brief The word the games are played with.
+ */
+static const char *Word = "HANGMAN";
+
+/**
+ * @brief Guesses that find every letter of the word.
+ */
+static const char *Winning = "HANGM";
+
+/**
+ * @brief Guesses that miss, one per life.
+ */
+static const char *Losing = "BCDEFIJKLO";
+
+/**
+ * @brief The number of games to play.
+ */
+static const std::size_t Games = 10;
+
+/**
+ * @brief The number of games played before the steady state.
+ */
+static const std::size_t WarmUp = 2;
+
+/**
+ * @brief Run the whole game benchmark.
+ */
+void
+bench::game()
+{
+  static const char *path = "bench_words.txt";
+
+  keyboard   &kbd    = keyboard::get_instance();
+  std::FILE  *words  = std::fopen(path, "w");
+  std::size_t keys   = 0;
+  std::size_t events = 0;
+  std::size_t warm   = 0;
+  std::size_t news   = 0;
+  std::size_t cells  = 0;
+
+  if (words == 0) {
+    std::printf("game: could not write %s\n", path);
+    return;
+  }
+
+  std::fprintf(words, "%s\n", Word);
+  std::fclose(words);
+
+  screen::get_instance().set_size(screen_size(80, 25));
+
+  static ::game theGame(string_t(path, path + std::strlen(path)),
+                        std::strlen(Losing));
+
+  for (std::size_t i = 0; i < Games; ++i) {
+    std::string script = (i % 2 == 0) ? Winning : Losing;
+
+    kbd.feed(script);
+    keys   += script.length();
+    events += script.length();
+
+    if (i % 2 != 0) {
+      kbd.pause(1000);
+      ++events;
+    }
+
+    if (i + 1 < Games) {
+      kbd.feed("y");
+      ++keys;
+      ++events;
+    }
+
+    if (i + 1 == WarmUp) {
+      SteadyFrom = events;
+      warm       = keys;
+    }
+  }
+
+  Allocations = 0;
+  SetUp       = 0;
+  Steady      = 0;
+  astring::reset_allocations();
+  kbd.reset_stats();
+
+  Keys = &kbd;
+  theGame.run();
+  Keys = 0;
+
+  news  = Allocations;
+  cells = astring::get_allocations();
+
+  std::remove(path);
+
+  bench::report("game", "operator new, whole run", news, "calls");
+  bench::report("game", "operator new, before first key", SetUp, "calls");
+  bench::report("game",
+                "operator new, warm-up games",
+                news - SetUp - Steady,
+                "calls");
+  bench::report("game",
+                "operator new per key, steady state",
+                __CAST(double, Steady) / (keys - warm),
+                "calls");
+  bench::expect("game", "operator new, steady state", Steady);
+  bench::report("game", "astring cells, whole run", cells, "allocations");
+  bench::report("game",
+                "astring cells per key",
+                __CAST(double, cells) / keys,
+                "allocations");
+}
+
+// bench_game.cpp ends here
@@ -0,0 +1,161 @@
+//
+// bench_idle.cpp --- Idle main loop benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 16:26:02 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 16:26:02
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file bench_idle.cpp
+ * @author Paul Ward
+ * @brief Idle main loop benchmarks.
+ *
+ * These measure how much processor time the main loop uses while no
+ * keys are pressed, using pauses in the scripted keyboard.  For
+ * comparison, the first result is a loop that polls for input the
+ * way the main loop used to, rather than sleeping until it arrives.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "application.hpp"
+#include "keyboard.hpp"
+#include "screen.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief How long each pause lasts, in milliseconds.
+ */
+static const long PauseTime = 1000;
+
+/**
+ * @brief Time some work, reporting its processor use and wakeups.
+ * @param what What is being measured.
+ * @param fn The work.
+ */
+template <class _Fn>
+static
+void
+measure(const char *what, _Fn fn)
+{
+  keyboard                &kbd  = keyboard::get_instance();
+  bench::clock::time_point start;
+  char                     line[64];
+  double                   cpu  = 0;
+  double                   wall = 0;
+
+  kbd.reset_stats();
+
+  cpu   = bench::cpu_seconds();
+  start = bench::clock::now();
+
+  fn();
+
+  wall = bench::seconds_since(start);
+  cpu  = bench::cpu_seconds() - cpu;
+
+  std::sprintf(line, "%s, cpu", what);
+  bench::report("idle", line, cpu * 100 / wall, "%");
+
+  std::sprintf(line, "%s, waits", what);
+  bench::report("idle", line, __CAST(double, kbd.get_waits()), "calls");
+}
+
+/**
+ * @brief Run the idle benchmarks.
+ */
+void
+bench::idle()
+{
+  static application app;               // Outlives its resize callback.
+
+  keyboard   &kbd    = keyboard::get_instance();
+  std::size_t idles  = 0;
+  std::size_t events = 100000;
+  double      ns     = 0;
+
+  screen::get_instance().set_size(screen_size(80, 25));
+  app.add_idle_callback([&idles]() { ++idles; });
+
+  measure("busy poll, 1 s pause", [&]()
+          {
+            kbd.pause(PauseTime);
+
+            while (!kbd.kbhit()) {
+              // Spin.
+            }
+
+            kbd.get_keyboard_event();
+          });
+
+  measure("main loop, 1 s pause", [&]()
+          {
+            kbd.pause(PauseTime);
+            app.set_idle_timeout(-1);
+            app.start();
+          });
+
+  measure("main loop, 1 s pause, 100 ms idle", [&]()
+          {
+            kbd.pause(PauseTime);
+            app.set_idle_timeout(100);
+            app.start();
+          });
+  bench::report("idle", "idle callbacks per 1 s pause", idles, "calls");
+
+  // A flood of events that are not key presses, such as key releases,
+  // should each cost one trip round the loop and no redraw.
+  app.set_idle_timeout(-1);
+  app.reset_key_stats();
+  kbd.reset_stats();
+  kbd.feed(std::string(events, '\0'));
+
+  clock::time_point start = clock::now();
+
+  app.start();
+  ns = seconds_since(start) * 1e9 / events;
+
+  bench::report("idle", "non-key event", ns, "ns/event");
+  bench::report("idle",
+                "waits per non-key event",
+                __CAST(double, kbd.get_waits()) / events,
+                "calls");
+  bench::report("idle",
+                "frames drawn for non-key events",
+                __CAST(double, app.get_key_frames()),
+                "frames");
+}
+
+// bench_idle.cpp ends here
@@ -0,0 +1,182 @@
+//
+// bench_kernels.cpp --- Cell fill kernel benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 12:03:12 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 12:03:12
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file bench_kernels.cpp
+ * @author Paul Ward
+ * @brief Cell fill kernel benchmarks.
+ *
+ * These time each kernel set that the processor supports, on rows
+ * as wide as an 80 column and a 300 column console.  The fills are
+ * the ones a row of the @c OVISION_DRAWBUFFER_SOA and
+ * @c OVISION_DRAWBUFFER_PACKED cell layouts is made of.
+ *
+ * Each kernel set is first checked against a plain loop, at every
+ * alignment and for every length up to a few vectors, so that the
+ * head and tail handling is covered as well as the main loop.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "kernels.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Check one kernel set against a plain loop.
+ * @param isa The instruction set.
+ *
+ * Each fill is made inside a larger array, which must be left alone
+ * outside the run.
+ */
+static
+void
+check_isa(kernels::isa_t isa)
+{
+  const std::size_t          longest = 80;
+  std::vector<std::uint16_t> narrow(longest + 16);
+  std::vector<std::uint32_t> wide(longest + 16);
+  std::vector<std::uint32_t> expect(longest + 16);
+  std::size_t                bad     = 0;
+  char                       what[64];
+
+  kernels::select_isa(isa);
+
+  for (std::size_t start = 0; start < 8; ++start) {
+    for (std::size_t count = 0; count <= longest; ++count) {
+      std::fill(narrow.begin(), narrow.end(), 0x5A5A);
+      kernels::fill16(narrow.data() + start, count, 0x1234);
+
+      for (std::size_t i = 0; i < narrow.size(); ++i) {
+        bool in = i >= start && i < start + count;
+
+        bad += narrow[i] != (in ? 0x1234 : 0x5A5A) ? 1 : 0;
+      }
+
+      for (std::size_t i = 0; i < wide.size(); ++i) {
+        wide[i] = expect[i] = __CAST(std::uint32_t, i * 0x01010101);
+      }
+      kernels::fill32(wide.data() + start, count, 0xCAFEF00D);
+      std::fill_n(expect.begin() + start, count, 0xCAFEF00D);
+      bad += wide != expect ? 1 : 0;
+
+      for (std::size_t i = 0; i < wide.size(); ++i) {
+        wide[i] = expect[i] = __CAST(std::uint32_t, i * 0x01010101);
+      }
+      kernels::fill32_masked(wide.data() + start,
+                             count,
+                             0xCAFEF00D,
+                             0xFFFF0000);
+      for (std::size_t i = start; i < start + count; ++i) {
+        expect[i] = (expect[i] & 0x0000FFFF) | 0xCAFE0000;
+      }
+      bad += wide != expect ? 1 : 0;
+    }
+  }
+
+  std::sprintf(what, "%s matches plain loop", kernels::isa_name(isa));
+  bench::expect("kernels", what, bad);
+}
+
+/**
+ * @brief Time one kernel set on rows of one width.
+ * @param isa The instruction set.
+ * @param width The number of cells in a row.
+ */
+static
+void
+run_width(kernels::isa_t isa, std::size_t width)
+{
+  std::vector<std::uint16_t> narrow(width);
+  std::vector<std::uint32_t> wide(width);
+  std::size_t                loops = 400000000 / width;
+  const char                *name  = kernels::isa_name(isa);
+  unsigned                   w     = __CAST(unsigned, width);
+  std::uint16_t              n     = 0;
+  std::uint32_t              v     = 0;
+  char                       what[64];
+  double                     ns    = 0;
+
+  kernels::select_isa(isa);
+
+  std::sprintf(what, "%s %u fill16", name, w);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            kernels::fill16(narrow.data(), width, ++n);
+                          });
+  bench::report("kernels", what, width / ns, "cells/ns");
+
+  std::sprintf(what, "%s %u fill32", name, w);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            kernels::fill32(wide.data(), width, ++v);
+                          });
+  bench::report("kernels", what, width / ns, "cells/ns");
+
+  std::sprintf(what, "%s %u fill32_masked", name, w);
+  ns = bench::nanoseconds(loops, [&]()
+                          {
+                            kernels::fill32_masked(wide.data(),
+                                                   width,
+                                                   ++v,
+                                                   0xFFFF0000);
+                          });
+  bench::report("kernels", what, width / ns, "cells/ns");
+
+  bench::sink = narrow[width - 1] + wide[width - 1];
+}
+
+/**
+ * @brief Run the kernel benchmarks.
+ */
+void
+bench::kernels()
+{
+  ovision::kernels::isa_t best = ovision::kernels::best_isa();
+
+  for (int isa = ovision::kernels::isa_scalar; isa <= best; ++isa) {
+    check_isa(__CAST(ovision::kernels::isa_t, isa));
+    run_width(__CAST(ovision::kernels::isa_t, isa), 80);
+    run_width(__CAST(ovision::kernels::isa_t, isa), 300);
+  }
+
+  ovision::kernels::select_isa(best);
+}
+
+// bench_kernels.cpp ends here
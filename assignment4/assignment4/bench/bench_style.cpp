@@ -0,0 +1,279 @@
+//
+// bench_style.cpp --- Extended style benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 10:08:01 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 10:08:01
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file bench_style.cpp
+ * @author Paul Ward
+ * @brief Extended style benchmarks.
+ *
+ * These compare cells that keep an interned 16-bit style ID with
+ * cells that keep the whole style inline: the memory each cell
+ * takes, and the time to compose a frame's escape sequences.  The
+ * interned frame is composed the way the VT presenter does it, with
+ * the SGR sequence for each ID built once and kept; the inline frame
+ * has to build a sequence every time the style changes.  The screen
+ * the benchmarks run against is headless, so the time to present
+ * the same frame to it is measured as well, with interned and with
+ * classic attributes.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "drawbuffer.hpp"
+#include "screen.hpp"
+#include "style.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief A cell that keeps its whole style.
+ */
+struct inline_cell
+{
+  char_t ch;                            //!< The character.
+  style  look;                          //!< The style.
+};
+
+/**
+ * @brief The bytes a cell in the draw buffer takes up.
+ */
+static const std::size_t CellBytes =
+#if defined(OVISION_DRAWBUFFER_SOA)
+  sizeof(char_t) + sizeof(std::uint16_t);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+  sizeof(packed_cell);
+#else
+  sizeof(achar);
+#endif
+
+/**
+ * @brief The number of distinct styles in a frame.
+ */
+static const std::size_t StyleCount = 16;
+
+/**
+ * @brief Append a character to an output buffer.
+ * @param out The output buffer.
+ * @param ch The character, which the benchmarks keep to ASCII.
+ */
+static inline
+void
+append_char(std::string &out, char_t ch)
+{
+  out += __CAST(char, ch);
+}
+
+/**
+ * @brief Compose a frame of interned cells, as the VT presenter does.
+ * @param out The output buffer.
+ * @param cells The cells.
+ * @param count The number of cells.
+ * @param cache The SGR sequence for each style ID.
+ */
+static
+void
+compose_interned(std::string              &out,
+                 const cell_buffer        &cells,
+                 std::size_t               count,
+                 std::vector<std::string> &cache)
+{
+  unsigned long current = ~0UL;
+
+  out.clear();
+
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint16_t word  = cells.attribute(i);
+    std::size_t   index = word & (style_table::interned_bit - 1);
+
+    if (word != current) {
+      if (index >= cache.size()) {
+        cache.resize(index + 1);
+      }
+
+      if (cache[index].empty()) {
+        style_table::get_instance().resolve(word).append_sgr(cache[index]);
+      }
+
+      out     += cache[index];
+      current  = word;
+    }
+
+    append_char(out, cells.character(i));
+  }
+}
+
+/**
+ * @brief Compose a frame of cells that keep their whole style.
+ * @param out The output buffer.
+ * @param cells The cells.
+ */
+static
+void
+compose_inline(std::string &out, const std::vector<inline_cell> &cells)
+{
+  const style *current = 0;
+
+  out.clear();
+
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    if (current == 0 || !(cells[i].look == *current)) {
+      cells[i].look.append_sgr(out);
+      current = &cells[i].look;
+    }
+
+    append_char(out, cells[i].ch);
+  }
+}
+
+/**
+ * @brief Compare the two kinds of cell for one frame.
+ * @param run How many cells in a row share a style.
+ */
+static
+void
+run_styles(std::size_t run)
+{
+  screen                  &scr    = screen::get_instance();
+  screen_size              extent(80, 25);
+  std::size_t              count  = extent.width * extent.height;
+  std::vector<style>       looks;
+  std::vector<attr_t>      ids;
+  std::vector<inline_cell> wide(count);
+  std::vector<std::string> cache;
+  std::string              out;
+  unsigned                 per    = __CAST(unsigned, run);
+  char                     what[64];
+  double                   ns     = 0;
+
+  scr.set_size(extent);
+
+  for (std::size_t i = 0; i < StyleCount; ++i) {
+    unsigned shade = __CAST(unsigned, i * 16);
+
+    looks.push_back(style(colour::rgb(255 - shade, shade, 128),
+                          colour::indexed(232 + __CAST(unsigned, i)),
+                          (i & 1) ? style::style_bold : 0));
+    ids.push_back(style_attribute(looks[i]));
+  }
+
+  // The second buffer of each kind has every style moved along by
+  // one, so that presenting the two in turn changes every cell.
+  draw_buffer buffer[2];
+  draw_buffer classic[2];
+
+  for (std::size_t i = 0; i < count; ++i) {
+    std::size_t which = (i / run) % StyleCount;
+    std::size_t next  = (which + 1) % StyleCount;
+    char_t      ch    = __CAST(char_t, 'a' + i % 26);
+
+    buffer[0].move_char(i, ch, ids[which], 1);
+    buffer[1].move_char(i, ch, ids[next], 1);
+    classic[0].move_char(i, ch, attr_t(__CAST(unsigned long, which)), 1);
+    classic[1].move_char(i, ch, attr_t(__CAST(unsigned long, next)), 1);
+
+    wide[i].ch   = ch;
+    wide[i].look = looks[which];
+  }
+
+  std::sprintf(what, "80x25 run of %u, compose interned", per);
+  ns = bench::nanoseconds(20000, [&]()
+                          {
+                            compose_interned(out,
+                                             buffer[0].cells(),
+                                             count,
+                                             cache);
+                          });
+  bench::report("style", what, ns / 1000, "us/frame");
+
+  std::sprintf(what, "80x25 run of %u, compose inline", per);
+  ns = bench::nanoseconds(20000, [&]()
+                          {
+                            compose_inline(out, wide);
+                          });
+  bench::report("style", what, ns / 1000, "us/frame");
+
+  std::sprintf(what, "80x25 run of %u, escape output", per);
+  bench::report("style", what, __CAST(double, out.size()), "bytes");
+
+  scr.init();
+
+  std::sprintf(what, "80x25 run of %u, present interned", per);
+  ns = bench::nanoseconds(20000, [&]()
+                          {
+                            static std::size_t flip = 0;
+
+                            flip ^= 1;
+                            scr.render_buffer(buffer[flip]);
+                          });
+  bench::report("style", what, ns / 1000, "us/frame");
+
+  std::sprintf(what, "80x25 run of %u, present classic", per);
+  ns = bench::nanoseconds(20000, [&]()
+                          {
+                            static std::size_t flip = 0;
+
+                            flip ^= 1;
+                            scr.render_buffer(classic[flip]);
+                          });
+  bench::report("style", what, ns / 1000, "us/frame");
+
+  bench::sink = bench::sink + out.size();
+
+  scr.shutdown();
+}
+
+/**
+ * @brief Run the extended style benchmarks.
+ */
+void
+bench::style()
+{
+  bench::report("style",
+                "cell, interned ID",
+                __CAST(double, CellBytes),
+                "bytes");
+  bench::report("style",
+                "cell, inline style",
+                __CAST(double, sizeof(inline_cell)),
+                "bytes");
+
+  run_styles(1);
+  run_styles(8);
+}
+
+// bench_style.cpp ends here
@@ -0,0 +1,197 @@
+//
+// bench_text.cpp --- Text storage benchmarks.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 09:41:04 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 09:41:04
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file bench_text.cpp
+ * @author Paul Ward
+ * @brief Text storage benchmarks.
+ *
+ * These compare the run-length @c run_string that text views keep
+ * their contents in with an @c astring, which has an attribute for
+ * every character: the memory each takes for the same text, the time
+ * to write each to the draw buffer, and the time @c text::render
+ * takes to draw a label and a wrapped paragraph.
+ */
+
+#include <cstdio>
+
+#include "bench.hpp"
+#include "char.hpp"
+#include "drawbuffer.hpp"
+#include "screen.hpp"
+#include "text.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Return the bytes an attributed string takes up.
+ * @param str The string.
+ */
+static
+std::size_t
+bytes_used(const astring &str)
+{
+  std::size_t heap = 0;
+
+  if (str.capacity() > astring::inline_capacity) {
+    heap = str.capacity() * sizeof(achar);
+  }
+
+  return sizeof(astring) + heap;
+}
+
+/**
+ * @brief Return the bytes a run-length string takes up.
+ * @param str The string.
+ *
+ * Characters that fit in the string's own small buffer take no heap.
+ */
+static
+std::size_t
+bytes_used(const run_string &str)
+{
+  const string_t &chars = str.characters();
+  std::size_t     heap  = 0;
+
+  if (chars.capacity() > string_t().capacity()) {
+    heap = (chars.capacity() + 1) * sizeof(char_t);
+  }
+
+  heap += str.runs().capacity() * sizeof(run_string::attr_run);
+
+  return sizeof(run_string) + heap;
+}
+
+/**
+ * @brief Compare the two strings for one piece of text.
+ * @param length The number of characters.
+ * @param every How many characters share each attribute.
+ */
+static
+void
+run_text(std::size_t length, std::size_t every)
+{
+  static const attr_t attrs[2] = {
+    fg_yellow | fg_intense | bg_blue,
+    fg_grey | bg_black
+  };
+
+  draw_buffer buffer;
+  astring     cells;
+  run_string  runs;
+  char        what[64];
+  unsigned    len = __CAST(unsigned, length);
+  unsigned    per = __CAST(unsigned, every);
+  double      ns  = 0;
+
+  for (std::size_t i = 0; i < length; ++i) {
+    attr_t attr = attrs[(i / every) % 2];
+    char_t ch   = __CAST(char_t, 'a' + i % 26);
+
+    cells.push_back(achar(ch, attr));
+    runs.push_back(ch, attr);
+  }
+
+  std::sprintf(what, "%u chars, run of %u, astring", len, per);
+  bench::report("text", what, __CAST(double, bytes_used(cells)), "bytes");
+
+  std::sprintf(what, "%u chars, run of %u, run_string", len, per);
+  bench::report("text", what, __CAST(double, bytes_used(runs)), "bytes");
+
+  std::sprintf(what, "%u chars, run of %u, move astring", len, per);
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            buffer.move_str(0, cells);
+                          });
+  bench::report("text", what, ns, "ns/string");
+
+  std::sprintf(what, "%u chars, run of %u, move run_string", len, per);
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            buffer.move_str(0, runs);
+                          });
+  bench::report("text", what, ns, "ns/string");
+}
+
+/**
+ * @brief Run the text benchmarks.
+ */
+void
+bench::text()
+{
+  screen_point label(1, 16);
+  screen_point para(2, 2);
+  string_t     words;
+  double       ns = 0;
+
+  screen::get_instance().set_size(screen_size(80, 25));
+
+  run_text(40, 40);
+  run_text(78, 78);
+  run_text(78, 6);
+  run_text(400, 400);
+
+  // A short string should only cost the cells it holds.
+  ns = bench::nanoseconds(1000000, [&]()
+                          {
+                            astring cells;
+
+                            cells.assign(8, achar('x', default_attributes));
+                            bench::sink = bench::sink + cells.size();
+                          });
+  bench::report("text", "8 chars, make astring", ns, "ns/string");
+
+  while (words.length() < 600) {
+    words += L"the quick brown fox jumps over the lazy dog ";
+  }
+
+  ovision::text message(L"Welcome to HANGMAN.  Press CONTROL+C to quit.",
+                        label,
+                        78,
+                        AlignCenter,
+                        fg_yellow | fg_intense | bg_blue);
+  ovision::text paragraph(words, para, 76, fg_grey | bg_black);
+
+  paragraph.set_word_wrap(true);
+
+  ns = bench::nanoseconds(1000000, [&]() { message.render(); });
+  bench::report("text", "text::render, label", ns, "ns/render");
+
+  ns = bench::nanoseconds(100000, [&]() { paragraph.render(); });
+  bench::report("text", "text::render, wrapped paragraph", ns, "ns/render");
+}
+
+// bench_text.cpp ends here
@@ -0,0 +1,150 @@
+//
+// animation.hpp --- Delta-frame picture animation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 14:39:45 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 14:39:45
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file animation.hpp
+ * @author Paul Ward
+ * @brief Delta-frame picture animation.
+ */
+
+#pragma once
+#ifndef _animation_hpp_
+#define _animation_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "compiler.hpp"
+#include "types.hpp"
+#include "char.hpp"
+#include "rect.hpp"
+#include "picmap.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief A cell that changes between two frames.
+   *
+   * Both the old and the new contents are kept, so the change can be
+   * undone as well as made.
+   */
+  struct cell_delta
+  {
+    std::uint32_t offset;               //!< Cell offset in the picture.
+    char_t        before;               //!< Character before the change.
+    char_t        after;                //!< Character after the change.
+    std::uint16_t before_attr;          //!< Attribute before the change.
+    std::uint16_t after_attr;           //!< Attribute after the change.
+  };
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A picture animation stored as a keyframe and deltas.
+   *
+   * Frame 0 is the keyframe.  Every later frame is stored only as the
+   * cells that differ from the frame before it, so moving a picture
+   * from one frame to the next touches only those cells, and the
+   * area they cover is all that needs redrawing.
+   */
+  class animation
+  {
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @brief Where a frame's deltas are, and what they cover.
+     */
+    struct frame_info {
+      std::size_t first;                //!< Index of the first delta.
+      std::size_t count;                //!< Number of deltas.
+      rect        bounds;               //!< Area of the changed cells.
+    };
+
+    /**
+     * @typedef delta_vector
+     * @brief A vector of cell deltas.
+     *
+     * @typedef frame_vector
+     * @brief A vector of frames.
+     */
+    typedef std::vector<cell_delta> delta_vector;
+    typedef std::vector<frame_info> frame_vector;
+
+
+    // Private member fields.
+  private:
+
+    picmap       mKeyframe;             //!< The first frame.
+    picmap       mLast;                 //!< The last frame.
+    delta_vector mDeltas;               //!< Deltas of every frame.
+    frame_vector mFrames;               //!< Frames after the keyframe.
+
+
+    // Public member functions.
+  public:
+
+    // Constructor functions.
+    animation();
+    animation(const picmap &keyframe);
+
+    // Building functions.
+    void set_keyframe(const picmap &keyframe);
+    void add_frame(const picmap &next);
+    void clear();
+
+    // Reader functions.
+    std::size_t   size() const;
+    std::size_t   get_delta_count() const;
+    std::size_t   get_delta_count(std::size_t index) const;
+    const picmap &get_keyframe() const;
+
+    // Playback functions.
+    rect forward(picmap &target, std::size_t index) const;
+    rect backward(picmap &target, std::size_t index) const;
+
+  };                                    // class animation
+
+}                                       // namespace ovision
+
+#endif // !_animation_hpp_
+
+// animation.hpp ends here
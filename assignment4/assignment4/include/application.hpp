@@ -47,7 +47,10 @@
 #include <vector>
 #include <functional>
 
+#include "arena.hpp"
 #include "frame.hpp"
+#include "region.hpp"
+#include "screen.hpp"
 
 /**
  * @brief Main Object Vision namespace.
@@ -75,6 +78,18 @@ namespace ovision
      */
     typedef std::function<void(char_t)> kbcallback_t;
     typedef std::vector<kbcallback_t> kbcallback_vector;
+
+    /**
+     * @typedef idlecallback_t
+     * @brief A callback function with the signature
+     *        @c void @c function_name @c () called whenever the
+     *        idle timeout expires without a key being pressed.
+     *
+     * @typedef idlecallback_vector
+     * @brief A vector of idle callback functions.
+     */
+    typedef std::function<void()> idlecallback_t;
+    typedef std::vector<idlecallback_t> idlecallback_vector;
     
     
     // Private member fields.
@@ -84,20 +99,39 @@ namespace ovision
     key_t               mLastKey;       //!< Last key pressed.
     key_t               mKey;           //!< Current key pressed.
     kbcallback_vector   mKeyCallbacks;  //!< Callbacks to call after keypress.
+    idlecallback_vector mIdleCallbacks; //!< Callbacks to call when idle.
+    long                mIdleTimeout;   //!< Idle timeout in milliseconds.
+    std::size_t         mKeyFrames;     //!< Frames drawn after key presses.
+    std::size_t         mFrameKeys;     //!< Keys handled in the last frame.
+    std::size_t         mMaxFrameKeys;  //!< Most keys handled in one frame.
+    std::size_t         mTotalKeys;     //!< Keys handled in all frames.
+    std::size_t         mFrameViews;    //!< Views drawn in the last frame.
+    std::size_t         mFrameArea;     //!< Cells damaged in the last frame.
+    std::size_t         mFrameWrites;   //!< Cells written in the last frame.
+    std::size_t         mFrameOverdraw; //!< Cells written over last frame.
     bool                mRunning;       //!< Is the application running?
+    bool                mResized;       //!< Has the screen been resized?
     int                 mReturnCode;    //!< Application's return code.
+    frame_arena         mArena;         //!< Arena for per-frame temporaries.
+    region              mDamage;        //!< Damage left to hand out.
+    std::vector<region> mParts;         //!< Each view's part of the damage.
+    screen::resize_token_t mResizeToken; //!< Our screen resize callback.
     
 
     // Public member functions.
   public:
 
+    // Constructor and destructor functions.
+    application();
+    ~application();
+
     // Screen size functions.
     screen_size get_screen_size();
     void        set_screen_size(const screen_size &extent);
 
     // Cursor functions.
     screen_point get_cursor_position();
-    void         set_cursor_position(screen_point &position);
+    void         set_cursor_position(const screen_point &position);
     void         enable_cursor();
     void         disable_cursor();
 
@@ -109,10 +143,37 @@ namespace ovision
 
     // Callback functions.
     void add_key_callback(kbcallback_t fn);
+    void add_idle_callback(idlecallback_t fn);
+
+    // Idle timeout functions.
+    long get_idle_timeout() const;
+    void set_idle_timeout(long timeout);
+
+    // Typeahead statistics functions.
+    std::size_t get_key_frames() const;
+    std::size_t get_frame_keys() const;
+    std::size_t get_max_frame_keys() const;
+    std::size_t get_total_keys() const;
+    void        reset_key_stats();
+
+    // Rendering statistics functions.
+    std::size_t get_frame_views() const;
+    std::size_t get_frame_area() const;
+    std::size_t get_frame_writes() const;
+    std::size_t get_frame_overdraw() const;
+
+    // Memory functions.
+    frame_arena &get_frame_arena();
 
     // Execution functions.
     int  start(void);
     void stop();
+
+    
+    // Private member functions.
+  private:
+
+    bool render_views();
     
   };                                    // class application
 
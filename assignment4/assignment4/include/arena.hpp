@@ -0,0 +1,337 @@
+//
+// arena.hpp --- Per-frame memory arena.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 15:33:06 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 15:33:06
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file arena.hpp
+ * @author Paul Ward
+ * @brief Per-frame memory arena.
+ */
+
+#pragma once
+#ifndef _arena_hpp_
+#define _arena_hpp_
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "char.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief A bump allocator for things that only live for a frame.
+   *
+   * Memory is handed out from large blocks by moving a pointer
+   * along, and is all given back at once when the application
+   * resets the arena after each frame is presented.  The blocks are
+   * kept, so once the arena has grown to fit the busiest frame it
+   * stops calling into the heap altogether.
+   *
+   * Nothing allocated from the arena may outlive the frame.
+   *
+   * Each application owns an arena and makes it the current one, so
+   * that code with no application to hand, such as the screen, the
+   * POSIX helpers and default-constructed arena allocators, can
+   * still reach it.  When no application is running there is a
+   * spare arena to fall back on.
+   */
+  class frame_arena
+  {
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @brief A block of memory.
+     */
+    struct block {
+      unsigned char *data;              //!< The memory.
+      std::size_t    size;              //!< Its size in bytes.
+    };
+
+    /**
+     * @typedef block_vector
+     * @brief A vector of blocks.
+     */
+    typedef std::vector<block> block_vector;
+
+
+    // Private member fields.
+  private:
+
+    block_vector mBlocks;               //!< Blocks owned by the arena.
+    std::size_t  mBlock;                //!< Block being allocated from.
+    std::size_t  mUsed;                 //!< Bytes used in that block.
+    std::size_t  mFrameBytes;           //!< Bytes handed out this frame.
+    std::size_t  mHighWater;            //!< Most bytes in any frame.
+    std::size_t  mHeapCalls;            //!< Blocks taken from the heap.
+
+
+    // Public static functions.
+  public:
+
+    static frame_arena &get_current();
+    static void         set_current(frame_arena *arena);
+
+
+    // Public member functions.
+  public:
+
+    // Constructor and destructor functions.
+    frame_arena();
+    ~frame_arena();
+
+    // Allocation functions.
+    void *allocate(std::size_t bytes, std::size_t align);
+    void  deallocate(void *ptr, std::size_t bytes);
+    void  reset();
+
+    // Statistics functions.
+    std::size_t get_frame_bytes() const;
+    std::size_t get_high_water() const;
+    std::size_t get_capacity() const;
+    std::size_t get_heap_calls() const;
+
+
+    // Private member functions.
+  private:
+
+    // Not copyable.
+    frame_arena(const frame_arena &);
+    frame_arena &operator=(const frame_arena &);
+
+    void next_block(std::size_t bytes);
+
+  };                                    // class frame_arena
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A standard allocator that takes its memory from a frame
+   *        arena.
+   * @tparam _Ty The type of object allocated.
+   *
+   * Freeing memory does nothing, bar giving back the most recent
+   * allocation so that a growing vector or string can reuse it.
+   */
+  template <class _Ty>
+  class arena_allocator
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @typedef value_type
+     * @brief The type of object allocated.
+     *
+     * The rest are the types every standard allocator provides.
+     */
+    typedef _Ty                   value_type;
+    typedef _Ty                  *pointer;
+    typedef const _Ty            *const_pointer;
+    typedef _Ty                  &reference;
+    typedef const _Ty            &const_reference;
+    typedef std::size_t           size_type;
+    typedef std::ptrdiff_t        difference_type;
+
+    /**
+     * @brief An allocator for another type from the same arena.
+     * @tparam _Other The other type.
+     */
+    template <class _Other>
+    struct rebind {
+      typedef arena_allocator<_Other> other;
+    };
+
+
+    // Public member fields.
+  public:
+
+    frame_arena *mArena;                //!< Arena to allocate from.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Default constructor function.
+     *
+     * Allocates from the current frame arena.
+     */
+    arena_allocator()
+      : mArena(&frame_arena::get_current())
+    {}
+
+    /**
+     * @brief Constructor function.
+     * @param arena The arena to allocate from.
+     */
+    explicit arena_allocator(frame_arena &arena)
+      : mArena(&arena)
+    {}
+
+    /**
+     * @brief Converting constructor function.
+     * @tparam _Other The type the other allocator allocates.
+     * @param other The other allocator.
+     */
+    template <class _Other>
+    arena_allocator(const arena_allocator<_Other> &other)
+      : mArena(other.mArena)
+    {}
+
+    /**
+     * @brief Return the address of an object.
+     */
+    pointer
+    address(reference value) const
+    {
+      return &value;
+    }
+
+    /**
+     * @brief Return the address of a constant object.
+     */
+    const_pointer
+    address(const_reference value) const
+    {
+      return &value;
+    }
+
+    /**
+     * @brief Allocate room for a number of objects.
+     * @param count The number of objects.
+     */
+    pointer
+    allocate(size_type count, const void * = 0)
+    {
+      return __CAST(pointer,
+                    mArena->allocate(count * sizeof(_Ty),
+                                     std::alignment_of<_Ty>::value));
+    }
+
+    /**
+     * @brief Free room for a number of objects.
+     * @param ptr The objects.
+     * @param count The number of objects.
+     */
+    void
+    deallocate(pointer ptr, size_type count)
+    {
+      mArena->deallocate(ptr, count * sizeof(_Ty));
+    }
+
+    /**
+     * @brief Construct an object in place.
+     */
+    void
+    construct(pointer ptr, const _Ty &value)
+    {
+      ::new (__CAST(void *, ptr)) _Ty(value);
+    }
+
+    /**
+     * @brief Destroy an object in place.
+     */
+    void
+    destroy(pointer ptr)
+    {
+      ptr->~_Ty();
+    }
+
+    /**
+     * @brief Return the most objects that could be allocated.
+     */
+    size_type
+    max_size() const
+    {
+      return std::numeric_limits<size_type>::max() / sizeof(_Ty);
+    }
+
+  };                                    // class arena_allocator
+
+  /**
+   * @brief Do two arena allocators share an arena?
+   */
+  template <class _Ty, class _Other>
+  inline
+  bool
+  operator == (const arena_allocator<_Ty>    &lhs,
+               const arena_allocator<_Other> &rhs)
+  {
+    return lhs.mArena == rhs.mArena;
+  }
+
+  /**
+   * @brief Do two arena allocators use different arenas?
+   */
+  template <class _Ty, class _Other>
+  inline
+  bool
+  operator != (const arena_allocator<_Ty>    &lhs,
+               const arena_allocator<_Other> &rhs)
+  {
+    return lhs.mArena != rhs.mArena;
+  }
+
+
+  // =================================================================
+
+
+  /**
+   * @typedef frame_string
+   * @brief A string that only lives for a frame.
+   *
+   * @typedef frame_astring
+   * @brief An attributed string that only lives for a frame.
+   */
+  typedef std::basic_string<char_t,
+                            std::char_traits<char_t>,
+                            arena_allocator<char_t>> frame_string;
+  typedef basic_astring<arena_allocator<achar>>       frame_astring;
+
+}                                       // namespace ovision
+
+#endif // !_arena_hpp_
+
+// arena.hpp ends here
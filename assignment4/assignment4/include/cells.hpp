@@ -0,0 +1,643 @@
+//
+// cells.hpp --- Character cell storage.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 13:27:23 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 13:27:23
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file cells.hpp
+ * @author Paul Ward
+ * @brief Character cell storage.
+ */
+
+#pragma once
+#ifndef _cells_hpp_
+#define _cells_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "compiler.hpp"
+#include "types.hpp"
+#include "char.hpp"
+#include "point.hpp"
+#include "size.hpp"
+#include "rect.hpp"
+#include "kernels.hpp"
+
+/**
+ * @def OVISION_DRAWBUFFER_SOA
+ * @brief Store cells as separate character and attribute planes?
+ *
+ * This is never defined here.  Define it to have cell buffers keep
+ * their characters and attributes in two contiguous arrays rather
+ * than as an array of attributed characters.
+ *
+ * @def OVISION_DRAWBUFFER_PACKED
+ * @brief Store cells as packed 32-bit words?
+ *
+ * This is never defined here either.  Define it to have cell buffers
+ * keep each cell as a @c packed_cell.  On Win32 that has the same
+ * layout as a @c CHAR_INFO, so the draw buffer can be handed to the
+ * console as it is.  If both are defined, the planes win.
+ */
+
+namespace ovision
+{
+
+  /**
+   * @brief A character cell packed into 32 bits.
+   *
+   * The character is in the low 16 bits and the attribute in the
+   * high 16 bits, which is exactly the layout of a @c CHAR_INFO on a
+   * little-endian machine.  The attribute needs all 16 bits, as it
+   * may be an interned style ID (see style.hpp), so where @c wchar_t
+   * is wider than 16 bits, characters outside the Basic
+   * Multilingual Plane are stored as U+FFFD.
+   */
+  struct packed_cell
+  {
+
+    // Public constants.
+  public:
+
+    /**
+     * @brief The number of bits given to the character.
+     */
+    static const unsigned char_bits = 16;
+
+    /**
+     * @brief The bits that hold the character.
+     */
+    static const std::uint32_t char_mask = (1u << char_bits) - 1;
+
+    /**
+     * @brief The bits that hold the attribute.
+     */
+    static const std::uint32_t attr_mask = ~char_mask;
+
+
+    // Public member fields.
+  public:
+
+    std::uint32_t bits;                 //!< Character and attribute.
+
+
+    // Public static member functions.
+  public:
+
+    /**
+     * @brief Pack a character and an attribute into a word.
+     * @param c The character.
+     * @param attr The attribute as a word.
+     */
+    static
+    std::uint32_t
+    pack(char_t c, std::uint16_t attr)
+    {
+      std::uint32_t ch = __CAST(std::uint32_t, __CAST(uchar_t, c));
+
+      if (ch > char_mask) {
+        ch = 0xFFFD;
+      }
+
+      return ch | (__CAST(std::uint32_t, attr) << char_bits);
+    }
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Return the character.
+     */
+    char_t
+    character() const
+    {
+      return __CAST(char_t, __CAST(uchar_t, bits & char_mask));
+    }
+
+    /**
+     * @brief Return the attribute as a word.
+     */
+    std::uint16_t
+    attribute() const
+    {
+      return __CAST(std::uint16_t, bits >> char_bits);
+    }
+
+  };                                    // struct packed_cell
+
+  static_assert(sizeof(packed_cell) == sizeof(std::uint32_t),
+                "A packed cell must be 32 bits.");
+
+#if defined(OVISION_WIN32)
+  static_assert(sizeof(packed_cell) == sizeof(CHAR_INFO),
+                "A packed cell must have the layout of a CHAR_INFO.");
+#endif
+
+
+  // =================================================================
+
+
+  /**
+   * @brief Character cell buffer class.
+   *
+   * This is the storage behind the draw buffer and the shadow frame.
+   * Cells are addressed by their offset from the top-left corner.
+   *
+   * By default each cell is an attributed character, and runs are
+   * filled a cell at a time without the kernels.  The cells are a
+   * plain vector rather than an @c astring: a buffer holds a whole
+   * screen or picture, so an @c astring's inline cells would never
+   * be used.  With
+   * @c OVISION_DRAWBUFFER_SOA defined, the characters and the
+   * attributes live in separate planes, and attributes are kept as
+   * plain 16-bit words.  An attribute-only operation then only
+   * touches the attribute plane, and runs are filled with the vector
+   * kernels from kernels.hpp.
+   *
+   * With @c OVISION_DRAWBUFFER_PACKED defined, each cell is a
+   * @c packed_cell.  Runs are filled a word at a time, and filling
+   * just the characters or just the attributes of a run uses the
+   * masked fill kernel.
+   */
+  class cell_buffer
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @typedef run_callback
+     * @brief A function with the signature
+     *        @c void @c function_name @c (std::size_t, @c std::size_t)
+     *        called with the offset and length of each run of cells
+     *        a block transfer writes.
+     */
+    typedef std::function<void(std::size_t, std::size_t)> run_callback;
+
+
+    // Protected member fields.
+  protected:
+
+#if defined(OVISION_DRAWBUFFER_SOA)
+    std::vector<char_t>        mChars;  //!< Character plane.
+    std::vector<std::uint16_t> mAttrs;  //!< Attribute plane.
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+    std::vector<packed_cell>   mPacked; //!< Packed cells.
+#else
+    std::vector<achar>         mCells;  //!< Attributed characters.
+#endif
+
+
+    // Public static member functions.
+  public:
+
+    /**
+     * @brief Convert an attribute to a 16-bit word.
+     * @param attr The attribute.
+     */
+    static
+    std::uint16_t
+    to_word(const attr_t &attr)
+    {
+      return __CAST(std::uint16_t, attr.to_ulong());
+    }
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Return the number of cells.
+     */
+    std::size_t
+    size() const
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      return mChars.size();
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      return mPacked.size();
+#else
+      return mCells.size();
+#endif
+    }
+
+    /**
+     * @brief Set every cell to the given value.
+     * @param count The new number of cells.
+     * @param value The value for each cell.
+     */
+    void
+    assign(std::size_t count, const achar &value)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      mChars.assign(count, value.character);
+      mAttrs.assign(count, to_word(value.attribute));
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      packed_cell cell;
+
+      cell.bits = packed_cell::pack(value.character,
+                                    to_word(value.attribute));
+
+      mPacked.assign(count, cell);
+#else
+      mCells.assign(count, value);
+#endif
+    }
+
+    /**
+     * @brief Return the cell at the given offset.
+     * @param idx The offset.
+     */
+    achar
+    get(std::size_t idx) const
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      return achar(mChars[idx], attr_t(mAttrs[idx]));
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      return achar(mPacked[idx].character(),
+                   attr_t(mPacked[idx].attribute()));
+#else
+      return mCells[idx];
+#endif
+    }
+
+    /**
+     * @brief Return the character at the given offset.
+     * @param idx The offset.
+     */
+    char_t
+    character(std::size_t idx) const
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      return mChars[idx];
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      return mPacked[idx].character();
+#else
+      return mCells[idx].character;
+#endif
+    }
+
+    /**
+     * @brief Return the attribute at the given offset as a word.
+     * @param idx The offset.
+     */
+    std::uint16_t
+    attribute(std::size_t idx) const
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      return mAttrs[idx];
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      return mPacked[idx].attribute();
+#else
+      return to_word(mCells[idx].attribute);
+#endif
+    }
+
+    /**
+     * @brief Does a cell match the same cell in another buffer?
+     * @param idx The offset.
+     * @param other The other buffer.
+     */
+    bool
+    same(std::size_t idx, const cell_buffer &other) const
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      return mChars[idx] == other.mChars[idx] &&
+             mAttrs[idx] == other.mAttrs[idx];
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      return mPacked[idx].bits == other.mPacked[idx].bits;
+#else
+      return mCells[idx].character == other.mCells[idx].character &&
+             mCells[idx].attribute == other.mCells[idx].attribute;
+#endif
+    }
+
+    /**
+     * @brief Copy a run of cells from another buffer.
+     * @param idx The offset of the first cell to copy to.
+     * @param other The other buffer.
+     * @param from The offset of the first cell to copy from.
+     * @param count The number of cells to copy.
+     */
+    void
+    copy(std::size_t        idx,
+         const cell_buffer &other,
+         std::size_t        from,
+         std::size_t        count)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      std::copy_n(other.mChars.begin() + from, count, mChars.begin() + idx);
+      std::copy_n(other.mAttrs.begin() + from, count, mAttrs.begin() + idx);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      std::copy_n(other.mPacked.begin() + from,
+                  count,
+                  mPacked.begin() + idx);
+#else
+      std::copy_n(other.mCells.begin() + from, count, mCells.begin() + idx);
+#endif
+    }
+
+    /**
+     * @brief Copy a run of cells from a pair of 16-bit planes.
+     * @param idx The offset of the first cell to copy to.
+     * @param chars The characters to copy.
+     * @param attrs The attributes to copy, as words.
+     * @param count The number of cells to copy.
+     */
+    void
+    copy_planes(std::size_t          idx,
+                const std::uint16_t *chars,
+                const std::uint16_t *attrs,
+                std::size_t          count)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      for (std::size_t i = 0; i < count; ++i) {
+        mChars[idx + i] = __CAST(char_t, chars[i]);
+      }
+
+      std::copy_n(attrs, count, mAttrs.begin() + idx);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t attr = attrs[i];
+
+        mPacked[idx + i].bits = chars[i] | (attr << packed_cell::char_bits);
+      }
+#else
+      for (std::size_t i = 0; i < count; ++i) {
+        mCells[idx + i].character = __CAST(char_t, chars[i]);
+        mCells[idx + i].attribute = attr_t(attrs[i]);
+      }
+#endif
+    }
+
+    // Block transfer functions.
+    rect blit(const screen_size   &extent,
+              const cell_buffer   &source,
+              const screen_size   &source_extent,
+              const rect          &from,
+              const point         &to,
+              const rect          &clip,
+              const std::uint64_t *mask    = 0,
+              const run_callback  &written = run_callback());
+
+    rect blit(const screen_size   &extent,
+              const std::uint16_t *chars,
+              const std::uint16_t *attrs,
+              const screen_size   &source_extent,
+              const rect          &from,
+              const point         &to,
+              const rect          &clip,
+              const std::uint64_t *mask    = 0,
+              const run_callback  &written = run_callback());
+
+    /**
+     * @brief Set a cell.
+     * @param idx The offset.
+     * @param c The character.
+     * @param attr The attribute.
+     */
+    void
+    put(std::size_t idx, char_t c, const attr_t &attr)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      mChars[idx] = c;
+      mAttrs[idx] = to_word(attr);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      mPacked[idx].bits = packed_cell::pack(c, to_word(attr));
+#else
+      mCells[idx].character = c;
+      mCells[idx].attribute = attr;
+#endif
+    }
+
+    /**
+     * @brief Set the character of a cell.
+     * @param idx The offset.
+     * @param c The character.
+     */
+    void
+    put_character(std::size_t idx, char_t c)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      mChars[idx] = c;
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      mPacked[idx].bits = (mPacked[idx].bits & packed_cell::attr_mask) |
+                          packed_cell::pack(c, 0);
+#else
+      mCells[idx].character = c;
+#endif
+    }
+
+    /**
+     * @brief Set the attribute of a cell.
+     * @param idx The offset.
+     * @param attr The attribute.
+     */
+    void
+    put_attribute(std::size_t idx, const attr_t &attr)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      mAttrs[idx] = to_word(attr);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      mPacked[idx].bits = (mPacked[idx].bits & packed_cell::char_mask) |
+                          packed_cell::pack(0, to_word(attr));
+#else
+      mCells[idx].attribute = attr;
+#endif
+    }
+
+    /**
+     * @brief Set a run of cells.
+     * @param idx The offset of the first cell.
+     * @param count The number of cells.
+     * @param c The character.
+     * @param attr The attribute.
+     */
+    void
+    fill(std::size_t idx, std::size_t count, char_t c, const attr_t &attr)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      kernels::fill(mChars.data() + idx, count, c);
+      kernels::fill(mAttrs.data() + idx, count, to_word(attr));
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      kernels::fill32(words(idx), count, packed_cell::pack(c, to_word(attr)));
+#else
+      std::fill_n(mCells.begin() + idx, count, achar(c, attr));
+#endif
+    }
+
+    /**
+     * @brief Set the characters of a run of cells.
+     * @param idx The offset of the first cell.
+     * @param count The number of cells.
+     * @param c The character.
+     */
+    void
+    fill_characters(std::size_t idx, std::size_t count, char_t c)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      kernels::fill(mChars.data() + idx, count, c);
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      kernels::fill32_masked(words(idx),
+                             count,
+                             packed_cell::pack(c, 0),
+                             packed_cell::char_mask);
+#else
+      for (std::size_t i = idx; i < idx + count; ++i) {
+        mCells[i].character = c;
+      }
+#endif
+    }
+
+    /**
+     * @brief Set the attributes of a run of cells.
+     * @param idx The offset of the first cell.
+     * @param count The number of cells.
+     * @param attr The attribute.
+     */
+    void
+    fill_attributes(std::size_t idx, std::size_t count, const attr_t &attr)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      kernels::fill(mAttrs.data() + idx, count, to_word(attr));
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      kernels::fill32_masked(words(idx),
+                             count,
+                             packed_cell::pack(0, to_word(attr)),
+                             packed_cell::attr_mask);
+#else
+      for (std::size_t i = idx; i < idx + count; ++i) {
+        mCells[i].attribute = attr;
+      }
+#endif
+    }
+
+    /**
+     * @brief Set a run of cells to characters sharing an attribute.
+     * @param idx The offset of the first cell.
+     * @param chars The characters.
+     * @param count The number of cells.
+     * @param attr The attribute.
+     */
+    void
+    put_run(std::size_t   idx,
+            const char_t *chars,
+            std::size_t   count,
+            const attr_t &attr)
+    {
+#if defined(OVISION_DRAWBUFFER_SOA)
+      std::copy_n(chars, count, mChars.begin() + idx);
+      kernels::fill(mAttrs.data() + idx, count, to_word(attr));
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+      std::uint16_t word = to_word(attr);
+
+      for (std::size_t i = 0; i < count; ++i) {
+        mPacked[idx + i].bits = packed_cell::pack(chars[i], word);
+      }
+#else
+      for (std::size_t i = 0; i < count; ++i) {
+        mCells[idx + i].character = chars[i];
+        mCells[idx + i].attribute = attr;
+      }
+#endif
+    }
+
+#if defined(OVISION_DRAWBUFFER_SOA)
+    /**
+     * @brief Return the character plane.
+     */
+    const char_t *
+    characters() const
+    {
+      return mChars.data();
+    }
+
+    /**
+     * @brief Return the attribute plane.
+     */
+    const std::uint16_t *
+    attributes() const
+    {
+      return mAttrs.data();
+    }
+#elif defined(OVISION_DRAWBUFFER_PACKED)
+    /**
+     * @brief Return the packed cells.
+     */
+    const packed_cell *
+    packed() const
+    {
+      return mPacked.data();
+    }
+
+# if defined(OVISION_WIN32)
+    /**
+     * @brief Return the packed cells as console cells.
+     *
+     * This is what lets the console read the buffer directly.
+     */
+    const CHAR_INFO *
+    char_info() const
+    {
+      return reinterpret_cast<const CHAR_INFO *>(mPacked.data());
+    }
+# endif
+
+
+    // Private member functions.
+  private:
+
+    /**
+     * @brief Return the packed cells from an offset as words.
+     * @param idx The offset.
+     */
+    std::uint32_t *
+    words(std::size_t idx)
+    {
+      return &mPacked[idx].bits;
+    }
+#endif
+
+  };                                    // class cell_buffer
+
+}                                       // namespace ovision
+
+#endif // !_cells_hpp_
+
+// cells.hpp ends here
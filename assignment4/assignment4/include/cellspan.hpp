@@ -0,0 +1,433 @@
+//
+// cellspan.hpp --- Two-dimensional views of cell buffers.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 12:19:18 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 12:19:18
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file cellspan.hpp
+ * @author Paul Ward
+ * @brief Two-dimensional views of cell buffers.
+ */
+
+#pragma once
+#ifndef _cellspan_hpp_
+#define _cellspan_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "compiler.hpp"
+#include "types.hpp"
+#include "char.hpp"
+#include "point.hpp"
+#include "size.hpp"
+#include "rect.hpp"
+#include "cells.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief A view of a rectangle of a cell buffer.
+   * @tparam _Buffer @c cell_buffer for a view that can be written
+   *                 through, or @c const @c cell_buffer for one that
+   *                 can only be read.
+   *
+   * A view does not own its cells.  It is a buffer, the size of the
+   * picture the buffer holds, and a rectangle of that picture, which
+   * makes its width and height those of the rectangle and its stride
+   * the width of the picture.  The rectangle is clipped to the
+   * picture when the view is made, so every cell of a view is in the
+   * buffer.
+   *
+   * Views are cheap to copy and pass around.  Their operations work
+   * a row at a time with the runs that @c cell_buffer fills and
+   * copies, so a rectangular edit is neither copied out nor done a
+   * cell at a time.  A view is only good until its buffer is resized.
+   *
+   * A view can be given a function to tell about each run of cells
+   * written through it, which is how a draw buffer keeps its write
+   * counters right for the cells a view actually changes.
+   */
+  template <class _Buffer>
+  class basic_cell_span2d
+  {
+
+    template <class _Other> friend class basic_cell_span2d;
+
+    // Protected member fields.
+  protected:
+
+    _Buffer     *mCells;                //!< The cells viewed.
+    screen_size  mExtent;               //!< Size of the whole picture.
+    rect         mArea;                 //!< Rectangle viewed.
+    cell_buffer::run_callback mWritten; //!< Told about cells written.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Default constructor function.
+     *
+     * This makes an empty view of no buffer.
+     */
+    basic_cell_span2d()
+      : mCells(0),
+        mArea(0, 0, 0, 0),
+        mWritten()
+    {}
+
+    /**
+     * @brief Constructor function.
+     * @param cells The buffer to view.
+     * @param extent The size of the picture held in @c cells.
+     * @param area The rectangle of the picture to view.
+     * @param written If set, called with the offset and length of
+     *                each run of cells written through the view.
+     */
+    basic_cell_span2d(_Buffer                         &cells,
+                      const screen_size               &extent,
+                      const rect                      &area,
+                      const cell_buffer::run_callback &written =
+                        cell_buffer::run_callback())
+      : mCells(&cells),
+        mExtent(extent),
+        mArea(clip(area,
+                   rect(0,
+                        0,
+                        __CAST(signed, extent.width),
+                        __CAST(signed, extent.height)))),
+        mWritten(written)
+    {}
+
+    /**
+     * @brief Conversion constructor function.
+     * @param other The view to copy.
+     *
+     * This lets a writable view be used where a read-only one is
+     * wanted, but not the other way around.
+     */
+    template <class _Other>
+    basic_cell_span2d(const basic_cell_span2d<_Other> &other)
+      : mCells(other.mCells),
+        mExtent(other.mExtent),
+        mArea(other.mArea),
+        mWritten(other.mWritten)
+    {}
+
+    /**
+     * @brief Return the width of the view.
+     */
+    std::size_t
+    width() const
+    {
+      return __CAST(std::size_t, mArea.extent.width);
+    }
+
+    /**
+     * @brief Return the height of the view.
+     */
+    std::size_t
+    height() const
+    {
+      return __CAST(std::size_t, mArea.extent.height);
+    }
+
+    /**
+     * @brief Return the number of cells from one row to the next.
+     */
+    std::size_t
+    stride() const
+    {
+      return mExtent.width;
+    }
+
+    /**
+     * @brief Does the view have no cells?
+     */
+    bool
+    empty() const
+    {
+      return width() == 0 || height() == 0;
+    }
+
+    /**
+     * @brief Return the rectangle viewed, in picture coordinates.
+     */
+    const rect &
+    get_area() const
+    {
+      return mArea;
+    }
+
+    /**
+     * @brief Return the buffer offset of the start of a row.
+     * @param y The row, counted from the top of the view.
+     */
+    std::size_t
+    offset(std::size_t y) const
+    {
+      return (__CAST(std::size_t, mArea.top()) + y) * mExtent.width +
+             __CAST(std::size_t, mArea.left());
+    }
+
+    /**
+     * @brief Return a view of part of this view.
+     * @param area The rectangle to view, relative to this view.
+     *
+     * The result is clipped to this view.
+     */
+    basic_cell_span2d
+    sub(const rect &area) const
+    {
+      basic_cell_span2d result(*this);
+
+      result.mArea = clip(rect(area.left() + mArea.left(),
+                               area.top()  + mArea.top(),
+                               area.extent.width,
+                               area.extent.height),
+                          mArea);
+
+      return result;
+    }
+
+    /**
+     * @brief Return a cell.
+     * @param x The column, counted from the left of the view.
+     * @param y The row, counted from the top of the view.
+     */
+    achar
+    get(std::size_t x, std::size_t y) const
+    {
+      return mCells->get(offset(y) + x);
+    }
+
+    /**
+     * @brief Set a cell.
+     * @param x The column, counted from the left of the view.
+     * @param y The row, counted from the top of the view.
+     * @param c The character.
+     * @param attr The attribute.
+     */
+    void
+    put(std::size_t x, std::size_t y, char_t c, const attr_t &attr)
+    {
+      mCells->put(offset(y) + x, c, attr);
+      wrote(offset(y) + x, 1);
+    }
+
+    /**
+     * @brief Set every cell in the view.
+     * @param c The character.
+     * @param attr The attribute.
+     */
+    void
+    fill(char_t c, const attr_t &attr)
+    {
+      for (std::size_t y = 0; y < height(); ++y) {
+        mCells->fill(offset(y), width(), c, attr);
+        wrote(offset(y), width());
+      }
+    }
+
+    /**
+     * @brief Set the character of every cell in the view.
+     * @param c The character.
+     */
+    void
+    fill_characters(char_t c)
+    {
+      for (std::size_t y = 0; y < height(); ++y) {
+        mCells->fill_characters(offset(y), width(), c);
+        wrote(offset(y), width());
+      }
+    }
+
+    /**
+     * @brief Set the attribute of every cell in the view.
+     * @param attr The attribute.
+     */
+    void
+    fill_attributes(const attr_t &attr)
+    {
+      for (std::size_t y = 0; y < height(); ++y) {
+        mCells->fill_attributes(offset(y), width(), attr);
+        wrote(offset(y), width());
+      }
+    }
+
+    /**
+     * @brief Copy another view into this one.
+     * @param source The view to copy.
+     *
+     * The two views are lined up at their top-left corners, and as
+     * much of @c source as fits is copied.  The views must not
+     * overlap.
+     */
+    template <class _Other>
+    void
+    copy(const basic_cell_span2d<_Other> &source)
+    {
+      std::size_t count = std::min(width(), source.width());
+      std::size_t rows  = std::min(height(), source.height());
+
+      if (count == 0) {
+        return;
+      }
+
+      for (std::size_t y = 0; y < rows; ++y) {
+        mCells->copy(offset(y), *source.mCells, source.offset(y), count);
+        wrote(offset(y), count);
+      }
+    }
+
+    /**
+     * @brief Draw another view onto this one.
+     * @param source The view to draw.
+     * @param to Where the top-left corner of @c source lands,
+     *           relative to this view.
+     * @param mask The transparency mask of the picture that
+     *             @c source views, or a null pointer if every cell is
+     *             opaque.
+     * @returns The rectangle that was written to, in picture
+     *          coordinates, which is empty if nothing was drawn.
+     *
+     * Anything falling outside this view is dropped.
+     */
+    template <class _Other>
+    rect
+    blit(const basic_cell_span2d<_Other> &source,
+         const point                     &to,
+         const std::uint64_t             *mask = 0)
+    {
+      if (empty() || source.empty()) {
+        return rect(0, 0, 0, 0);
+      }
+
+      return mCells->blit(mExtent,
+                          *source.mCells,
+                          source.mExtent,
+                          source.mArea,
+                          point(mArea.left() + to.x, mArea.top() + to.y),
+                          mArea,
+                          mask,
+                          mWritten);
+    }
+
+    /**
+     * @brief Call a function for each row of the view.
+     * @param fn Called with the buffer offset of the start of each
+     *           row and the width of the view.
+     */
+    template <class _Fn>
+    void
+    each_row(_Fn fn) const
+    {
+      for (std::size_t y = 0; y < height(); ++y) {
+        fn(offset(y), width());
+      }
+    }
+
+
+    // Private member functions.
+  private:
+
+    /**
+     * @brief Tell the write function about a run of cells written.
+     * @param indent The buffer offset of the first cell.
+     * @param count The number of cells.
+     */
+    void
+    wrote(std::size_t indent, std::size_t count)
+    {
+      if (mWritten) {
+        mWritten(indent, count);
+      }
+    }
+
+
+    // Private static member functions.
+  private:
+
+    /**
+     * @brief Clip a rectangle to another.
+     * @param area The rectangle to clip.
+     * @param bounds The rectangle to clip it to.
+     * @returns What is left of @c area, which has no width or height
+     *          if nothing is.
+     */
+    static
+    rect
+    clip(const rect &area, const rect &bounds)
+    {
+      signed left   = std::max(__CAST(signed, area.left()),
+                               __CAST(signed, bounds.left()));
+      signed top    = std::max(__CAST(signed, area.top()),
+                               __CAST(signed, bounds.top()));
+      signed right  = std::min(__CAST(signed, area.right()),
+                               __CAST(signed, bounds.right()));
+      signed bottom = std::min(__CAST(signed, area.bottom()),
+                               __CAST(signed, bounds.bottom()));
+
+      if (right <= left || bottom <= top) {
+        return rect(0, 0, 0, 0);
+      }
+
+      return rect(left, top, right - left, bottom - top);
+    }
+
+  };                                    // class basic_cell_span2d
+
+
+  // =================================================================
+
+
+  /**
+   * @typedef cell_span2d
+   * @brief A view of cells that can be written through.
+   */
+  typedef basic_cell_span2d<cell_buffer> cell_span2d;
+
+  /**
+   * @typedef const_cell_span2d
+   * @brief A view of cells that can only be read.
+   */
+  typedef basic_cell_span2d<const cell_buffer> const_cell_span2d;
+
+}                                       // namespace ovision
+
+#endif // !_cellspan_hpp_
+
+// cellspan.hpp ends here
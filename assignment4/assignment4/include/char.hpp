@@ -46,16 +46,35 @@
 #ifndef _char_hpp_
 #define _char_hpp_
 
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include <string>
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-
 #include "compiler.hpp"
 #include "types.hpp"
 
+#if defined(OVISION_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+// The attribute bits mirror those of the Win32 console, and the
+// terminal back end translates them into SGR sequences.
+# define FOREGROUND_BLUE      0x0001
+# define FOREGROUND_GREEN     0x0002
+# define FOREGROUND_RED       0x0004
+# define FOREGROUND_INTENSITY 0x0008
+# define BACKGROUND_BLUE      0x0010
+# define BACKGROUND_GREEN     0x0020
+# define BACKGROUND_RED       0x0040
+# define BACKGROUND_INTENSITY 0x0080
+#endif
+
 namespace ovision
 {
 
@@ -225,6 +244,14 @@ namespace ovision
     typedef typename std::remove_reference<_Ta>::type _TaX;
     
 
+    // Inherited data members.
+  public:
+
+    // The base is a dependent type; bring its members into scope.
+    using _MyBase::character;
+    using _MyBase::attribute;
+
+
     // Public member functions.
   public:
 
@@ -235,6 +262,14 @@ namespace ovision
       : _MyBase()
     {}
 
+    /**
+     * @brief Copy constructor function.
+     * @param _Right The object to copy from.
+     */
+    basic_attributed_character(const basic_attributed_character &_Right)
+      : _MyBase(_Right)
+    {}
+
     /**
      * @brief Constructor function.
      * @param _char The initial character.
@@ -251,7 +286,8 @@ namespace ovision
      * @param _Right The other object.
      */
     template <class _OC, class _OA>
-    basic_attributed_character(basic_attributed_character<_OC, _OA> &_Right)
+    basic_attributed_character(
+      const basic_attributed_character<_OC, _OA> &_Right)
       : _MyBase(_Right.character, _Right.attribute)
     {}
 
@@ -531,34 +567,441 @@ namespace ovision
 
   /**
    * @brief A naive attributed string.
+   *
+   * Most strings in the game are short labels, so the first
+   * @c inline_capacity cells are kept inside the object itself and
+   * the heap is only used once a string outgrows them.  Apart from
+   * that, it behaves like the @c std::vector it used to be.
+   *
+   * Only the cells in use are ever constructed.  The inline cells
+   * are raw storage until they are written, so making an empty
+   * string does not touch them, and growing onto the heap does not
+   * fill the spare cells.  Cells have trivial destructors, so
+   * shrinking just forgets them.
+   *
+   * @tparam _Alloc The allocator used once a string outgrows its
+   *                inline cells.
    */
-  class astring
-    : public std::vector<achar>
+  template <class _Alloc>
+  class basic_astring
   {
 
+    // Public type definitions.
+  public:
+
+    /**
+     * @typedef value_type
+     * @brief The type of the elements.
+     *
+     * @typedef size_type
+     * @brief The type used for sizes and indices.
+     *
+     * @typedef iterator
+     * @brief A mutable iterator.
+     *
+     * @typedef const_iterator
+     * @brief A constant iterator.
+     *
+     * @typedef allocator_type
+     * @brief The type of allocator.
+     */
+    typedef achar        value_type;
+    typedef std::size_t  size_type;
+    typedef achar       *iterator;
+    typedef const achar *const_iterator;
+    typedef _Alloc        allocator_type;
+
+    /**
+     * @brief The number of cells held without touching the heap.
+     */
+    static const size_type inline_capacity = 64;
+
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @typedef inline_storage
+     * @brief Raw storage for the inline cells.
+     */
+    typedef typename std::aligned_storage<
+      sizeof(achar) * inline_capacity,
+      std::alignment_of<achar>::value>::type inline_storage;
+
+
+    // Private member fields.
+  private:
+
+    _Alloc         mAlloc;              //!< Heap allocator.
+    achar         *mData;               //!< The cells in use.
+    size_type      mSize;               //!< Number of cells.
+    size_type      mCapacity;           //!< Number of cells available.
+    inline_storage mInline;             //!< Inline storage.
+
+
     // Public member functions.
   public:
 
+    /**
+     * @brief Default constructor function.
+     */
+    basic_astring()
+      : mAlloc(),
+        mData(inline_cells()),
+        mSize(0),
+        mCapacity(inline_capacity)
+    {}
+
+    /**
+     * @brief Constructor function.
+     * @param alloc The allocator to use.
+     */
+    explicit basic_astring(const _Alloc &alloc)
+      : mAlloc(alloc),
+        mData(inline_cells()),
+        mSize(0),
+        mCapacity(inline_capacity)
+    {}
+
+    /**
+     * @brief Copy constructor function.
+     * @param other The string to copy.
+     */
+    basic_astring(const basic_astring &other)
+      : mAlloc(other.mAlloc),
+        mData(inline_cells()),
+        mSize(0),
+        mCapacity(inline_capacity)
+    {
+      assign(other.begin(), other.end());
+    }
+
+    /**
+     * @brief Move constructor function.
+     * @param other The string to move from.
+     *
+     * Heap storage is taken over; inline cells have to be copied.
+     */
+    basic_astring(basic_astring &&other)
+      : mAlloc(other.mAlloc),
+        mData(inline_cells()),
+        mSize(0),
+        mCapacity(inline_capacity)
+    {
+      take_storage(other);
+    }
+
+    /**
+     * @brief Destructor function.
+     */
+    ~basic_astring()
+    {
+      release();
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * @param rhs The right-hand side.
+     * @returns The original object with modified values.
+     */
+    basic_astring &
+    operator = (const basic_astring &rhs)
+    {
+      if (this != &rhs) {
+        assign(rhs.begin(), rhs.end());
+      }
+
+      return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param rhs The right-hand side.
+     * @returns The original object with modified values.
+     */
+    basic_astring &
+    operator = (basic_astring &&rhs)
+    {
+      if (this != &rhs) {
+        clear();
+        take_storage(rhs);
+      }
+
+      return *this;
+    }
 
     /**
      * @brief Assignment operator.
      * @param rhs The right-hand side.
      * @returns The original object with modified values.
      */
-    astring &
+    basic_astring &
     operator = (const string_t &rhs)
     {
-      std::size_t len = rhs.length();
-      std::size_t i   = 0;
+      from_string(rhs, default_attributes);
 
-      reserve(len);
-      resize(len);
+      return *this;
+    }
 
-      for (i = 0; i < len; ++i) {
-        at(i) = achar(rhs[i], default_attributes);
+    /**
+     * @brief Return the number of cells.
+     */
+    size_type
+    size() const
+    {
+      return mSize;
+    }
+
+    /**
+     * @brief Return the number of cells that fit without growing.
+     */
+    size_type
+    capacity() const
+    {
+      return mCapacity;
+    }
+
+    /**
+     * @brief Is the string empty?
+     */
+    bool
+    empty() const
+    {
+      return mSize == 0;
+    }
+
+    /**
+     * @brief Are the cells held inside the object?
+     */
+    bool
+    is_inline() const
+    {
+      return mData == inline_cells();
+    }
+
+    /**
+     * @brief Return a pointer to the cells.
+     */
+    achar *
+    data()
+    {
+      return mData;
+    }
+
+    /**
+     * @brief Return a constant pointer to the cells.
+     */
+    const achar *
+    data() const
+    {
+      return mData;
+    }
+
+    /**
+     * @brief Return an iterator to the first cell.
+     */
+    iterator
+    begin()
+    {
+      return mData;
+    }
+
+    /**
+     * @brief Return a constant iterator to the first cell.
+     */
+    const_iterator
+    begin() const
+    {
+      return mData;
+    }
+
+    /**
+     * @brief Return an iterator past the last cell.
+     */
+    iterator
+    end()
+    {
+      return mData + mSize;
+    }
+
+    /**
+     * @brief Return a constant iterator past the last cell.
+     */
+    const_iterator
+    end() const
+    {
+      return mData + mSize;
+    }
+
+    /**
+     * @brief Return the cell at an index.
+     * @param idx The index.
+     */
+    achar &
+    operator [] (size_type idx)
+    {
+      return mData[idx];
+    }
+
+    /**
+     * @brief Return the cell at an index.
+     * @param idx The index.
+     */
+    const achar &
+    operator [] (size_type idx) const
+    {
+      return mData[idx];
+    }
+
+    /**
+     * @brief Return the cell at an index, checking the bounds.
+     * @param idx The index.
+     * @throws std::out_of_range if the index is past the end.
+     */
+    achar &
+    at(size_type idx)
+    {
+      if (idx >= mSize) {
+        throw std::out_of_range("basic_astring::at");
       }
 
-      return *this;
+      return mData[idx];
+    }
+
+    /**
+     * @brief Return the cell at an index, checking the bounds.
+     * @param idx The index.
+     * @throws std::out_of_range if the index is past the end.
+     */
+    const achar &
+    at(size_type idx) const
+    {
+      if (idx >= mSize) {
+        throw std::out_of_range("basic_astring::at");
+      }
+
+      return mData[idx];
+    }
+
+    /**
+     * @brief Return the last cell.
+     */
+    achar &
+    back()
+    {
+      return mData[mSize - 1];
+    }
+
+    /**
+     * @brief Return the last cell.
+     */
+    const achar &
+    back() const
+    {
+      return mData[mSize - 1];
+    }
+
+    /**
+     * @brief Empty the string.
+     *
+     * Any heap storage is kept for reuse.
+     */
+    void
+    clear()
+    {
+      mSize = 0;
+    }
+
+    /**
+     * @brief Make room for a number of cells.
+     * @param count The number of cells.
+     */
+    void
+    reserve(size_type count)
+    {
+      if (count <= mCapacity) {
+        return;
+      }
+
+      achar *cells = mAlloc.allocate(count);
+
+      std::uninitialized_copy(mData, mData + mSize, cells);
+      release();
+
+      mData     = cells;
+      mCapacity = count;
+
+      allocations()++;
+    }
+
+    /**
+     * @brief Change the number of cells.
+     * @param count The new number of cells.
+     * @param value The value of any new cells.
+     */
+    void
+    resize(size_type count, const achar &value = achar())
+    {
+      grow(count);
+
+      if (count > mSize) {
+        std::uninitialized_fill(mData + mSize, mData + count, value);
+      }
+
+      mSize = count;
+    }
+
+    /**
+     * @brief Append a cell.
+     * @param value The cell.
+     */
+    void
+    push_back(const achar &value)
+    {
+      grow(mSize + 1);
+
+      ::new (__CAST(void *, mData + mSize)) achar(value);
+      ++mSize;
+    }
+
+    /**
+     * @brief Remove the last cell.
+     */
+    void
+    pop_back()
+    {
+      mSize--;
+    }
+
+    /**
+     * @brief Set the string to a number of copies of a cell.
+     * @param count The number of cells.
+     * @param value The cell.
+     */
+    void
+    assign(size_type count, const achar &value)
+    {
+      clear();
+      resize(count, value);
+    }
+
+    /**
+     * @brief Set the string to a range of cells.
+     * @tparam _It The type of iterator.
+     * @param first The first cell.
+     * @param last One past the last cell.
+     */
+    template <class _It>
+    void
+    assign(_It first, _It last)
+    {
+      size_type count = __CAST(size_type, std::distance(first, last));
+
+      clear();
+      grow(count);
+      std::uninitialized_copy(first, last, mData);
+
+      mSize = count;
     }
 
     /**
@@ -577,7 +1020,7 @@ namespace ovision
       ret.resize(len);
 
       for (i = 0; i < len; ++i) {
-        ret.assign(i, at(i).character);
+        ret[i] = mData[i].character;
       }
 
       return ret;
@@ -595,24 +1038,403 @@ namespace ovision
       std::size_t i   = 0;
 
       clear();
-      reserve(len);
-      resize(len);
+      grow(len);
 
       for (i = 0; i < len; ++i) {
-        at(i) = achar(str[i], attr);
+        ::new (__CAST(void *, mData + i)) achar(str[i], attr);
       }
+
+      mSize = len;
     }
 
     /**
      * @brief Return the attributed string length.
      */
-    std::vector<achar>::size_type
+    size_type
     length() const
     {
       return size();
     }
 
-  };                                    // class astring
+    /**
+     * @brief Return the number of times any string of this type has
+     *        gone to its allocator for cells.
+     */
+    static
+    std::size_t
+    get_allocations()
+    {
+      return allocations();
+    }
+
+    /**
+     * @brief Reset the heap allocation count.
+     */
+    static
+    void
+    reset_allocations()
+    {
+      allocations() = 0;
+    }
+
+
+    // Private member functions.
+  private:
+
+    /**
+     * @brief Return the inline cells.
+     */
+    achar *
+    inline_cells()
+    {
+      return reinterpret_cast<achar *>(&mInline);
+    }
+
+    /**
+     * @brief Return the inline cells.
+     */
+    const achar *
+    inline_cells() const
+    {
+      return reinterpret_cast<const achar *>(&mInline);
+    }
+
+    /**
+     * @brief The heap allocation count.
+     */
+    static
+    std::size_t &
+    allocations()
+    {
+      static std::size_t count = 0;
+
+      return count;
+    }
+
+    /**
+     * @brief Make sure there is room for a number of cells.
+     * @param count The number of cells.
+     *
+     * Storage at least doubles each time it grows, so appending a
+     * cell at a time is not quadratic.
+     */
+    void
+    grow(size_type count)
+    {
+      if (count > mCapacity) {
+        reserve(std::max(count, mCapacity * 2));
+      }
+    }
+
+    /**
+     * @brief Free any heap storage and go back to the inline cells.
+     */
+    void
+    release()
+    {
+      if (!is_inline()) {
+        mAlloc.deallocate(mData, mCapacity);
+      }
+
+      mData     = inline_cells();
+      mCapacity = inline_capacity;
+    }
+
+    /**
+     * @brief Take the contents of another string.
+     * @param other The string to take the contents of.
+     *
+     * Heap storage changes hands if both strings use the same
+     * allocator; otherwise the cells are copied.  The other string
+     * is left empty.
+     */
+    void
+    take_storage(basic_astring &other)
+    {
+      if (other.is_inline() || !(mAlloc == other.mAlloc)) {
+        assign(other.begin(), other.end());
+      } else {
+        release();
+
+        mData     = other.mData;
+        mCapacity = other.mCapacity;
+        mSize     = other.mSize;
+
+        other.mData     = other.inline_cells();
+        other.mCapacity = inline_capacity;
+      }
+
+      other.mSize = 0;
+    }
+
+  };                                    // class basic_astring
+
+  /**
+   * @typedef astring
+   * @brief An attributed string that allocates from the heap.
+   */
+  typedef basic_astring<std::allocator<achar>> astring;
+
+
+  // =================================================================
+
+
+  /**
+   * @brief An attributed string stored as runs.
+   *
+   * The characters are kept as a plain string, and the attributes
+   * as a list of runs, each starting at some character and lasting
+   * until the next.  Labels usually have one attribute throughout,
+   * so this costs a character per cell and a run per change of
+   * attribute, rather than an attribute per cell.
+   */
+  class run_string
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @brief A run of characters sharing an attribute.
+     */
+    struct attr_run {
+      std::size_t start;                //!< Offset of the first character.
+      attr_t      attribute;            //!< Attribute for the run.
+    };
+
+    /**
+     * @typedef run_vector
+     * @brief A vector of attribute runs.
+     */
+    typedef std::vector<attr_run> run_vector;
+
+
+    // Private member fields.
+  private:
+
+    string_t   mChars;                  //!< Characters.
+    run_vector mRuns;                   //!< Attribute runs, in order.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Default constructor function.
+     */
+    run_string()
+      : mChars(),
+        mRuns()
+    {}
+
+    /**
+     * @brief Constructor function.
+     * @param str The characters.
+     * @param attr The attribute for all of them.
+     */
+    run_string(const string_t &str, attr_t attr)
+    {
+      assign(str, attr);
+    }
+
+    /**
+     * @brief Set the string to characters with one attribute.
+     * @param str The characters.
+     * @param attr The attribute for all of them.
+     */
+    void
+    assign(const string_t &str, attr_t attr)
+    {
+      assign(str.c_str(), str.length(), attr);
+    }
+
+    /**
+     * @brief Set the string to characters with one attribute.
+     * @param str The characters.
+     * @param len The number of characters.
+     * @param attr The attribute for all of them.
+     *
+     * The storage already held is reused, so this does not allocate
+     * unless the string grows.
+     */
+    void
+    assign(const char_t *str, std::size_t len, attr_t attr)
+    {
+      mChars.assign(str, len);
+      mRuns.clear();
+
+      if (!mChars.empty()) {
+        attr_run run = { 0, attr };
+
+        mRuns.push_back(run);
+      }
+    }
+
+    /**
+     * @brief Set the string from an attributed string.
+     * @tparam _Alloc The allocator the attributed string uses.
+     * @param str The attributed string.
+     *
+     * Neighbouring characters with the same attribute are merged
+     * into one run.
+     */
+    template <class _Alloc>
+    void
+    assign(const basic_astring<_Alloc> &str)
+    {
+      clear();
+      mChars.reserve(str.size());
+
+      for (std::size_t i = 0; i < str.size(); ++i) {
+        push_back(str[i].character, str[i].attribute);
+      }
+    }
+
+    /**
+     * @brief Append a character.
+     * @param ch The character.
+     * @param attr Its attribute.
+     */
+    void
+    push_back(char_t ch, attr_t attr)
+    {
+      if (mRuns.empty() || mRuns.back().attribute != attr) {
+        attr_run run = { mChars.length(), attr };
+
+        mRuns.push_back(run);
+      }
+
+      mChars.push_back(ch);
+    }
+
+    /**
+     * @brief Empty the string.
+     */
+    void
+    clear()
+    {
+      mChars.clear();
+      mRuns.clear();
+    }
+
+    /**
+     * @brief Is the string empty?
+     */
+    bool
+    empty() const
+    {
+      return mChars.empty();
+    }
+
+    /**
+     * @brief Return the number of characters.
+     */
+    std::size_t
+    size() const
+    {
+      return mChars.length();
+    }
+
+    /**
+     * @brief Return the number of characters.
+     */
+    std::size_t
+    length() const
+    {
+      return mChars.length();
+    }
+
+    /**
+     * @brief Return the characters.
+     */
+    const string_t &
+    characters() const
+    {
+      return mChars;
+    }
+
+    /**
+     * @brief Return the attribute runs.
+     */
+    const run_vector &
+    runs() const
+    {
+      return mRuns;
+    }
+
+    /**
+     * @brief Return the offset one past the end of a run.
+     * @param idx The index of the run.
+     */
+    std::size_t
+    run_end(std::size_t idx) const
+    {
+      return idx + 1 < mRuns.size() ? mRuns[idx + 1].start : mChars.length();
+    }
+
+    /**
+     * @brief Return the attribute of a character.
+     * @param idx The offset of the character.
+     */
+    attr_t
+    attribute(std::size_t idx) const
+    {
+      std::size_t lo = 0;
+      std::size_t hi = mRuns.size();
+
+      // Find the last run starting at or before the character.
+      while (hi - lo > 1) {
+        std::size_t mid = (lo + hi) / 2;
+
+        if (mRuns[mid].start <= idx) {
+          lo = mid;
+        } else {
+          hi = mid;
+        }
+      }
+
+      return mRuns[lo].attribute;
+    }
+
+    /**
+     * @brief Return the attributed character at an offset.
+     * @param idx The offset of the character.
+     */
+    achar
+    at(std::size_t idx) const
+    {
+      return achar(mChars[idx], attribute(idx));
+    }
+
+    /**
+     * @brief Return the characters as a standard string.
+     */
+    string_t
+    to_string() const
+    {
+      return mChars;
+    }
+
+    /**
+     * @brief Return the string as an attributed string.
+     */
+    astring
+    to_astring() const
+    {
+      astring ret;
+
+      ret.reserve(mChars.length());
+
+      for (std::size_t r = 0; r < mRuns.size(); ++r) {
+        for (std::size_t i = mRuns[r].start; i < run_end(r); ++i) {
+          ret.push_back(achar(mChars[i], mRuns[r].attribute));
+        }
+      }
+
+      return ret;
+    }
+
+  };                                    // class run_string
 
 }                                       // namespace ovision
 
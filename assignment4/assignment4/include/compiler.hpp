@@ -50,6 +50,31 @@
 #define EXIT_FILE_IMAGINARY   5
 #define EXIT_NO_WORDS         6
 
+/**
+ * @def OVISION_HEADLESS
+ * @brief Are we rendering to memory rather than a real console?
+ *
+ * This is never defined here; define it when building benchmarks or
+ * tests and the in-memory screen and scripted keyboard back end are
+ * compiled in instead of a real one.
+ *
+ * @def OVISION_WIN32
+ * @brief Are we driving a Win32 console?
+ *
+ * @def OVISION_POSIX
+ * @brief Are we driving a VT-compatible terminal?
+ *
+ * At most one of these is defined, and it selects the screen and
+ * keyboard back end that is compiled in.
+ */
+#if defined(OVISION_HEADLESS)
+  // No console at all.
+#elif defined(_WIN32)
+# define OVISION_WIN32
+#else
+# define OVISION_POSIX
+#endif
+
 /**
  * @def OVISION_UNICODE
  * @brief Are we to use Unicode rather than ASCII?
@@ -57,11 +82,31 @@
  * If this is built on a compiler that does Unicode or MBCS, then this
  * flag is set so that we can use the wide character version of API
  * and the like.
+ *
+ * Other compilers always use @c wchar_t for characters, and terminals
+ * are fed UTF-8, so anything that is not Microsoft's is Unicode.
  */
-#if defined(_UNICODE) || defined(UNICODE) || defined(_MBCS)
+#if defined(_UNICODE) || defined(UNICODE) || defined(_MBCS) || \
+    !defined(_MSC_VER)
 # define OVISION_UNICODE
 #endif
 
+/**
+ * @def OVISION_CONSTEXPR
+ * @brief Mark something as computed at compile time, if we can.
+ *
+ * This expands to @c constexpr on compilers that allow loops and
+ * assignments in constant expressions (C++14), and to nothing on
+ * older ones such as Visual C++ 2010.  There, the same code simply
+ * runs once, when the program starts.
+ */
+#if (defined(__cpp_constexpr) && __cpp_constexpr >= 201304) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1910)
+# define OVISION_CONSTEXPR constexpr
+#else
+# define OVISION_CONSTEXPR
+#endif
+
 /**
  * @brief A convenience macro for casting.
  * @param __dt The data type to cast to.
@@ -44,9 +44,27 @@
 #ifndef _drawbuffer_hpp_
 #define _drawbuffer_hpp_
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "types.hpp"
 #include "rect.hpp"
 #include "char.hpp"
+#include "cells.hpp"
+#include "cellspan.hpp"
+#include "picmap.hpp"
+#include "picpack.hpp"
+
+/**
+ * @def OVISION_COUNT_OVERDRAW
+ * @brief Count cells drawn more than once?
+ *
+ * This is never defined here.  Define it to have draw buffers
+ * remember which cells have been written since the counters were
+ * last reset, so that @c get_overdraw can report cells that were
+ * painted over.  It costs a pass over every run written.
+ */
 
 namespace ovision
 {
@@ -61,7 +79,14 @@ namespace ovision
   protected:
        
     screen_size mSize;                  //!< Buffer size.
-    astring     mData;                  //!< Attributed string data.
+    cell_buffer mCells;                 //!< Character cells.
+    rect        mClip;                  //!< Area that may be drawn to.
+    std::size_t mWrites;                //!< Cells written since reset.
+    std::size_t mOverdraw;              //!< Cells written over since reset.
+#if defined(OVISION_COUNT_OVERDRAW)
+    std::vector<std::uint32_t> mStamps; //!< Generation each cell was written.
+    std::uint32_t mGeneration;          //!< Current write generation.
+#endif
     
 
     // Public member functions.
@@ -71,9 +96,20 @@ namespace ovision
     draw_buffer();
 
     // Buffer functions.
-    void     resize();
-    std::size_t  size() const;
-    astring &data();
+    void               resize();
+    std::size_t        size() const;
+    screen_size        get_size() const;
+    const cell_buffer &cells() const;
+
+    // Clipping functions.
+    const rect &get_clip() const;
+    void        set_clip(const rect &area);
+    void        reset_clip();
+
+    // Write counter functions.
+    std::size_t get_cell_writes() const;
+    std::size_t get_overdraw() const;
+    void        reset_cell_writes();
 
     // Buffer drawing functions.
     void clear(attr_t attr = default_attributes);
@@ -82,15 +118,15 @@ namespace ovision
               bool   clear = false,
               char_t empty = ' ');
     
-    void fill(rect   &area,
-              attr_t  attr,
-              bool    clear = false,
-              char_t  empty = ' ');
+    void fill(const rect &area,
+              attr_t      attr,
+              bool        clear = false,
+              char_t      empty = ' ');
     
-    void draw_rect(rect   &shape,
-                   attr_t  border,
-                   attr_t  inside,
-                   bool    decoration = false);
+    void draw_rect(const rect &shape,
+                   attr_t      border,
+                   attr_t      inside,
+                   bool        decoration = false);
 
     // Buffer data movement.
     void move_char(std::size_t indent,
@@ -110,6 +146,11 @@ namespace ovision
                   const string_t &str,
                   attr_t          attrs,
                   bool            decoration = false);
+
+    void move_str(std::size_t       indent,
+                  const run_string &str,
+                  std::size_t       from  = 0,
+                  std::size_t       count = string_t::npos);
     
     void move_cstr(std::size_t   indent,
                    const char_t *str,
@@ -121,6 +162,27 @@ namespace ovision
                   attr_t       attr,
                   std::size_t  count);
 
+    // View functions.
+    cell_span2d       span(const rect &area);
+    const_cell_span2d span(const rect &area) const;
+
+    // Block transfer functions.
+    void copy_to(picmap &dest, const rect &from) const;
+
+    void blit(const picmap &source,
+              const rect   &from,
+              const point  &to,
+              const rect   &clip);
+
+    void blit(const picmap &source,
+              const rect   &from,
+              const point  &to);
+
+    void blit(const picpack_image &source,
+              const rect          &from,
+              const point         &to,
+              const rect          &clip);
+
     // Single character cell functions.
     void put_attribute(std::size_t indent, attr_t attr);
     void put_char(std::size_t indent, char_t c, attr_t attr);
@@ -129,7 +191,131 @@ namespace ovision
     // Utility functions.
     void dump();
 
+
+    // Private member functions.
+  private:
+
+    /**
+     * @brief Count a run of cells as written.
+     * @param indent The offset of the first cell.
+     * @param count The number of cells.
+     */
+    void
+    wrote(std::size_t indent, std::size_t count)
+    {
+      mWrites += count;
+
+#if defined(OVISION_COUNT_OVERDRAW)
+      for (std::size_t i = indent; i < indent + count; ++i) {
+        if (mStamps[i] == mGeneration) {
+          ++mOverdraw;
+        } else {
+          mStamps[i] = mGeneration;
+        }
+      }
+#else
+      (void)indent;
+#endif
+    }
+
+    /**
+     * @brief Is a cell inside the clip rectangle?
+     * @param indent The offset of the cell.
+     */
+    bool
+    visible(std::size_t indent) const
+    {
+      signed x = __CAST(signed, indent % mSize.width);
+      signed y = __CAST(signed, indent / mSize.width);
+
+      return (x >= mClip.left() && x < mClip.right() &&
+              y >= mClip.top()  && y < mClip.bottom());
+    }
+
+    /**
+     * @brief Call a function for each clipped row of a run of cells.
+     * @param indent The offset of the first cell in the run.
+     * @param count The number of cells in the run.
+     * @param fn The function, called with the offset and length of
+     *           each part of the run inside the clip rectangle.
+     */
+    template <class _Fn>
+    void
+    clip_run(std::size_t indent, std::size_t count, _Fn fn) const
+    {
+      std::size_t width = mSize.width;
+      std::size_t left  = __CAST(std::size_t, mClip.left());
+      std::size_t right = __CAST(std::size_t, mClip.right());
+      std::size_t top   = __CAST(std::size_t, mClip.top());
+      std::size_t bot   = __CAST(std::size_t, mClip.bottom());
+
+      if (width == 0) {
+        return;
+      }
+
+      while (count > 0) {
+        std::size_t y    = indent / width;
+        std::size_t x    = indent % width;
+        std::size_t span = std::min(count, width - x);
+
+        if (y >= top && y < bot) {
+          std::size_t from = std::max(x, left);
+          std::size_t to   = std::min(x + span, right);
+
+          if (from < to) {
+            fn(from + y * width, to - from);
+          }
+        }
+
+        indent += span;
+        count  -= span;
+      }
+    }
+
+    /**
+     * @brief Put a character to the buffer if it is not clipped.
+     * @param indent The offset of the cell.
+     * @param c The character.
+     * @param attr The attribute(s) for the character.
+     */
+    void
+    put_clipped(std::size_t indent, char_t c, attr_t attr)
+    {
+      if (indent < mCells.size() && visible(indent)) {
+        mCells.put(indent, c, attr);
+        wrote(indent, 1);
+      }
+    }
+
+    /**
+     * @brief Fill a run of cells, dropping anything clipped.
+     * @param indent The offset of the first cell.
+     * @param count The number of cells.
+     * @param c The character.
+     * @param attr The attribute(s) for the character.
+     */
+    void
+    fill_clipped(std::size_t indent,
+                 std::size_t count,
+                 char_t      c,
+                 attr_t      attr)
+    {
+      clip_run(indent,
+               count,
+               [&](std::size_t loc, std::size_t span)
+               {
+                 mCells.fill(loc, span, c, attr);
+                 wrote(loc, span);
+               });
+    }
+
   };                                    // class draw_buffer
+
+  /**
+   * @brief The draw buffer that views render into and the screen is
+   *        presented from.
+   */
+  extern draw_buffer GlobalDrawBuffer;
   
 }                                       // namespace ovision
 
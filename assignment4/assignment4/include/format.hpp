@@ -0,0 +1,404 @@
+//
+// format.hpp --- Allocation-free text formatting.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 16:31:45 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 16:31:45
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file format.hpp
+ * @author Paul Ward
+ * @brief Allocation-free text formatting.
+ */
+
+#pragma once
+#ifndef _format_hpp_
+#define _format_hpp_
+
+#include <cstddef>
+#include <string>
+
+#include "char.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief The most characters an integer can format to.
+   *
+   * Enough for the digits of a 64-bit value and a sign.
+   */
+  const std::size_t max_integer_chars = 21;
+
+  std::size_t format_integer(char_t             *out,
+                             unsigned long long  value,
+                             bool                negative);
+
+
+  // =================================================================
+
+
+  /**
+   * @brief Formatting into storage that belongs to someone else.
+   * @tparam _Sink The type that characters are written to.
+   *
+   * This is a small replacement for a string stream, for status
+   * messages and the like.  It only knows about characters, strings
+   * and integers, and it never allocates or looks at the locale;
+   * what is written depends on the sink.
+   */
+  template <class _Sink>
+  class basic_format
+    : public _Sink
+  {
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Constructor function.
+     */
+    basic_format()
+      : _Sink()
+    {}
+
+    /**
+     * @brief Constructor function.
+     * @tparam _Arg The type of the argument for the sink.
+     * @param arg The argument for the sink.
+     */
+    template <class _Arg>
+    explicit basic_format(_Arg &arg)
+      : _Sink(arg)
+    {}
+
+    /**
+     * @brief Write a character.
+     */
+    basic_format &
+    operator << (char_t ch)
+    {
+      this->put(&ch, 1);
+
+      return *this;
+    }
+
+    /**
+     * @brief Write a string terminated by a null.
+     */
+    basic_format &
+    operator << (const char_t *str)
+    {
+      this->put(str, std::char_traits<char_t>::length(str));
+
+      return *this;
+    }
+
+    /**
+     * @brief Write a string.
+     */
+    basic_format &
+    operator << (const string_t &str)
+    {
+      this->put(str.c_str(), str.length());
+
+      return *this;
+    }
+
+    /**
+     * @brief Write a signed integer.
+     */
+    basic_format &
+    operator << (int value)
+    {
+      return put_signed(value);
+    }
+
+    /**
+     * @brief Write a signed integer.
+     */
+    basic_format &
+    operator << (long value)
+    {
+      return put_signed(value);
+    }
+
+    /**
+     * @brief Write a signed integer.
+     */
+    basic_format &
+    operator << (long long value)
+    {
+      return put_signed(value);
+    }
+
+    /**
+     * @brief Write an unsigned integer.
+     */
+    basic_format &
+    operator << (unsigned value)
+    {
+      return put_unsigned(value);
+    }
+
+    /**
+     * @brief Write an unsigned integer.
+     */
+    basic_format &
+    operator << (unsigned long value)
+    {
+      return put_unsigned(value);
+    }
+
+    /**
+     * @brief Write an unsigned integer.
+     */
+    basic_format &
+    operator << (unsigned long long value)
+    {
+      return put_unsigned(value);
+    }
+
+
+    // Private member functions.
+  private:
+
+    /**
+     * @brief Write a signed integer.
+     * @param value The value.
+     */
+    basic_format &
+    put_signed(long long value)
+    {
+      char_t             digits[max_integer_chars];
+      unsigned long long magnitude = __CAST(unsigned long long, value);
+
+      if (value < 0) {
+        magnitude = 0 - magnitude;
+      }
+
+      this->put(digits, format_integer(digits, magnitude, value < 0));
+
+      return *this;
+    }
+
+    /**
+     * @brief Write an unsigned integer.
+     * @param value The value.
+     */
+    basic_format &
+    put_unsigned(unsigned long long value)
+    {
+      char_t digits[max_integer_chars];
+
+      this->put(digits, format_integer(digits, value, false));
+
+      return *this;
+    }
+
+  };                                    // class basic_format
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A sink that writes into a fixed array of characters.
+   * @tparam _N The number of characters, including the null.
+   *
+   * Anything that does not fit is dropped, and the text is always
+   * terminated.
+   */
+  template <std::size_t _N>
+  class buffer_sink
+  {
+
+    // Private member fields.
+  private:
+
+    char_t      mBuffer[_N];            //!< The characters.
+    std::size_t mLength;                //!< Number of characters.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Constructor function.
+     */
+    buffer_sink()
+      : mLength(0)
+    {
+      mBuffer[0] = 0;
+    }
+
+    /**
+     * @brief Return the text.
+     */
+    const char_t *
+    c_str() const
+    {
+      return mBuffer;
+    }
+
+    /**
+     * @brief Return the number of characters.
+     */
+    std::size_t
+    length() const
+    {
+      return mLength;
+    }
+
+    /**
+     * @brief Empty the buffer.
+     */
+    void
+    clear()
+    {
+      mLength    = 0;
+      mBuffer[0] = 0;
+    }
+
+    /**
+     * @brief Write some characters.
+     * @param str The characters.
+     * @param len The number of characters.
+     */
+    void
+    put(const char_t *str, std::size_t len)
+    {
+      std::size_t room = (_N - 1) - mLength;
+
+      if (len > room) {
+        len = room;
+      }
+
+      std::char_traits<char_t>::copy(mBuffer + mLength, str, len);
+
+      mLength          += len;
+      mBuffer[mLength]  = 0;
+    }
+
+  };                                    // class buffer_sink
+
+
+  /**
+   * @brief A sink that appends to an attributed string.
+   * @tparam _Alloc The allocator the attributed string uses.
+   *
+   * Characters take whatever attribute is current when they are
+   * written, so one message can be several colours.
+   */
+  template <class _Alloc>
+  class astring_sink
+  {
+
+    // Private member fields.
+  private:
+
+    basic_astring<_Alloc> &mString;     //!< The string written to.
+    attr_t                 mAttribute;  //!< Current attribute.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Constructor function.
+     * @param str The string to append to.
+     */
+    explicit astring_sink(basic_astring<_Alloc> &str)
+      : mString(str),
+        mAttribute(default_attributes)
+    {}
+
+    /**
+     * @brief Return the current attribute.
+     */
+    attr_t
+    get_attribute() const
+    {
+      return mAttribute;
+    }
+
+    /**
+     * @brief Set the attribute for whatever is written next.
+     * @param attr The attribute.
+     */
+    void
+    set_attribute(attr_t attr)
+    {
+      mAttribute = attr;
+    }
+
+    /**
+     * @brief Write some characters.
+     * @param str The characters.
+     * @param len The number of characters.
+     */
+    void
+    put(const char_t *str, std::size_t len)
+    {
+      for (std::size_t i = 0; i < len; ++i) {
+        mString.push_back(achar(str[i], mAttribute));
+      }
+    }
+
+    // Private member functions.
+  private:
+
+    // Not assignable.
+    astring_sink &operator=(const astring_sink &);
+
+  };                                    // class astring_sink
+
+
+  /**
+   * @brief Formatting into a fixed buffer of characters.
+   * @tparam _N The size of the buffer, including the null.
+   */
+  template <std::size_t _N>
+  class format_buffer
+    : public basic_format<buffer_sink<_N>>
+  {};
+
+  /**
+   * @typedef aformat
+   * @brief Formatting onto the end of an attributed string.
+   */
+  typedef basic_format<astring_sink<std::allocator<achar>>> aformat;
+
+}                                       // namespace ovision
+
+#endif // !_format_hpp_
+
+// format.hpp ends here
@@ -73,7 +73,7 @@ namespace ovision
 
     // Constructor functions.
     frame();
-    frame(rect &area);
+    frame(const rect &area);
 
     // Title functions.
     virtual void      set_title(const string_t &title);
@@ -112,6 +112,7 @@ public:
   void compose_guesses();
   void compose_word_text();
   bool locate_characters(char_t ch);
+  void show_lives_used();
   
   // Game logic function.
   void game_logic(text   &msgBuffer,
@@ -44,9 +44,17 @@
 #ifndef _gamepic_hpp_
 #define _gamepic_hpp_
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "compiler.hpp"
+#include "animation.hpp"
 #include "char.hpp"
 #include "picmap.hpp"
+#include "picpack.hpp"
+#include "staticpic.hpp"
 #include "types.hpp"
 
 using namespace ovision;
@@ -57,10 +65,38 @@ using namespace ovision;
 #include "../resources/victim2.tpm"
 #include "../resources/hangman.tpm"
 
+/**
+ * @brief The gallows standing on the background.
+ */
+static OVISION_CONSTEXPR
+static_picmap<BACKGROUND_width, BACKGROUND_height> GALLOWS_SCENE =
+  static_overlay<4, 1>(BACKGROUND, GALLOWS1);
+
+/**
+ * @brief The hangman standing by the gallows.
+ */
+static OVISION_CONSTEXPR
+static_picmap<BACKGROUND_width, BACKGROUND_height> HANGMAN_SCENE =
+  static_overlay<15, 6>(GALLOWS_SCENE, HANGMAN1);
+
+/**
+ * @brief The victim swinging from the gallows.
+ */
+static OVISION_CONSTEXPR
+static_picmap<BACKGROUND_width, BACKGROUND_height> VICTIM2_SCENE =
+  static_overlay<5, 2>(HANGMAN_SCENE, VICTIM2);
+
 /**
  * @brief Picture generator.
  *
  * This class generates the 'hangman' pictures used by the game.
+ *
+ * Every stage of the picture is composed once, the first time one is
+ * asked for, and kept in a table.  After that, asking for a picture
+ * is just a table lookup.
+ *
+ * The art itself, and the scenes that do not depend on how many
+ * lives are left, are built by the compiler (see staticpic.hpp).
  */
 class pic_generator
 {
@@ -75,14 +111,149 @@ public:
 public:
 
   /**
-   * @brief COmpute the picture for a given number of lives used.
-   * @param lives The number of lives used the picture will represent.
+   * @brief Return the picture for a given number of lives left.
+   * @param lives The number of lives left the picture will represent.
    * @param maximum The maximum number of lives.
-   * @returns The computed picture.
+   * @returns The picture, which never changes and lives as long as
+   *          the program does.
    */
   static
-  picmap &
+  const picmap &
   compute_picmap(std::size_t lives, std::size_t maximum)
+  {
+    const std::vector<picmap> &table = stages(maximum);
+
+    return table[std::min(lives, maximum)];
+  }
+
+  /**
+   * @brief Return the hangman pictures as an animation.
+   * @param maximum The maximum number of lives.
+   * @returns The animation, whose frame @c n is the picture with
+   *          @c n lives used.  It lives as long as the program does.
+   *
+   * Going from one stage to the next only changes a few cells, so
+   * the animation keeps the first picture and just the cells that
+   * change after that.
+   *
+   * There is only one animation, and asking for it with a different
+   * maximum rebuilds it in place.  The reference stays good, but
+   * anything it held before then, such as a frame being played, is
+   * invalidated and the old maximum's pictures are gone.
+   */
+  static
+  const animation &
+  compute_animation(std::size_t maximum)
+  {
+    // No maximum is all ones, so the first call always builds.
+    static animation   anim;
+    static std::size_t built = ~__CAST(std::size_t, 0);
+
+    const std::vector<picmap> &table = stages(maximum);
+
+    if (built != maximum || anim.size() != maximum + 1) {
+      anim.set_keyframe(table[maximum]);
+
+      for (std::size_t used = 1; used <= maximum; ++used) {
+        anim.add_frame(table[maximum - used]);
+      }
+
+      built = maximum;
+    }
+
+    return anim;
+  }
+
+  /**
+   * @brief Write the pictures built into the program out as a pack.
+   * @param path The path to write the pack to.
+   * @returns @c true if the pack was written.
+   *
+   * This is the converter from the @c .tpm resources to the pack
+   * format read by @c picpack.  Each resource becomes a picture
+   * named after its file.
+   */
+  static
+  bool
+  write_pack(const std::string &path)
+  {
+    picpack_writer writer;
+
+    writer.add("background", unpack(BACKGROUND));
+    writer.add("gallows",    unpack(GALLOWS1));
+    writer.add("hangman",    unpack(HANGMAN1));
+    writer.add("victim1",    unpack(VICTIM1));
+    writer.add("victim2",    unpack(VICTIM2));
+
+    return writer.write(path);
+  }
+
+
+  // Private static member functions.
+private:
+
+  /**
+   * @brief Return the table of every stage of the picture.
+   * @param maximum The maximum number of lives.
+   * @returns A table with a picture for each number of lives left,
+   *          from none to @c maximum.
+   *
+   * Each maximum gets its own table, composed the first time it is
+   * asked for.  Tables are never changed or thrown away once built,
+   * so the pictures in them live as long as the program does.
+   */
+  static
+  const std::vector<picmap> &
+  stages(std::size_t maximum)
+  {
+    typedef std::map<std::size_t, std::vector<picmap> > table_map;
+
+    static table_map tables;
+
+    table_map::iterator found = tables.find(maximum);
+
+    if (found == tables.end()) {
+      std::vector<picmap> &table = tables[maximum];
+
+      table.reserve(maximum + 1);
+
+      for (std::size_t lives = 0; lives <= maximum; ++lives) {
+        table.push_back(compose(lives, maximum));
+      }
+
+      return table;
+    }
+
+    return found->second;
+  }
+
+  /**
+   * @brief Copy a static picture into a picture map.
+   * @param art The static picture.
+   * @returns The picture map.
+   */
+  template <std::size_t _Width, std::size_t _Height>
+  static
+  picmap
+  unpack(const static_picmap<_Width, _Height> &art)
+  {
+    picmap result;
+
+    art.image().copy_to(result);
+
+    return result;
+  }
+
+  /**
+   * @brief Compose the picture for a given number of lives left.
+   * @param lives The number of lives left the picture will represent.
+   * @param maximum The maximum number of lives.
+   * @returns The composed picture, which is only valid until the next
+   *          picture is composed.
+   */
+  static
+  picmap &
+  compose(std::size_t lives, std::size_t maximum)
   {
     static std::size_t gheight = GALLOWS1_height;
     static std::size_t vheight = VICTIM1_height;
@@ -108,10 +279,6 @@ public:
     return background();
   }
 
-
-  // Private static member functions.
-private:
-
   /**
    * @brief Geerate the background field.
    * @returns A computed picture.
@@ -120,16 +287,7 @@ private:
   picmap &
   background()
   {
-    static picmap      base;
-    static std::size_t len = BACKGROUND_width * BACKGROUND_height;
-
-    base.clear();
-    base.assign(len, achar(' ', bg_black));
-
-    for (std::size_t i = 0; i < len; ++i) {
-      base.at(i).character = BACKGROUND_elems[i];
-      base.at(i).attribute = BACKGROUND_attrs[i];
-    }
+    static picmap base = unpack(BACKGROUND);
 
     return base;
   }
@@ -137,12 +295,9 @@ private:
   /**
    * @brief Overlay a picture by a limited amount (i.e, n lines).
    * @param base The base picture to draw on.
-   * @param glyphs The picture data to draw.
-   * @param attrs The attributes for the data.
+   * @param sprite The picture to draw.
    * @param left The left coordinate to draw at.
    * @param top The top coordinate to draw at.
-   * @param width The width of the data.
-   * @param height The height of the data.
    * @param lines The number of lines of the data to draw.
    * @param from_top @c true if the data is drawn from the top, or
    *                 @c false if the data is drawn from the bottom.
@@ -150,41 +305,28 @@ private:
    */
   static
   picmap &
-  limited_overlay(picmap      &base,
-                  char_t       glyphs[],
-                  attr_t       attrs[],
-                  std::size_t  left,
-                  std::size_t  top,
-                  std::size_t  width,
-                  std::size_t  height,
-                  std::size_t  lines,
-                  bool         from_top)
+  limited_overlay(picmap       &base,
+                  const picmap &sprite,
+                  std::size_t   left,
+                  std::size_t   top,
+                  std::size_t   lines,
+                  bool          from_top)
   {
-    std::size_t right    = width + left;
-    std::size_t bottom   = height + top;
-    std::size_t bg_width = BACKGROUND_width;
-    std::size_t pos      = 0;
-    std::size_t i        = 0;
+    screen_size extent = sprite.get_size();
+    signed      skip   = 0;
+    signed      height = __CAST(signed, extent.height);
     
     if (lines > 0) {
       if (!from_top) {
-        top += lines;
-        i   += lines * width;
-      } else {
-        bottom -= lines;
-      }
-    }
-    
-    for (std::size_t y = top; y < bottom; ++y) {
-      for (std::size_t x = left; x < right; ++x) {
-        pos = x + y * bg_width;
-        
-        base.at(pos).character = glyphs[i];
-        base.at(pos).attribute = attrs[i];
-        
-        i++;
+        skip = __CAST(signed, lines);
       }
+
+      height -= __CAST(signed, lines);
     }
+
+    base.blit(sprite,
+              rect(0, skip, __CAST(signed, extent.width), height),
+              point(__CAST(signed, left), __CAST(signed, top) + skip));
     
     return base;
   }
@@ -192,33 +334,19 @@ private:
   /**
    * @brief Overlay a picture.
    * @param base The base picture to draw on.
-   * @param glyphs The picture data to draw.
-   * @param attrs The attributes for the data.
+   * @param sprite The picture to draw.
    * @param left The left coordinate to draw at.
    * @param top The top coordinate to draw at.
-   * @param width The width of the data.
-   * @param height The height of the data.
    * @returns The composited picture.
    */
   static
   picmap &
-  overlay(picmap      &base,
-          char_t       glyphs[],
-          attr_t       attrs[],
-          std::size_t  left,
-          std::size_t  top,
-          std::size_t  width,
-          std::size_t  height)
+  overlay(picmap       &base,
+          const picmap &sprite,
+          std::size_t   left,
+          std::size_t   top)
   {
-    return limited_overlay(base,
-                           glyphs,
-                           attrs,
-                           left,
-                           top,
-                           width,
-                           height,
-                           0,
-                           false);
+    return limited_overlay(base, sprite, left, top, 0, false);
   }
 
   /**
@@ -230,18 +358,12 @@ private:
   hangman(std::size_t lines)
   {
     static picmap base;
-    
-    base = gallows1(0);
-    
-    return limited_overlay(base,
-                           HANGMAN1_elems,
-                           HANGMAN1_attrs,
-                           15,
-                           6,
-                           HANGMAN1_width,
-                           HANGMAN1_height,
-                           lines,
-                           false);
+    static picmap scene  = unpack(GALLOWS_SCENE);
+    static picmap sprite = unpack(HANGMAN1);
+
+    base = scene;
+
+    return limited_overlay(base, sprite, 15, 6, lines, false);
   }
 
   /**
@@ -253,18 +375,11 @@ private:
   gallows1(std::size_t lines)
   {
     static picmap base;
-    
+    static picmap sprite = unpack(GALLOWS1);
+
     base = background();
 
-    return limited_overlay(base,
-                           GALLOWS1_elems,
-                           GALLOWS1_attrs,
-                           4,
-                           1,
-                           GALLOWS1_width,
-                           GALLOWS1_height,
-                           lines,
-                           false);
+    return limited_overlay(base, sprite, 4, 1, lines, false);
   }
 
   /**
@@ -276,18 +391,12 @@ private:
   victim1(std::size_t lines)
   {
     static picmap base;
-    
-    base = hangman(0);
-
-    return limited_overlay(base,
-                           VICTIM1_elems,
-                           VICTIM1_attrs,
-                           7,
-                           2,
-                           VICTIM1_width,
-                           VICTIM1_height,
-                           lines,
-                           true);
+    static picmap scene  = unpack(HANGMAN_SCENE);
+    static picmap sprite = unpack(VICTIM1);
+
+    base = scene;
+
+    return limited_overlay(base, sprite, 7, 2, lines, true);
   }
 
   /**
@@ -298,17 +407,9 @@ private:
   picmap &
   victim2()
   {
-    static picmap base;
-    
-    base = hangman(0);
-
-    return overlay(base,
-                   VICTIM2_elems,
-                   VICTIM2_attrs,
-                   5,
-                   2,
-                   VICTIM2_width,
-                   VICTIM2_height);
+    static picmap base = unpack(VICTIM2_SCENE);
+
+    return base;
   }
 
 };                                      // class pic_generator
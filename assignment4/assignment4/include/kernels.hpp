@@ -0,0 +1,153 @@
+//
+// kernels.hpp --- Cell fill kernels.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 10:33:26 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 10:33:26
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file kernels.hpp
+ * @author Paul Ward
+ * @brief Cell fill kernels.
+ */
+
+#pragma once
+#ifndef _kernels_hpp_
+#define _kernels_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "compiler.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief Row span kernels.
+   *
+   * These fill a contiguous run of 16-bit or 32-bit values, which is
+   * what a row of a character or attribute plane is.  The masked
+   * fill only replaces some of the bits of each value, which is how
+   * one half of a packed cell is filled.  The first call
+   * picks the widest implementation the processor supports: AVX2,
+   * then SSE2, then a plain scalar loop.
+   *
+   * Only the @c OVISION_DRAWBUFFER_SOA and
+   * @c OVISION_DRAWBUFFER_PACKED cell layouts use these.  The
+   * default layout stores attributed characters, which are not a
+   * plain run of words, and fills them with @c std::fill_n.
+   */
+  namespace kernels
+  {
+
+    /**
+     * @brief Kernel instruction sets.
+     */
+    typedef enum {
+      isa_scalar = 0,                   //!< Plain C++.
+      isa_sse2,                         //!< SSE2, 128-bit stores.
+      isa_avx2                          //!< AVX2, 256-bit stores.
+    } isa_t;
+
+    // Selection functions.
+    isa_t       best_isa();
+    isa_t       current_isa();
+    void        select_isa(isa_t isa);
+    const char *isa_name(isa_t isa);
+
+    // Fill functions.
+    void fill16(std::uint16_t *dst, std::size_t count, std::uint16_t value);
+    void fill32(std::uint32_t *dst, std::size_t count, std::uint32_t value);
+    void fill32_masked(std::uint32_t *dst,
+                       std::size_t    count,
+                       std::uint32_t  value,
+                       std::uint32_t  mask);
+
+    /**
+     * @brief Fill a run of narrow characters.
+     * @param dst The first character.
+     * @param count The number of characters.
+     * @param value The character to fill with.
+     */
+    inline
+    void
+    fill(char *dst, std::size_t count, char value)
+    {
+      std::memset(dst, value, count);
+    }
+
+    /**
+     * @brief Fill a run of wide characters.
+     * @param dst The first character.
+     * @param count The number of characters.
+     * @param value The character to fill with.
+     *
+     * @c wchar_t is 16 bits with Microsoft's compiler and 32 bits
+     * nearly everywhere else.
+     */
+    inline
+    void
+    fill(wchar_t *dst, std::size_t count, wchar_t value)
+    {
+      if (sizeof(wchar_t) == sizeof(std::uint16_t)) {
+        fill16(reinterpret_cast<std::uint16_t *>(dst),
+               count,
+               __CAST(std::uint16_t, value));
+      } else {
+        fill32(reinterpret_cast<std::uint32_t *>(dst),
+               count,
+               __CAST(std::uint32_t, value));
+      }
+    }
+
+    /**
+     * @brief Fill a run of attribute words.
+     * @param dst The first attribute.
+     * @param count The number of attributes.
+     * @param value The attribute to fill with.
+     */
+    inline
+    void
+    fill(std::uint16_t *dst, std::size_t count, std::uint16_t value)
+    {
+      fill16(dst, count, value);
+    }
+
+  }                                     // namespace kernels
+
+}                                       // namespace ovision
+
+#endif // !_kernels_hpp_
+
+// kernels.hpp ends here
@@ -47,10 +47,18 @@
 #include "compiler.hpp"
 #include "types.hpp"
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
+#if defined(OVISION_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#endif
 
 #include <iostream>
+#include <string>
+
+#if defined(OVISION_HEADLESS)
+# include <chrono>
+# include <vector>
+#endif
 
 /**
  * @def KEY_ALT
@@ -79,11 +87,34 @@ namespace ovision
 
     friend class screen;
 
+#if defined(OVISION_HEADLESS)
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @typedef script_clock
+     * @brief The clock that scripted pauses are timed with.
+     */
+    typedef std::chrono::steady_clock script_clock;
+
+#endif
+
     
     // Private member fields.
   private:
 
+#if defined(OVISION_WIN32)
     INPUT_RECORD mInputRecord;          //!< Keyboard input record.
+#elif defined(OVISION_HEADLESS)
+    std::string              mScript;   //!< Scripted key presses.
+    std::vector<long>        mDelays;   //!< Milliseconds before each.
+    std::size_t              mScriptPos; //!< Next scripted key press.
+    std::size_t              mWaits;    //!< Calls to wait.
+    std::size_t              mEvents;   //!< Events read.
+    bool                     mArmed;    //!< Is a delay running?
+    script_clock::time_point mReadyAt;  //!< When the delay ends.
+#endif
     key_t        mLastKey;              //!< Last key pressed.
 
 
@@ -98,8 +129,18 @@ namespace ovision
 
     void  clear();
     bool  kbhit();
+    bool  wait(long timeout);
     key_t get_keyboard_event();
 
+#if defined(OVISION_HEADLESS)
+    // Scripting functions.
+    void        feed(const std::string &keys);
+    void        pause(long milliseconds);
+    std::size_t get_waits() const;
+    std::size_t get_events() const;
+    void        reset_stats();
+#endif
+
     
     // Private member functions.
   private:
@@ -111,6 +152,14 @@ namespace ovision
     keyboard(const keyboard &);
     void operator = (const keyboard &);
 
+#if defined(OVISION_WIN32)
+    // Console event functions.
+    void buffer_event();
+#elif defined(OVISION_HEADLESS)
+    // Scripting functions.
+    bool ready();
+#endif
+
   };                                    // class keyboard
 
 }                                       // namespace ovision
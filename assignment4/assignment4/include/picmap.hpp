@@ -44,8 +44,13 @@
 #ifndef _picmap_hpp_
 #define _picmap_hpp_
 
+#include <cstdint>
+#include <vector>
+
 #include "char.hpp"
 #include "rect.hpp"
+#include "cells.hpp"
+#include "cellspan.hpp"
 
 namespace ovision
 {
@@ -55,6 +60,12 @@ namespace ovision
    *
    * This class provides a very simple picture representation using
    * ANSI characters and attributes.
+   *
+   * A picture may also have a transparency mask, with one bit per
+   * cell that is set where the cell is opaque.  Blitting a picture
+   * with a mask leaves whatever is under its transparent cells
+   * alone, so sprites only need to hold the cells they draw.  A
+   * picture without a mask is opaque everywhere.
    */
   class picmap
   {
@@ -62,8 +73,9 @@ namespace ovision
     // Protected member fields.
   protected:
 
-    astring mData;                      //!< Picture data.
-    rect    mArea;                      //!< Data attributes.
+    cell_buffer                mCells;  //!< Picture data.
+    rect                       mArea;   //!< Data attributes.
+    std::vector<std::uint64_t> mMask;   //!< Opaque cells, if masked.
 
 
     // Public member functions.
@@ -75,27 +87,57 @@ namespace ovision
     picmap(screen_size_type width,
            screen_size_type height);
 
+    picmap(screen_size_type  width,
+           screen_size_type  height,
+           const char_t      glyphs[],
+           const attr_t      attrs[]);
+
     picmap(screen_size &size);
 
     picmap(const picmap &other);
 
 
     // Reader functions.
-    astring     &data();
-    std::size_t  size();
-    achar       &at(std::size_t index);
+    const cell_buffer &cells() const;
+    std::size_t        size() const;
+    screen_size        get_size() const;
+    achar              get(std::size_t index) const;
 
     // Writer functions.
-    void assign(std::size_t elems, achar &value);
-    void set_size(screen_size &extent);
+    void assign(std::size_t elems, const achar &value);
+    void put(std::size_t index, const achar &value);
+    void set_size(const screen_size &extent);
+    void load(screen_size_type  width,
+              screen_size_type  height,
+              const char_t      glyphs[],
+              const attr_t      attrs[]);
     
+    // Transparency functions.
+    bool                 has_mask() const;
+    const std::uint64_t *mask() const;
+    bool                 is_opaque(std::size_t index) const;
+    void                 set_opaque(std::size_t index, bool flag);
+    void                 set_mask(const std::uint64_t *bits);
+    void                 set_key(char_t key);
+    void                 clear_mask();
+
     // Utility functions.
     rect &get_area();
 
+    // View functions.
+    cell_span2d       span(const rect &area);
+    const_cell_span2d span(const rect &area) const;
+
     // Drawing functions.
     void clear();
     void fill(const screen_point &origin, attr_t attr);
     void fill(const screen_point &origin, const rect &region, attr_t attr);
+    void blit(const picmap &source, const rect &from, const point &to);
+
+    void blit(const cell_buffer &source,
+              const screen_size &source_extent,
+              const rect        &from,
+              const point       &to);
  
   };                                    // class picmap
 
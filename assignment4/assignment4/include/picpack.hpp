@@ -0,0 +1,244 @@
+//
+// picpack.hpp --- Memory-mapped picture packs.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 18:18:20 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 18:18:20
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file picpack.hpp
+ * @author Paul Ward
+ * @brief Memory-mapped picture packs.
+ */
+
+#pragma once
+#ifndef _picpack_hpp_
+#define _picpack_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compiler.hpp"
+#include "types.hpp"
+#include "char.hpp"
+#include "size.hpp"
+#include "picmap.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief A read-only view of a picture in a pack.
+   *
+   * The planes point straight into the mapped pack, so the view is
+   * only good for as long as the pack it came from is open.
+   */
+  struct picpack_image
+  {
+
+    // Public member fields.
+  public:
+
+    const char          *name;          //!< Picture name.
+    screen_size          size;          //!< Picture size in cells.
+    const std::uint16_t *characters;    //!< Character plane.
+    const std::uint16_t *attributes;    //!< Attribute plane.
+    const std::uint64_t *mask;          //!< Opaque cells, or null.
+
+
+    // Public member functions.
+  public:
+
+    // Reader functions.
+    achar get(std::size_t index) const;
+
+    // Conversion functions.
+    void copy_to(picmap &dest) const;
+
+  };                                    // struct picpack_image
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A pack of pictures mapped into memory.
+   *
+   * A pack is a single file laid out as follows, with every field in
+   * little-endian byte order:
+   *
+   *  - A 16-byte header: the magic @c "OVPK", a 16-bit version, a
+   *    16-bit picture count, the 32-bit offset of the table of
+   *    contents and the 32-bit size of the whole pack.
+   *  - The table of contents: a 32-byte entry per picture, holding
+   *    its name (NUL-padded to 16 bytes), 16-bit width and height,
+   *    and the 32-bit offsets of its character and attribute planes
+   *    and of its transparency mask.  A mask offset of zero means
+   *    the picture is opaque; version 1 packs have no masks.
+   *  - The planes: one 16-bit word per cell, one row after another.
+   *    Masks are 64-bit words, one bit per cell, set where the cell
+   *    is opaque, and start on an 8-byte boundary.
+   *
+   * Characters outside the Basic Multilingual Plane cannot be
+   * stored, just as with packed cells.  Attributes are classic
+   * attributes; interned style IDs are only good for one run of the
+   * program, so they do not belong in a pack.
+   *
+   * Opening a pack only checks the header and the table of contents.
+   * The planes are paged in by the operating system when a picture
+   * is first drawn, and are never copied.
+   */
+  class picpack
+  {
+
+    // Public constants.
+  public:
+
+    /**
+     * @brief The version of the pack layout written and understood.
+     */
+    static const std::uint16_t version = 2;
+
+    /**
+     * @brief The longest picture name, not counting the NUL.
+     */
+    static const std::size_t max_name = 15;
+
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @typedef image_vector
+     * @brief A vector of picture views.
+     */
+    typedef std::vector<picpack_image> image_vector;
+
+
+    // Private member fields.
+  private:
+
+    const unsigned char *mData;         //!< The mapped pack.
+    std::size_t          mBytes;        //!< Size of the mapping.
+    image_vector         mImages;       //!< The table of contents.
+#if defined(_WIN32)
+    void                *mFile;         //!< File handle.
+    void                *mMapping;      //!< File mapping handle.
+#endif
+
+
+    // Public member functions.
+  public:
+
+    // Constructor and destructor functions.
+    picpack();
+    ~picpack();
+
+    // Pack functions.
+    bool open(const std::string &path);
+    void close();
+    bool is_open() const;
+
+    // Reader functions.
+    std::size_t          size() const;
+    const picpack_image &at(std::size_t index) const;
+    const picpack_image *find(const std::string &name) const;
+
+
+    // Private member functions.
+  private:
+
+    // Not copyable.
+    picpack(const picpack &);
+    picpack &operator=(const picpack &);
+
+    bool map(const std::string &path);
+    void unmap();
+    bool read_contents();
+
+  };                                    // class picpack
+
+
+  // =================================================================
+
+
+  /**
+   * @brief Writes picture maps out as a pack.
+   *
+   * This is how the pictures built into the program are turned into
+   * a pack; see @c pic_generator::write_pack.
+   */
+  class picpack_writer
+  {
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @brief A picture waiting to be written.
+     */
+    struct entry {
+      std::string                name;  //!< Picture name.
+      screen_size                size;  //!< Picture size in cells.
+      std::vector<std::uint16_t> chars; //!< Character plane.
+      std::vector<std::uint16_t> attrs; //!< Attribute plane.
+      std::vector<std::uint64_t> mask;  //!< Opaque cells, if masked.
+    };
+
+    /**
+     * @typedef entry_vector
+     * @brief A vector of pictures.
+     */
+    typedef std::vector<entry> entry_vector;
+
+
+    // Private member fields.
+  private:
+
+    entry_vector mEntries;              //!< Pictures to write.
+
+
+    // Public member functions.
+  public:
+
+    void add(const std::string &name, const picmap &source);
+    bool write(const std::string &path) const;
+
+  };                                    // class picpack_writer
+
+}                                       // namespace ovision
+
+#endif // !_picpack_hpp_
+
+// picpack.hpp ends here
@@ -47,6 +47,8 @@
 #include "char.hpp"
 #include "view.hpp"
 #include "picmap.hpp"
+#include "picpack.hpp"
+#include "animation.hpp"
 
 namespace ovision
 {
@@ -61,7 +63,12 @@ namespace ovision
     // Protected member fields.
   protected:
 
-    picmap mContent;                    //!< Picture contents.
+    picmap        mContent;             //!< Picture contents.
+    const picmap *mShared;              //!< Picture shown without a copy.
+    const picpack_image *mImage;        //!< Pack picture shown, if any.
+    const animation     *mAnimation;    //!< Animation shown, if any.
+    std::size_t          mFrame;        //!< Animation frame shown.
+    std::size_t          mTarget;       //!< Frame being played towards.
 
 
     // Public member functions.
@@ -69,12 +76,22 @@ namespace ovision
     
     // Constructor functions.
     picture();
-    picture(rect &area);
+    picture(const rect &area);
 
     // Accessor functions.
     virtual void    set_picmap(const picmap &data);
+    virtual void    share_picmap(const picmap &data);
+    virtual void    share_image(const picpack_image &data);
     virtual picmap &get_picmap();
 
+    // Animation functions.
+    void        set_animation(const animation &anim, std::size_t index = 0);
+    void        seek(std::size_t index);
+    void        play_to(std::size_t index);
+    bool        step();
+    bool        is_playing() const;
+    std::size_t get_frame() const;
+
     // Drawing functions.
     void fill(attr_t attr);
 
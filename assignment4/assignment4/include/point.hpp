@@ -47,13 +47,18 @@
 #define _point_hpp_
 
 #include <cstddef>
+#include <type_traits>
 #include <utility>
 
-#include <ovision/compiler.h>
-#include <ovision/platform.h>
-#include <ovision/arch.h>
-#include <ovision/standards.h>
-#include <ovision/hacks.h>
+#if defined(_MSC_VER)
+# include <ovision/compiler.h>
+# include <ovision/platform.h>
+# include <ovision/arch.h>
+# include <ovision/standards.h>
+# include <ovision/hacks.h>
+#endif
+
+#include "compiler.hpp"
 
 namespace ovision
 {
@@ -220,6 +225,17 @@ namespace ovision
     typedef typename std::remove_reference<_Ty>::type _TyX;
 
 
+    // Inherited data members.
+  public:
+
+    /*
+     * The base class depends on a template parameter, so its
+     * members are not found by name alone; make them visible.
+     */
+    using _MyBase::x;
+    using _MyBase::y;
+
+
     // Public member functions.
   public:
 
@@ -233,6 +249,14 @@ namespace ovision
       : _MyBase()
     {}
 
+    /**
+     * @brief Copy constructor function.
+     * @param _Right The object to copy from.
+     */
+    basic_point(const basic_point &_Right)
+      : _MyBase(_Right)
+    {}
+
     /**
      * @brief Constructor function.
      * @param _X The X coordinate.
@@ -248,7 +272,7 @@ namespace ovision
      * @param _Right The object to copy from.
      */
     template <class _Other>
-    basic_point(basic_point<_Other> &_Right)
+    basic_point(const basic_point<_Other> &_Right)
       : _MyBase(_Right.x, _Right.y)
     {}
 
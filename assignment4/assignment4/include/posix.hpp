@@ -45,7 +45,29 @@
 #define _posix_hpp_
 
 #include <cstdarg>
-#include <tchar.h>
+
+#if defined(_WIN32)
+# include <tchar.h>
+#else
+# include <climits>
+# include <cwchar>
+
+/*
+ * Everything that is not Windows is Unicode (see OVISION_UNICODE), so
+ * the generic-text names map straight onto the wide C library.
+ */
+typedef wchar_t TCHAR;
+
+# define _T(x)       L ## x
+# define _TEXT(x)    L ## x
+# define _tcslen     std::wcslen
+# define _tcstol     std::wcstol
+# define _vsntprintf std::vswprintf
+
+# if !defined(MAX_PATH)
+#  define MAX_PATH   PATH_MAX
+# endif
+#endif
 
 /**
  * @brief Utility functions that are present on POSIX-conforming operating
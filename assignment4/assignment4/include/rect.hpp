@@ -46,6 +46,7 @@
 #ifndef _rect_hpp_
 #define _rect_hpp_
 
+#include <algorithm>
 #include <limits>
 
 #include "size.hpp"
@@ -198,7 +199,7 @@ namespace ovision
                _TyPX       &&_Left,
                _TySX       &&_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(std::move(_top), _Left)),
+      : origin(basic_point_type(std::move(_Top), _Left)),
         extent(basic_size_type(_Width, _Height))
     {}
 
@@ -213,7 +214,7 @@ namespace ovision
                const _TyPX  &_Left,
                _TySX       &&_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(_top, std::move(_Left))),
+      : origin(basic_point_type(_Top, std::move(_Left))),
         extent(basic_size_type(_Width, _Height))
     {}
 
@@ -228,7 +229,7 @@ namespace ovision
                _TyPX       &&_Left,
                const _TySX  &_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(_top, _Left)),
+      : origin(basic_point_type(_Top, _Left)),
         extent(basic_size_type(std::move(_Width), _Height))
     {}
 
@@ -243,7 +244,7 @@ namespace ovision
                _TyPX       &&_Left,
                _TySX       &&_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(_top, _Left)),
+      : origin(basic_point_type(_Top, _Left)),
         extent(basic_size_type(_Width, std::move(_Height)))
     {}
 
@@ -258,7 +259,7 @@ namespace ovision
                _TyPX       &&_Left,
                _TySX       &&_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(std::move(_top), _Left)),
+      : origin(basic_point_type(std::move(_Top), _Left)),
         extent(basic_size_type(_Width, std::move(_Height)))
     {}
 
@@ -273,7 +274,7 @@ namespace ovision
                const _TyPX  &_Left,
                _TySX       &&_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(_top, std::move(_Left))),
+      : origin(basic_point_type(_Top, std::move(_Left))),
         extent(basic_size_type(_Width, std::move(_Height)))
     {}
 
@@ -288,7 +289,7 @@ namespace ovision
                _TyPX       &&_Left,
                const _TySX  &_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(_top, _Left)),
+      : origin(basic_point_type(_Top, _Left)),
         extent(basic_size_type(std::move(_Width), std::move(_Height)))
     {}
 
@@ -303,7 +304,7 @@ namespace ovision
                _TyPX       &&_Left,
                const _TySX  &_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(std::move(_top), _Left)),
+      : origin(basic_point_type(std::move(_Top), _Left)),
         extent(basic_size_type(std::move(_Width), std::move(_Height)))
     {}
 
@@ -318,7 +319,7 @@ namespace ovision
                const _TyPX  &_Left,
                const _TySX  &_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(_top, std::move(_Left))),
+      : origin(basic_point_type(_Top, std::move(_Left))),
         extent(basic_size_type(std::move(_Width), std::move(_Height)))
     {}
 
@@ -333,7 +334,7 @@ namespace ovision
                const _TyPX &_Left,
                const _TySX &_Width,
                const _TySX &_Height)
-      : origin(basic_point_type(std::move(_top), std::move(_Left))),
+      : origin(basic_point_type(std::move(_Top), std::move(_Left))),
         extent(basic_size_type(std::move(_Width), std::move(_Height)))
     {}
 
@@ -348,7 +349,7 @@ namespace ovision
                const _TyPX  &_Left,
                _TySX       &&_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(std::move(_top), std::move(_Left))),
+      : origin(basic_point_type(std::move(_Top), std::move(_Left))),
         extent(basic_size_type(_Width, _Height))
     {}
 
@@ -363,7 +364,7 @@ namespace ovision
                const _TyPX  &_Left,
                _TySX       &&_Width,
                const _TySX  &_Height)
-      : origin(basic_point_type(std::move(_top), std::move(_Left))),
+      : origin(basic_point_type(std::move(_Top), std::move(_Left))),
         extent(basic_size_type(_Width, std::move(_Height)))
     {}
 
@@ -378,7 +379,7 @@ namespace ovision
                const _TyPX  &_Left,
                const _TySX  &_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(_top, std::move(_Left))),
+      : origin(basic_point_type(_Top, std::move(_Left))),
         extent(basic_size_type(std::move(_Width), _Height))
     {}
 
@@ -393,7 +394,7 @@ namespace ovision
                const _TyPX  &_Left,
                const _TySX  &_Width,
                _TySX       &&_Height)
-      : origin(basic_point_type(std::move(_top), std::move(_Left))),
+      : origin(basic_point_type(std::move(_Top), std::move(_Left))),
         extent(basic_size_type(std::move(_Width), _Height))
     {}
 
@@ -475,6 +476,14 @@ namespace ovision
     typedef typename std::remove_reference<_TyS>::type _TySX;
 
 
+    // Inherited data members.
+  public:
+
+    // Named here so the member functions can use them unqualified.
+    using _MyBase::origin;
+    using _MyBase::extent;
+
+
     // Public member functions.
   public:
 
@@ -485,6 +494,14 @@ namespace ovision
       : _MyBase()
     {}
 
+    /**
+     * @brief Copy constructor function.
+     * @param _Right The object to copy from.
+     */
+    basic_rect(const basic_rect &_Right)
+      : _MyBase(_Right)
+    {}
+
     /**
      * @brief Constructor function
      * @param _Top The initial top (y) value.
@@ -516,7 +533,7 @@ namespace ovision
      * @param _Right The other object.
      */
     template <class _OTyP, class _OTyS>
-    basic_rect(basic_rect<_OTyP, _OTyS> &_Right)
+    basic_rect(const basic_rect<_OTyP, _OTyS> &_Right)
       : _MyBase(_Right)
     {}
 
@@ -1056,7 +1073,7 @@ namespace ovision
       origin.x      = x;
       origin.y      = y;
       extent.width  = w;
-      extent.height = h
+      extent.height = h;
     }
 
     /**
@@ -1107,14 +1124,19 @@ namespace ovision
      * @returns A new object that is the result of the intersection.
      */
     inline
-    _MyType &
+    _MyType
     operator & (const _MyType &_Other) const
     {
       if (touches(_Other)) {
-        return _MyType(std::max(origin.x, _Other.origin.x),
-                       std::max(origin.y, _Other.origin.y),
-                       std::min(extent.width, _Other.extent.width),
-                       std::min(extent.height, _Other.extent.height));
+        point_type l = std::max(left(), _Other.left());
+        point_type t = std::max(top(), _Other.top());
+
+        return _MyType(l,
+                       t,
+                       __CAST(size_type,
+                              std::min(right(), _Other.right()) - l),
+                       __CAST(size_type,
+                              std::min(bottom(), _Other.bottom()) - t));
       }
 
       return _MyType();
@@ -1126,13 +1148,18 @@ namespace ovision
      * @returns A new object that is the result of the union.
      */
     inline
-    _MyType &
+    _MyType
     operator | (const _MyType &_Other) const
     {
-      return _MyType(std::min(origin.x, _Other.origin.x),
-                     std::min(origin.y, _Other.origin.y),
-                     std::max(extent.width, _Other.extent.width),
-                     std::max(extent.height, _Other.extent.height));
+      point_type l = std::min(left(), _Other.left());
+      point_type t = std::min(top(), _Other.top());
+
+      return _MyType(l,
+                     t,
+                     __CAST(size_type,
+                            std::max(right(), _Other.right()) - l),
+                     __CAST(size_type,
+                            std::max(bottom(), _Other.bottom()) - t));
     }
 
     /**
@@ -1142,7 +1169,7 @@ namespace ovision
     inline
     operator const basic_point_type * () const
     {
-      return static_cast<const basic_point_type *>this.origin;
+      return &this->origin;
     }
 
     /**
@@ -1152,7 +1179,7 @@ namespace ovision
     inline
     operator basic_point_type * ()
     {
-      return static_cast<basic_point_type *>this.origin;
+      return &this->origin;
     }
 
     /**
@@ -1162,7 +1189,7 @@ namespace ovision
     inline
     operator const basic_size_type * () const
     {
-      return static_cast<const basic_size_type *>this.extent;
+      return &this->extent;
     }
 
     /**
@@ -1172,7 +1199,7 @@ namespace ovision
     inline
     operator basic_size_type * ()
     {
-      return static_cast<basic_size_type *>this.extent;
+      return &this->extent;
     }
 
     /**
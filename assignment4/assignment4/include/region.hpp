@@ -0,0 +1,117 @@
+//
+// region.hpp --- Rectangular screen regions.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 15:35:13 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 15:35:13
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file region.hpp
+ * @author Paul Ward
+ * @brief Rectangular screen regions.
+ */
+
+#pragma once
+#ifndef _region_hpp_
+#define _region_hpp_
+
+#include <cstddef>
+#include <vector>
+
+#include "rect.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief An area of the screen made up of rectangles.
+   *
+   * The rectangles never overlap, so every cell in the region is
+   * covered exactly once.  This is what lets the painter hand each
+   * view only the cells nothing else will draw over.
+   *
+   * The set operations build their results in vectors the region
+   * keeps, so a region that is reused frame after frame stops
+   * allocating once those have grown to fit.
+   */
+  class region
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @typedef rect_vector
+     * @brief A vector of rectangles.
+     */
+    typedef std::vector<rect> rect_vector;
+
+
+    // Private member fields.
+  private:
+
+    rect_vector mRects;                 //!< Non-overlapping rectangles.
+    rect_vector mScratch;               //!< Rectangles being built.
+    rect_vector mPieces;                //!< Pieces of an added area.
+
+
+    // Public member functions.
+  public:
+
+    // Constructor functions.
+    region();
+    region(const rect &area);
+    region(const region &other);
+
+    // Assignment functions.
+    region &operator = (const region &other);
+
+    // Accessor functions.
+    bool         empty() const;
+    std::size_t  size() const;
+    std::size_t  area() const;
+    const rect  &operator [] (std::size_t idx) const;
+
+    // Set functions.
+    void clear();
+    void add(const rect &area);
+    void subtract(const rect &area);
+    void intersect(const rect &area);
+    bool touches(const rect &area) const;
+
+  };                                    // class region
+
+}                                       // namespace ovision
+
+#endif // !_region_hpp_
+
+// region.hpp ends here
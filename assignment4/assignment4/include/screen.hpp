@@ -44,37 +44,103 @@
 #ifndef _screen_hpp_
 #define _screen_hpp_
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <Windows.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <functional>
+
+#include "compiler.hpp"
+
+#if defined(OVISION_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <Windows.h>
+#elif defined(OVISION_POSIX)
+# include <termios.h>
+#endif
 
 #include "drawbuffer.hpp"
+#include "shadow.hpp"
 
 namespace ovision
 {
 
   /**
    * @brief Screen handling singleton class.
+   *
+   * The Win32 back end lives in screen.cpp and drives the console
+   * through its own screen buffer.  The POSIX back end lives in
+   * screen_vt.cpp and drives a VT-compatible terminal with escape
+   * sequences.  The headless back end lives in screen_headless.cpp
+   * and presents frames to memory, for benchmarks and tests.
    */
   class screen
   {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @typedef resize_callback_t
+     * @brief A callback function with the signature
+     *        @c void @c function_name @c (const @c screen_size @c &)
+     *        called whenever the screen geometry changes.
+     *
+     * @typedef resize_token_t
+     * @brief Identifies a resize callback so that it can be removed.
+     *
+     * @typedef resize_callback_vector
+     * @brief A vector of resize callback functions and their tokens.
+     */
+    typedef std::function<void(const screen_size &)> resize_callback_t;
+    typedef std::size_t                              resize_token_t;
+    typedef std::vector<std::pair<resize_token_t, resize_callback_t> >
+                                                     resize_callback_vector;
+
     
     // Private member fields.
    private:
     
     bool mInitialised;                  //!< Initialised?
 
+#if defined(OVISION_WIN32)
     HANDLE mHInput;                     //!< Console input handle.
     HANDLE mHOutput;                    //!< Console output handle
     HANDLE mHStdOut;                    //!< Console standard output handle.
 
     DWORD         mSavedConsoleMode;    //!< Saved console mode.
-    screen_size   mSavedScreenSize;     //!< Saved console size.
-    screen_point  mSavedCursorPos;      //!< Saved cursor position
     CHAR_INFO    *mOutputBufferCI;      //!< Character/attribute buffer.
     std::size_t   mBufferCapacity;      //!< Buffer capacity.
+    screen_size   mGeometry;            //!< Cached screen buffer size.
+#elif defined(OVISION_POSIX)
+    int            mInputFd;            //!< Terminal input descriptor.
+    int            mOutputFd;           //!< Terminal output descriptor.
+    struct termios mSavedTermios;       //!< Saved terminal attributes.
+    bool           mRawMode;            //!< Is the terminal in raw mode?
+    bool           mAltScreen;          //!< On the alternate screen?
+    screen_size    mSize;               //!< Size the application asked for.
+    screen_size    mTermSize;           //!< Size of the terminal window.
+    mutable screen_point mCursorPos;    //!< Last cursor position set.
+    std::string    mFrame;              //!< Frame output buffer.
+    std::vector<std::string> mStyleSgr; //!< SGR sequences by style ID.
+#else
+    screen_size    mSize;               //!< Size of the in-memory screen.
+    mutable astring mSurface;           //!< What the screen shows.
+    mutable screen_point mCursorPos;    //!< Last cursor position set.
+    string_t       mTitle;              //!< Current window title.
+    std::size_t    mCaptureLimit;       //!< Most frames to capture.
+    std::vector<astring> mCaptured;     //!< Captured frames.
+#endif
+
+    screen_size   mSavedScreenSize;     //!< Saved console size.
+    screen_point  mSavedCursorPos;      //!< Saved cursor position
     bool          mCursorDisabled;      //!< Cursor disabled?
     string_t      mOldTitle;            //!< Old console title.
+    mutable shadow_buffer mShadow;      //!< Last presented frame.
+
+    resize_callback_vector mResizeCallbacks; //!< Called on resize.
+    resize_token_t mLastResizeToken;    //!< Last token handed out.
+    std::size_t   mGeometryQueries;     //!< Geometry system calls made.
 
     
     // Public static member functions.
@@ -82,7 +148,9 @@ namespace ovision
 
     static screen &get_instance();
 
+#if defined(OVISION_WIN32)
     static BOOL WINAPI call_console_event_handler(DWORD dwCtrlType);
+#endif
 
 
     // Public member functions.
@@ -103,6 +171,12 @@ namespace ovision
     screen_size get_size() const;
     void        set_size(const screen_size &extent);
 
+    // Geometry change functions.
+    resize_token_t add_resize_callback(resize_callback_t fn);
+    void           remove_resize_callback(resize_token_t token);
+    std::size_t get_geometry_queries() const;
+    void        reset_geometry_queries();
+
     // Cursor functions.
     screen_point get_cursor_pos() const;
     void         set_cursor_pos(const screen_point &position) const;
@@ -119,14 +193,32 @@ namespace ovision
     astring get_characters(const screen_point &pos, std::size_t count);
     void    set_character(const screen_point &pos, achar value);
 
-    // Rendering function.
-    void render_buffer(draw_buffer &buffer);
+    // Rendering functions.
+    void                 render_buffer(draw_buffer &buffer);
+    void                 invalidate_buffer();
+    const present_stats &get_present_stats() const;
+    void                 reset_present_stats();
+
+#if defined(OVISION_HEADLESS)
+    // Frame capture functions.
+    const astring              &get_surface() const;
+    const string_t             &get_title() const;
+    void                        capture_frames(std::size_t limit);
+    const std::vector<astring> &get_captured_frames() const;
+    void                        clear_captured_frames();
+#endif
 
     // Accessor functions.
+#if defined(OVISION_WIN32)
     HANDLE input_handle();
+    void   buffer_resized(const screen_size &extent);
 
     // Windows callback function.
     BOOL WINAPI console_event_handler(DWORD dwCtrlType);
+#else
+    int  input_handle();
+    bool poll_resize();
+#endif
 
     
     // Private member functions.
@@ -140,7 +232,19 @@ namespace ovision
     void operator = (const screen &);
 
     // Utility functions.
+    void notify_resize();
+
+#if defined(OVISION_WIN32)
     void ensure_capacity(std::size_t count);
+    BOOL query_geometry(CONSOLE_SCREEN_BUFFER_INFO *info);
+#elif defined(OVISION_POSIX)
+    void write_out(const char *data, std::size_t count) const;
+    void write_out(const std::string &data) const;
+    void append_attribute(std::string &out, unsigned long attr);
+    void enter_raw_mode();
+    void leave_raw_mode();
+    void query_terminal_size();
+#endif
 
   };                                    // class screen
 
@@ -0,0 +1,131 @@
+//
+// shadow.hpp --- Shadow frame buffer.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 13:42:51 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 13:42:51
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file shadow.hpp
+ * @author Paul Ward
+ * @brief Shadow frame buffer.
+ */
+
+#pragma once
+#ifndef _shadow_hpp_
+#define _shadow_hpp_
+
+#include <cstddef>
+#include <vector>
+
+#include "char.hpp"
+#include "cells.hpp"
+#include "point.hpp"
+#include "size.hpp"
+
+namespace ovision
+{
+
+  class draw_buffer;
+
+  /**
+   * @brief A run of changed cells on a single row.
+   *
+   * The span covers the half-open column range [left, right).
+   */
+  typedef struct {
+    std::size_t row;                    //!< Row the span lives on.
+    std::size_t left;                   //!< First changed column.
+    std::size_t right;                  //!< One past the last changed column.
+  } dirty_span;
+
+  /**
+   * @brief Presentation counters.
+   *
+   * These are kept by the screen so that we can see how much of each
+   * frame actually has to be pushed to the console.
+   */
+  typedef struct {
+    std::size_t presents;               //!< Number of frames presented.
+    std::size_t cells_compared;         //!< Cells compared to the shadow.
+    std::size_t cells_changed;          //!< Cells that differed.
+    std::size_t cells_written;          //!< Cells written to the console.
+    std::size_t writes;                 //!< Console write calls made.
+  } present_stats;
+
+  /**
+   * @brief Shadow frame buffer class.
+   *
+   * The shadow buffer holds a copy of the last frame that was
+   * presented to the console.  New frames are compared against it,
+   * and only the row spans that differ are reported back to the
+   * presenter.
+   */
+  class shadow_buffer
+  {
+
+    // Protected member fields.
+  protected:
+
+    screen_size             mSize;      //!< Shadow size.
+    cell_buffer             mCells;     //!< Last presented frame.
+    bool                    mValid;     //!< Does the shadow match the console?
+    std::vector<dirty_span> mSpans;     //!< Spans from the last diff.
+    present_stats           mStats;     //!< Presentation counters.
+
+
+    // Public member functions.
+  public:
+
+    // Constructor function.
+    shadow_buffer();
+
+    // Shadow functions.
+    void  invalidate();
+    bool  valid() const;
+    achar get(const screen_point &pos) const;
+
+    // Diff functions.
+    const std::vector<dirty_span> &diff(draw_buffer &buffer);
+
+    // Statistics functions.
+    const present_stats &stats() const;
+    void                 reset_stats();
+    void                 record_write(std::size_t cells);
+
+  };                                    // class shadow_buffer
+
+}                                       // namespace ovision
+
+#endif // !_shadow_hpp_
+
+// shadow.hpp ends here
@@ -202,6 +202,15 @@ namespace ovision
     typedef typename std::remove_reference<_Ty>::type _TyX;
 
     
+    // Inherited data members.
+  public:
+
+    // Without these, unqualified lookup does not see into the
+    // dependent base.
+    using _MyBase::width;
+    using _MyBase::height;
+
+
     // Public member functions.
   public:
 
@@ -212,6 +221,14 @@ namespace ovision
       : _MyBase()
     {}
 
+    /**
+     * @brief Copy constructor function.
+     * @param _Right The object to copy from.
+     */
+    basic_size(const basic_size &_Right)
+      : _MyBase(_Right)
+    {}
+
     /**
      * @brief Constructor function
      * @param _Width The initial width.
@@ -227,7 +244,7 @@ namespace ovision
      * @param _Right The other object.
      */
     template <class _Other>
-    basic_size(basic_size<_Other> &_Right)
+    basic_size(const basic_size<_Other> &_Right)
       : _MyBase(_Right.width, _Right.height)
     {}
 
@@ -695,9 +712,9 @@ namespace ovision
     basic_point<_PT>
     operator + (basic_point<_PT> &_Left, const _MyType &_Right)
     {
-      return _MyBase(_Left.x + __CAST(basic_point<_PT>::value_type,
+      return _MyBase(_Left.x + __CAST(typename basic_point<_PT>::value_type,
                                       _Right.width),
-                     _Left.y + __CAST(basic_point<_PT>::value_type,
+                     _Left.y + __CAST(typename basic_point<_PT>::value_type,
                                       _Right.height));
     }
 
@@ -714,9 +731,9 @@ namespace ovision
     basic_point<_PT>
     operator - (basic_point<_PT> &_Left, const _MyType &_Right)
     {
-      return _MyBase(_Left.x - __CAST(basic_point<_PT>::value_type,
+      return _MyBase(_Left.x - __CAST(typename basic_point<_PT>::value_type,
                                       _Right.width),
-                     _Left.y - __CAST(basic_point<_PT>::value_type,
+                     _Left.y - __CAST(typename basic_point<_PT>::value_type,
                                       _Right.height));
     }
 
@@ -733,9 +750,9 @@ namespace ovision
     basic_point<_PT>
     operator * (basic_point<_PT> &_Left, const _MyType &_Right)
     {
-      return _MyBase(_Left.x * __CAST(basic_point<_PT>::value_type,
+      return _MyBase(_Left.x * __CAST(typename basic_point<_PT>::value_type,
                                       _Right.width),
-                     _Left.y * __CAST(basic_point<_PT>::value_type,
+                     _Left.y * __CAST(typename basic_point<_PT>::value_type,
                                       _Right.height));
     }
 
@@ -752,9 +769,9 @@ namespace ovision
     basic_point<_PT>
     operator / (basic_point<_PT> &_Left, const _MyType &_Right)
     {
-      return _MyBase(_Left.x / __CAST(basic_point<_PT>::value_type,
+      return _MyBase(_Left.x / __CAST(typename basic_point<_PT>::value_type,
                                       _Right.width),
-                     _Left.y / __CAST(basic_point<_PT>::value_type,
+                     _Left.y / __CAST(typename basic_point<_PT>::value_type,
                                       _Right.height));
     }
 
@@ -0,0 +1,327 @@
+//
+// staticpic.hpp --- Compile-time picture maps.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 19:19:40 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 19:19:40
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file staticpic.hpp
+ * @author Paul Ward
+ * @brief Compile-time picture maps.
+ */
+
+#pragma once
+#ifndef _staticpic_hpp_
+#define _staticpic_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "compiler.hpp"
+#include "types.hpp"
+#include "char.hpp"
+#include "picpack.hpp"
+
+/**
+ * @def OVISION_GLYPH
+ * @brief Pick a glyph for the character set we are built for.
+ * @param __u The glyph as a Unicode code point.
+ * @param __a The glyph in the OEM code page, for ASCII builds.
+ */
+#if defined(OVISION_UNICODE)
+# define OVISION_GLYPH(__u, __a) (__u)
+#else
+# define OVISION_GLYPH(__u, __a) (__a)
+#endif
+
+namespace ovision
+{
+
+  /**
+   * @brief Attributes as plain words.
+   *
+   * These are the attribute flags from char.hpp, but as integers
+   * rather than bit sets, so that they can be used in constant
+   * expressions.
+   */
+  namespace words
+  {
+
+    const std::uint16_t fg_intense = FOREGROUND_INTENSITY;
+    const std::uint16_t fg_red     = FOREGROUND_RED;
+    const std::uint16_t fg_blue    = FOREGROUND_BLUE;
+    const std::uint16_t fg_green   = FOREGROUND_GREEN;
+    const std::uint16_t fg_magenta = fg_red  | fg_blue;
+    const std::uint16_t fg_yellow  = fg_red  | fg_green;
+    const std::uint16_t fg_cyan    = fg_blue | fg_green;
+    const std::uint16_t fg_grey    = fg_red  | fg_blue | fg_green;
+    const std::uint16_t fg_black   = 0;
+    const std::uint16_t fg_white   = fg_grey | fg_intense;
+
+    const std::uint16_t bg_intense = BACKGROUND_INTENSITY;
+    const std::uint16_t bg_red     = BACKGROUND_RED;
+    const std::uint16_t bg_blue    = BACKGROUND_BLUE;
+    const std::uint16_t bg_green   = BACKGROUND_GREEN;
+    const std::uint16_t bg_magenta = bg_red  | bg_blue;
+    const std::uint16_t bg_yellow  = bg_red  | bg_green;
+    const std::uint16_t bg_cyan    = bg_blue | bg_green;
+    const std::uint16_t bg_grey    = bg_red  | bg_blue | bg_green;
+    const std::uint16_t bg_black   = 0;
+    const std::uint16_t bg_white   = bg_grey | bg_intense;
+
+  }                                     // namespace words
+
+
+  // =================================================================
+
+
+  /**
+   * @brief What a character in a drawing stands for.
+   */
+  struct legend_entry
+  {
+    char          key;                  //!< Character in the drawing.
+    std::uint16_t glyph;                //!< Glyph it stands for.
+    std::uint16_t attribute;            //!< Attribute of the glyph.
+  };
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A picture map fixed at compile time.
+   * @tparam _Width The picture width.
+   * @tparam _Height The picture height.
+   *
+   * The cells are kept as two planes of 16-bit words, just like a
+   * picture in a pack, so a static picture can be drawn through a
+   * @c picpack_image without being copied.  Where the compiler
+   * allows it, static pictures are built by the compiler and live
+   * in read-only data.
+   *
+   * Each picture also carries a transparency mask in the same form
+   * as @c picmap, one bit per cell set where the cell is opaque.
+   */
+  template <std::size_t _Width, std::size_t _Height>
+  struct static_picmap
+  {
+
+    // Public constants.
+  public:
+
+    static const std::size_t width  = _Width;            //!< Width.
+    static const std::size_t height = _Height;           //!< Height.
+    static const std::size_t cells  = _Width * _Height;  //!< Cell count.
+    static const std::size_t masks  = (cells + 63) / 64; //!< Mask words.
+
+
+    // Public member fields.
+  public:
+
+    std::uint16_t characters[cells];    //!< Character plane.
+    std::uint16_t attributes[cells];    //!< Attribute plane.
+    std::uint64_t opaque[masks];        //!< Transparency mask.
+
+
+    // Public member functions.
+  public:
+
+    /**
+     * @brief Return a view of the picture.
+     * @param name The name to give the view.
+     */
+    picpack_image
+    image(const char *name = "") const
+    {
+      picpack_image view;
+
+      view.name       = name;
+      view.size       = screen_size(_Width, _Height);
+      view.characters = characters;
+      view.attributes = attributes;
+      view.mask       = opaque;
+
+      return view;
+    }
+
+  };                                    // struct static_picmap
+
+
+  // =================================================================
+
+
+  /**
+   * @brief Look up a drawing character in a legend.
+   * @param legend The legend.
+   * @param key The drawing character.
+   *
+   * A character that is not in the legend throws, which stops the
+   * picture being built at compile time, and so is a compile error.
+   */
+  template <std::size_t _Keys>
+  OVISION_CONSTEXPR
+  const legend_entry &
+  find_legend(const legend_entry (&legend)[_Keys], char key)
+  {
+    for (std::size_t i = 0; i < _Keys; ++i) {
+      if (legend[i].key == key) {
+        return legend[i];
+      }
+    }
+
+    throw std::invalid_argument("Drawing character is not in the legend.");
+  }
+
+  /**
+   * @brief Build a picture from a drawing.
+   * @tparam _Width The picture width.
+   * @tparam _Height The picture height.
+   * @param drawing The drawing, one row per line, with every row
+   *                ending in a newline.
+   * @param legend What each character in the drawing stands for.
+   *
+   * A space in the drawing is a transparent cell, and needs no
+   * legend entry.  A drawing of the wrong size fails a static
+   * assertion.  A row of the wrong width, or a character missing
+   * from the legend, stops the picture being built at compile time.
+   */
+  template <std::size_t _Width,
+            std::size_t _Height,
+            std::size_t _Length,
+            std::size_t _Keys>
+  OVISION_CONSTEXPR
+  static_picmap<_Width, _Height>
+  make_static_picmap(const char         (&drawing)[_Length],
+                     const legend_entry (&legend)[_Keys])
+  {
+    static_assert(_Length == (_Width + 1) * _Height + 1,
+                  "The drawing does not match the picture size.");
+
+    static_picmap<_Width, _Height> result = {};
+
+    for (std::size_t y = 0; y < _Height; ++y) {
+      const char *row = drawing + y * (_Width + 1);
+
+      if (row[_Width] != '\n') {
+        throw std::invalid_argument("Drawing row has the wrong width.");
+      }
+
+      for (std::size_t x = 0; x < _Width; ++x) {
+        std::size_t cell = y * _Width + x;
+
+        if (row[x] == ' ') {
+          continue;
+        }
+
+        const legend_entry &entry = find_legend(legend, row[x]);
+
+        result.characters[cell]    = entry.glyph;
+        result.attributes[cell]    = entry.attribute;
+        result.opaque[cell / 64]  |= std::uint64_t(1) << (cell % 64);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Draw one static picture over another.
+   * @tparam _Left The column the sprite is drawn at.
+   * @tparam _Top The row the sprite is drawn at.
+   * @param base The picture to draw on.
+   * @param sprite The picture to draw.
+   * @param lines The number of rows of @c sprite to leave out.
+   * @param from_top @c true to draw the sprite from its top, leaving
+   *                 out rows at the bottom, or @c false to leave out
+   *                 rows at the top.
+   * @returns The composed picture.
+   *
+   * This works like @c pic_generator::limited_overlay, but a sprite
+   * that does not fit on the picture fails a static assertion rather
+   * than being clipped.  Only the opaque cells of the sprite are
+   * drawn, and they become opaque in the result.
+   */
+  template <std::size_t _Left,
+            std::size_t _Top,
+            std::size_t _Width,
+            std::size_t _Height,
+            std::size_t _SpriteWidth,
+            std::size_t _SpriteHeight>
+  OVISION_CONSTEXPR
+  static_picmap<_Width, _Height>
+  static_overlay(const static_picmap<_Width, _Height>             &base,
+                 const static_picmap<_SpriteWidth, _SpriteHeight> &sprite,
+                 std::size_t lines    = 0,
+                 bool        from_top = false)
+  {
+    static_assert(_Left + _SpriteWidth  <= _Width &&
+                  _Top  + _SpriteHeight <= _Height,
+                  "The sprite does not fit on the picture.");
+
+    static_picmap<_Width, _Height> result = base;
+    std::size_t first = from_top ? 0 : lines;
+    std::size_t last  = _SpriteHeight;
+
+    if (lines >= _SpriteHeight) {
+      return result;
+    }
+
+    if (from_top) {
+      last -= lines;
+    }
+
+    for (std::size_t y = first; y < last; ++y) {
+      for (std::size_t x = 0; x < _SpriteWidth; ++x) {
+        std::size_t from = y * _SpriteWidth + x;
+        std::size_t to   = (y + _Top) * _Width + (x + _Left);
+
+        if (((sprite.opaque[from / 64] >> (from % 64)) & 1) == 0) {
+          continue;
+        }
+
+        result.characters[to]    = sprite.characters[from];
+        result.attributes[to]    = sprite.attributes[from];
+        result.opaque[to / 64]  |= std::uint64_t(1) << (to % 64);
+      }
+    }
+
+    return result;
+  }
+
+}                                       // namespace ovision
+
+#endif // !_staticpic_hpp_
+
+// staticpic.hpp ends here
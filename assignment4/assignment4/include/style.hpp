@@ -0,0 +1,268 @@
+//
+// style.hpp --- Extended character styles.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 14:00:26 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 14:00:26
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file style.hpp
+ * @author Paul Ward
+ * @brief Extended character styles.
+ */
+
+#pragma once
+#ifndef _style_hpp_
+#define _style_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "compiler.hpp"
+#include "types.hpp"
+
+namespace ovision
+{
+
+  /**
+   * @brief A foreground or background colour.
+   *
+   * Colours can be the terminal's default, one of the 16 classic
+   * colours, one of the 256 indexed colours, or 24-bit RGB.  The
+   * 16 and 256 colour indices are in ANSI order, so red is 1.
+   */
+  struct colour
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @brief Kinds of colour.
+     */
+    typedef enum {
+      colour_default = 0,               //!< The terminal's own colour.
+      colour_16,                        //!< One of the classic colours.
+      colour_256,                       //!< An indexed colour.
+      colour_rgb                        //!< A 24-bit colour.
+    } kind_t;
+
+
+    // Public member fields.
+  public:
+
+    std::uint8_t  kind;                 //!< Kind of colour.
+    std::uint32_t value;                //!< Index, or 0xRRGGBB.
+
+
+    // Public static member functions.
+  public:
+
+    static colour none();
+    static colour ansi(unsigned index);
+    static colour indexed(unsigned index);
+    static colour rgb(unsigned red, unsigned green, unsigned blue);
+
+
+    // Public member functions.
+  public:
+
+    std::uint32_t to_rgb(bool foreground) const;
+    unsigned      nearest_ansi(bool foreground) const;
+
+  };                                    // struct colour
+
+  bool operator == (const colour &lhs, const colour &rhs);
+  bool operator <  (const colour &lhs, const colour &rhs);
+
+
+  // =================================================================
+
+
+  /**
+   * @brief A full description of how a character looks.
+   */
+  struct style
+  {
+
+    // Public type definitions.
+  public:
+
+    /**
+     * @brief Style flags.
+     */
+    typedef enum {
+      style_bold      = 0x01,           //!< Bold.
+      style_italic    = 0x02,           //!< Italic.
+      style_underline = 0x04,           //!< Underlined.
+      style_reverse   = 0x08            //!< Reverse video.
+    } flag_t;
+
+
+    // Public member fields.
+  public:
+
+    colour        foreground;           //!< Foreground colour.
+    colour        background;           //!< Background colour.
+    std::uint16_t flags;                //!< Style flags.
+
+
+    // Public static member functions.
+  public:
+
+    static style from_attribute(std::uint16_t word);
+
+
+    // Public member functions.
+  public:
+
+    // Constructor functions.
+    style();
+    style(const colour &fg, const colour &bg, std::uint16_t styleFlags = 0);
+
+    // Conversion functions.
+    bool          is_classic() const;
+    std::uint16_t to_attribute() const;
+    void          append_sgr(std::string &out) const;
+
+  };                                    // struct style
+
+  bool operator == (const style &lhs, const style &rhs);
+  bool operator <  (const style &lhs, const style &rhs);
+
+
+  // =================================================================
+
+
+  /**
+   * @brief Table of interned styles.
+   *
+   * Cells keep a 16-bit attribute word, and a full style is far too
+   * big to keep in every cell.  Instead each distinct style is given
+   * a small ID the first time it is seen, and the cell keeps the ID.
+   * The presenter looks IDs up when it needs the full style.
+   *
+   * IDs have @c interned_bit set, and use none of the bits the
+   * classic attributes use, so classic attributes and IDs can be
+   * told apart in any cell.  Styles that classic attributes can
+   * already describe are returned as classic attributes and never
+   * take up an ID.
+   *
+   * The Win32 console cannot show anything but the classic colours,
+   * so there a style is folded into the nearest classic attribute
+   * when it is interned, and cells never hold IDs.
+   */
+  class style_table
+  {
+
+    // Public constants.
+  public:
+
+    /**
+     * @brief The bit that marks an attribute word as an ID.
+     */
+    static const std::uint16_t interned_bit = 0x2000;
+
+    /**
+     * @brief The most styles the table will hold.
+     */
+    static const std::size_t max_styles = 0x2000;
+
+
+    // Private type definitions.
+  private:
+
+    /**
+     * @typedef style_map
+     * @brief A map of styles to their IDs.
+     */
+    typedef std::map<style, std::uint16_t> style_map;
+
+
+    // Private member fields.
+  private:
+
+    std::vector<style> mStyles;         //!< Styles, by ID.
+    style_map          mIndex;          //!< IDs, by style.
+
+
+    // Public static functions.
+  public:
+
+    static style_table &get_instance();
+
+    /**
+     * @brief Is an attribute word an interned style ID?
+     * @param word The attribute word.
+     */
+    static
+    bool
+    is_interned(std::uint16_t word)
+    {
+#if defined(OVISION_WIN32)
+      return false;
+#else
+      return (word & interned_bit) != 0;
+#endif
+    }
+
+
+    // Public member functions.
+  public:
+
+    std::uint16_t intern(const style &s);
+    style         resolve(std::uint16_t word) const;
+    std::size_t   size() const;
+
+  };                                    // class style_table
+
+  /**
+   * @brief Return the attribute for a style.
+   * @param s The style.
+   *
+   * Interned attributes are IDs rather than bits, so they must not
+   * be combined with classic attributes using @c |.
+   */
+  inline
+  attr_t
+  style_attribute(const style &s)
+  {
+    return attr_t(style_table::get_instance().intern(s));
+  }
+
+}                                       // namespace ovision
+
+#endif // !_style_hpp_
+
+// style.hpp ends here
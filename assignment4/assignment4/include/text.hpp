@@ -44,6 +44,8 @@
 #ifndef _text_hpp_
 #define _text_hpp_
 
+#include <vector>
+
 #include "char.hpp"
 #include "view.hpp"
 
@@ -67,12 +69,33 @@ namespace ovision
     : public view
   {
 
+    // Public type definitions.
+  public:
+
+    /**
+     * @brief A line of laid out text.
+     */
+    struct text_line {
+      std::size_t start;                //!< Offset of the first character.
+      std::size_t length;               //!< Number of characters.
+      std::size_t offset;               //!< Column the line is drawn at.
+    };
+
+    /**
+     * @typedef line_vector
+     * @brief A vector of laid out lines.
+     */
+    typedef std::vector<text_line> line_vector;
+
+
     // Public protected fields.
   protected:
 
-    astring     mContents;              //!< String contents.
+    run_string  mContents;              //!< String contents.
     std::size_t mWidth;                 //!< View width.
     text_align  mAlignment;             //!< Text alignment.
+    bool        mWordWrap;              //!< Wrap words to the width?
+    line_vector mLines;                 //!< Cached layout.
 
 
     // Public member functions.
@@ -81,20 +104,20 @@ namespace ovision
     // Constructor functions.
     text();
 
-    text(const string_t &content,
-         screen_point   &location,
-         std::size_t     width,
-         attr_t          attr);
+    text(const string_t     &content,
+         const screen_point &location,
+         std::size_t         width,
+         attr_t              attr);
     
-    text(const string_t &content,
-         screen_point   &location,
-         std::size_t     width,
-         text_align      alignment,
-         attr_t          attr);
+    text(const string_t     &content,
+         const screen_point &location,
+         std::size_t         width,
+         text_align          alignment,
+         attr_t              attr);
     
-    text(const string_t &content,
-         screen_point   &location,
-         attr_t          attr);
+    text(const string_t     &content,
+         const screen_point &location,
+         attr_t              attr);
 
 
     // Attribute functions.
@@ -104,15 +127,28 @@ namespace ovision
     // String functions.
     virtual string_t get_text();
     virtual void     set_text(const string_t &content);
+    virtual void     set_text(const char_t *content);
+    virtual void     set_text(const char_t *content, std::size_t length);
     virtual void     set_text(const astring &content);
     virtual void     append(char_t ch);
-    virtual void     append(achar &ach);
+    virtual void     append(const achar &ach);
     virtual void     append(char_t ch, attr_t attr);
 
     // Alignment functions.
     virtual text_align get_alignment();
     virtual void       set_alignment(const text_align alignment);
 
+    // Layout functions.
+    virtual std::size_t        get_width() const;
+    virtual void               set_width(std::size_t width);
+    virtual bool               get_word_wrap() const;
+    virtual void               set_word_wrap(bool flag);
+    const line_vector         &get_lines() const;
+
+    // Rect functions.
+    rect opaque_rect();
+    void occlude(region &damage);
+
     // Render function.
     void render();
 
@@ -120,11 +156,17 @@ namespace ovision
     // Private member functions.
   private:
 
-    void vs2010_does_not_do_delegated_ctors_hrmph(const string_t &content,
-                                                  screen_point   &location,
-                                                  std::size_t     width,
-                                                  text_align      alignment,
-                                                  attr_t          attr);
+    std::size_t align_offset(std::size_t length) const;
+    void        layout();
+    void        reflow(std::size_t from);
+    void        fit();
+
+    void vs2010_does_not_do_delegated_ctors_hrmph(
+      const string_t     &content,
+      const screen_point &location,
+      std::size_t         width,
+      text_align          alignment,
+      attr_t              attr);
     
   };                                    // class text
 
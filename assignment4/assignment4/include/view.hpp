@@ -46,10 +46,14 @@
 
 #include "rect.hpp"
 #include "types.hpp"
+#include "picmap.hpp"
 
 namespace ovision
 {
 
+  class draw_buffer;
+  class region;
+
   /**
    * @brief Base view class.
    */
@@ -63,6 +67,18 @@ namespace ovision
     attr_t mClientAttr;                 //!< Client attributes
     attr_t mInnerAttr;                  //!< Inner attributes.
     bool   mDrawBorder;                 //!< Draw a border?
+    bool   mInvalid;                    //!< Does the view need redrawing?
+    rect   mDirtyRect;                  //!< Area that needs redrawing.
+    bool   mCached;                     //!< Keep a cached layer?
+    bool   mLayerStale;                 //!< Does the layer need rebuilding?
+    picmap mLayer;                      //!< Cached layer.
+
+
+    // Public static functions.
+  public:
+
+    static draw_buffer &canvas();
+    static void         set_canvas(draw_buffer *target);
 
 
     // Public member functions.
@@ -70,13 +86,16 @@ namespace ovision
 
     // Constructor and destructor functions.
     view();
-    view(rect &area);
-    view(rect &area, attr_t clientAttr, attr_t innerAttr);
+    view(const rect &area);
+    view(const rect &area, attr_t clientAttr, attr_t innerAttr);
     virtual ~view();
 
     // Rect functions.
     virtual rect &client_rect();
     virtual rect &inner_rect();
+    virtual rect  opaque_rect();
+    virtual void  occlude(region &damage);
+    virtual void  move_to(const point &origin);
 
     // Attribute functions.
     virtual attr_t get_inner_attribute();
@@ -88,9 +107,31 @@ namespace ovision
     virtual bool get_draw_border() const;
     virtual void set_draw_border(bool flag);
 
+    // Invalidation functions.
+    void        invalidate();
+    void        invalidate(const rect &area);
+    void        damage(const rect &area);
+    void        validate();
+    bool        is_invalid() const;
+    const rect &dirty_rect() const;
+
+    // Layer functions.
+    bool get_cached() const;
+    void set_cached(bool flag);
+    void paint(const rect &area);
+
     // Render function.
     virtual void render();
 
+    // Notification functions.
+    virtual void resized(const screen_size &extent);
+
+
+    // Protected member functions.
+  protected:
+
+    void render_around(const rect &hole);
+
   };                                    // class view
 
 }                                       // namespace ovision
@@ -0,0 +1,246 @@
+//
+// animation.cpp --- Delta-frame picture animation implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 20:35:32 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 20:35:32
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file animation.cpp
+ * @author Paul Ward
+ * @brief Delta-frame picture animation implementation.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "animation.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Default constructor function.
+ */
+animation::animation()
+{}
+
+/**
+ * @brief Constructor function.
+ * @param keyframe The first frame.
+ */
+animation::animation(const picmap &keyframe)
+{
+  set_keyframe(keyframe);
+}
+
+/**
+ * @brief Start the animation again from a new keyframe.
+ * @param keyframe The first frame.
+ */
+void
+animation::set_keyframe(const picmap &keyframe)
+{
+  clear();
+
+  mKeyframe = keyframe;
+  mLast     = keyframe;
+}
+
+/**
+ * @brief Add a frame to the end of the animation.
+ * @param next The frame, which must be the same size as the
+ *             keyframe.
+ * @throws std::invalid_argument if the frame is the wrong size.
+ *
+ * Only the cells that differ from the last frame are kept.
+ */
+void
+animation::add_frame(const picmap &next)
+{
+  const cell_buffer &from   = mLast.cells();
+  const cell_buffer &to     = next.cells();
+  screen_size        extent = mLast.get_size();
+  frame_info         item;
+  signed             left   = __CAST(signed, extent.width);
+  signed             top    = __CAST(signed, extent.height);
+  signed             right  = 0;
+  signed             bottom = 0;
+
+  if (next.get_size().width  != extent.width ||
+      next.get_size().height != extent.height)
+  {
+    throw std::invalid_argument("animation::add_frame");
+  }
+
+  item.first = mDeltas.size();
+
+  for (std::size_t i = 0; i < to.size(); ++i) {
+    cell_delta delta;
+    signed     x;
+    signed     y;
+
+    if (from.same(i, to)) {
+      continue;
+    }
+
+    delta.offset      = __CAST(std::uint32_t, i);
+    delta.before      = from.character(i);
+    delta.after       = to.character(i);
+    delta.before_attr = from.attribute(i);
+    delta.after_attr  = to.attribute(i);
+
+    mDeltas.push_back(delta);
+
+    x      = __CAST(signed, i % extent.width);
+    y      = __CAST(signed, i / extent.width);
+    left   = std::min(left,   x);
+    top    = std::min(top,    y);
+    right  = std::max(right,  x + 1);
+    bottom = std::max(bottom, y + 1);
+  }
+
+  item.count = mDeltas.size() - item.first;
+
+  if (item.count > 0) {
+    item.bounds = rect(left, top, right - left, bottom - top);
+  }
+
+  mFrames.push_back(item);
+  mLast = next;
+}
+
+/**
+ * @brief Remove every frame, including the keyframe.
+ */
+void
+animation::clear()
+{
+  mKeyframe.clear();
+  mLast.clear();
+  mDeltas.clear();
+  mFrames.clear();
+}
+
+/**
+ * @brief Return the number of frames, counting the keyframe.
+ */
+std::size_t
+animation::size() const
+{
+  return mFrames.size() + 1;
+}
+
+/**
+ * @brief Return the number of deltas kept for every frame.
+ */
+std::size_t
+animation::get_delta_count() const
+{
+  return mDeltas.size();
+}
+
+/**
+ * @brief Return the number of cells that change going to a frame.
+ * @param index The frame, which must not be the keyframe.
+ * @throws std::out_of_range if there is no such frame.
+ */
+std::size_t
+animation::get_delta_count(std::size_t index) const
+{
+  if (index == 0 || index > mFrames.size()) {
+    throw std::out_of_range("animation::get_delta_count");
+  }
+
+  return mFrames[index - 1].count;
+}
+
+/**
+ * @brief Return the keyframe.
+ */
+const picmap &
+animation::get_keyframe() const
+{
+  return mKeyframe;
+}
+
+/**
+ * @brief Move a picture on to the next frame.
+ * @param target The picture, which must show frame @c index.
+ * @param index The frame shown.
+ * @returns The area of the picture that changed.
+ * @throws std::out_of_range if @c index is the last frame.
+ */
+rect
+animation::forward(picmap &target, std::size_t index) const
+{
+  if (index >= mFrames.size()) {
+    throw std::out_of_range("animation::forward");
+  }
+
+  const frame_info &item = mFrames[index];
+
+  for (std::size_t i = item.first; i < item.first + item.count; ++i) {
+    const cell_delta &delta = mDeltas[i];
+
+    target.put(delta.offset, achar(delta.after, attr_t(delta.after_attr)));
+  }
+
+  return item.bounds;
+}
+
+/**
+ * @brief Move a picture back to the frame before.
+ * @param target The picture, which must show frame @c index.
+ * @param index The frame shown.
+ * @returns The area of the picture that changed.
+ * @throws std::out_of_range if @c index is the keyframe.
+ */
+rect
+animation::backward(picmap &target, std::size_t index) const
+{
+  if (index == 0 || index > mFrames.size()) {
+    throw std::out_of_range("animation::backward");
+  }
+
+  const frame_info &item = mFrames[index - 1];
+
+  for (std::size_t i = item.first; i < item.first + item.count; ++i) {
+    const cell_delta &delta = mDeltas[i];
+
+    target.put(delta.offset,
+               achar(delta.before, attr_t(delta.before_attr)));
+  }
+
+  return item.bounds;
+}
+
+// animation.cpp ends here
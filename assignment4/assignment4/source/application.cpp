@@ -39,14 +39,71 @@
  */
  
 #include <algorithm>
+#include <chrono>
 #include <stdexcept>
 
 #include "application.hpp"
+#include "region.hpp"
 #include "screen.hpp"
 #include "keyboard.hpp"
 
 using namespace ovision;
 
+/**
+ * @brief Constructor method.
+ *
+ * The application starts with no idle timeout, so the main loop
+ * sleeps until a key is pressed or the screen is resized.
+ */
+application::application()
+  : mIdleTimeout(-1),
+    mKeyFrames(0),
+    mFrameKeys(0),
+    mMaxFrameKeys(0),
+    mTotalKeys(0),
+    mFrameViews(0),
+    mFrameArea(0),
+    mFrameWrites(0),
+    mFrameOverdraw(0),
+    mRunning(false),
+    mResized(false),
+    mReturnCode(EXIT_SUCCESS)
+{
+  mKey.character = 0;
+
+  frame_arena::set_current(&mArena);
+
+  // Pass screen resizes on to the views, and have the main loop
+  // redraw them.
+  mResizeToken = screen::get_instance().add_resize_callback(
+    [this](const screen_size &extent)
+    {
+      mResized = true;
+
+      for (std::size_t i = 0; i < mViews.size(); ++i) {
+        mViews[i]->resized(extent);
+        mViews[i]->invalidate();
+      }
+    });
+}
+
+/**
+ * @brief Destructor method.
+ *
+ * The screen outlives us, so our resize callback is removed from
+ * it.  If the application's arena is still the current one, the
+ * spare arena takes its place.
+ */
+application::~application()
+{
+  screen::get_instance().remove_resize_callback(mResizeToken);
+
+
+  if (&frame_arena::get_current() == &mArena) {
+    frame_arena::set_current(0);
+  }
+}
+
 /**
  * @brief Add a view instance to the vector of managed views.
  * @param aView The view to manage.
@@ -71,6 +128,220 @@ application::add_key_callback(kbcallback_t fn)
   mKeyCallbacks.push_back(fn);
 }
 
+/**
+ * @brief Add a callback for `idle timeout' events.
+ * @param fn The function to add.
+ * @see idlecallback_t
+ *
+ * The views are redrawn after the idle callbacks have been called,
+ * so this is the place to advance anything that animates.
+ */
+void
+application::add_idle_callback(idlecallback_t fn)
+{
+  mIdleCallbacks.push_back(fn);
+}
+
+/**
+ * @brief Return the idle timeout.
+ * @returns The idle timeout in milliseconds, or a negative value if
+ *          there is none.
+ */
+long
+application::get_idle_timeout() const
+{
+  return mIdleTimeout;
+}
+
+/**
+ * @brief Set the idle timeout.
+ * @param timeout The longest time, in milliseconds, that the main
+ *                loop waits for a key before calling the idle
+ *                callbacks.  A negative value waits forever.
+ *
+ * The timeout is a deadline measured from the last redraw, so
+ * events that carry no key press do not push it back.
+ */
+void
+application::set_idle_timeout(long timeout)
+{
+  mIdleTimeout = timeout;
+}
+
+/**
+ * @brief Return the number of frames drawn after key presses.
+ */
+std::size_t
+application::get_key_frames() const
+{
+  return mKeyFrames;
+}
+
+/**
+ * @brief Return the number of keys handled before the last frame.
+ */
+std::size_t
+application::get_frame_keys() const
+{
+  return mFrameKeys;
+}
+
+/**
+ * @brief Return the most keys handled before any one frame.
+ */
+std::size_t
+application::get_max_frame_keys() const
+{
+  return mMaxFrameKeys;
+}
+
+/**
+ * @brief Return the number of keys handled in all frames.
+ *
+ * Dividing this by @c get_key_frames gives the average number of
+ * keys coalesced into each frame.
+ */
+std::size_t
+application::get_total_keys() const
+{
+  return mTotalKeys;
+}
+
+/**
+ * @brief Reset the typeahead statistics.
+ */
+void
+application::reset_key_stats()
+{
+  mKeyFrames    = 0;
+  mFrameKeys    = 0;
+  mMaxFrameKeys = 0;
+  mTotalKeys    = 0;
+}
+
+/**
+ * @brief Return the number of views drawn in the last frame.
+ *
+ * A view is counted once however many damaged areas it overlaps.
+ */
+std::size_t
+application::get_frame_views() const
+{
+  return mFrameViews;
+}
+
+/**
+ * @brief Return the number of cells redrawn in the last frame.
+ */
+std::size_t
+application::get_frame_area() const
+{
+  return mFrameArea;
+}
+
+/**
+ * @brief Return the number of cell writes in the last frame.
+ *
+ * With every cell painted once this never exceeds the frame area.
+ */
+std::size_t
+application::get_frame_writes() const
+{
+  return mFrameWrites;
+}
+
+/**
+ * @brief Return the number of cells painted over in the last frame.
+ * @see draw_buffer::get_overdraw
+ */
+std::size_t
+application::get_frame_overdraw() const
+{
+  return mFrameOverdraw;
+}
+
+/**
+ * @brief Return the arena for per-frame temporaries.
+ *
+ * The arena is emptied after every frame is presented, so anything
+ * taken from it must not be kept beyond the key or idle callback
+ * that made it.
+ */
+frame_arena &
+application::get_frame_arena()
+{
+  return mArena;
+}
+
+/**
+ * @brief Redraw the parts of the screen that have changed.
+ * @returns @c true if anything was drawn; otherwise @c false is
+ *          returned.
+ *
+ * The dirty rectangles of the invalidated views are gathered into a
+ * damaged region.  Working down from the topmost view, each view is
+ * given the part of the damage inside its client rect, and then its
+ * opaque area is taken out of the damage left for the views below.
+ * Each view is then painted into its own part, so every damaged cell
+ * is written by exactly one view.  Views that get no part of the
+ * damage are not drawn at all, and cached views copy their layer
+ * rather than rendering again.
+ *
+ * The regions are members so that their storage is kept from frame
+ * to frame.
+ */
+bool
+application::render_views()
+{
+  region &damage = mDamage;
+
+  damage.clear();
+  mParts.resize(mViews.size());
+
+  for (std::size_t i = 0; i < mViews.size(); ++i) {
+    if (mViews[i]->is_invalid()) {
+      damage.add(mViews[i]->dirty_rect());
+    }
+
+    mViews[i]->validate();
+  }
+
+  mFrameViews = 0;
+  mFrameArea  = damage.area();
+
+  if (damage.empty()) {
+    return false;
+  }
+
+  // Hand out the damage from the top down.
+  for (std::size_t i = mViews.size(); i-- > 0; ) {
+    mParts[i] = damage;
+    mParts[i].intersect(mViews[i]->client_rect());
+
+    mViews[i]->occlude(damage);
+  }
+
+  // Draw from the bottom up.
+  GlobalDrawBuffer.reset_cell_writes();
+
+  for (std::size_t i = 0; i < mViews.size(); ++i) {
+    for (std::size_t r = 0; r < mParts[i].size(); ++r) {
+      mViews[i]->paint(mParts[i][r]);
+    }
+
+    if (!mParts[i].empty()) {
+      ++mFrameViews;
+    }
+  }
+
+  GlobalDrawBuffer.reset_clip();
+
+  mFrameWrites   = GlobalDrawBuffer.get_cell_writes();
+  mFrameOverdraw = GlobalDrawBuffer.get_overdraw();
+
+  return true;
+}
+
 /**
  * @brief Return the current screen size.
  */
@@ -94,7 +365,7 @@ application::get_cursor_position()
  * @param position The screen point the cursor is to be placed.
  */
 void
-application::set_cursor_position(screen_point &position)
+application::set_cursor_position(const screen_point &position)
 {
   screen::get_instance().set_cursor_pos(position);
 }
@@ -147,9 +418,12 @@ application::set_screen_size(const screen_size &extent)
 int
 application::start()
 {
-  extern draw_buffer GlobalDrawBuffer;
+  typedef std::chrono::steady_clock clock;
+
+  clock::time_point deadline;
 
   mRunning    = true;
+  mResized    = false;
   mReturnCode = EXIT_SUCCESS;
   
   keyboard::get_instance().clear();
@@ -158,7 +432,7 @@ application::start()
   try {
     if (screen::get_instance().init() == false) {
       screen::get_instance().shutdown();
-      std::cerr << "Could not initialise the Windows console." << std::endl;
+      std::cerr << "Could not initialise the console." << std::endl;
       exit(EXIT_FAILURE);
     }
 
@@ -166,26 +440,78 @@ application::start()
     GlobalDrawBuffer.clear();
 
     while (mRunning) {
-      for (std::size_t i = 0; i < mViews.size(); ++i) {
-        mViews[i]->render();
+      if (render_views()) {
+        GlobalDrawBuffer.dump();
       }
 
-      GlobalDrawBuffer.dump();
+      // Nothing allocated for the frame is needed once it is up.
+      mArena.reset();
 
-      while (mKey.character == 0) {
-        mLastKey = mKey;
-        mKey     = keyboard::get_instance().get_keyboard_event();
+      mResized = false;
+
+      // Sleep until there is input, the screen is resized, or the
+      // idle deadline passes.
+      deadline = clock::now() + std::chrono::milliseconds(mIdleTimeout);
+
+      while (mKey.character == 0 && !mResized) {
+        long remaining = -1;
+
+        if (mIdleTimeout >= 0) {
+          remaining = __CAST(long,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+              deadline - clock::now()).count());
+          remaining = std::max(remaining, 0L);
+        }
+
+        if (!keyboard::get_instance().wait(remaining)) {
+          for (std::size_t fn = 0; fn < mIdleCallbacks.size(); ++fn) {
+            mIdleCallbacks[fn]();
+          }
+
+          break;
+        }
+
+        if (!mResized) {
+          mLastKey = mKey;
+          mKey     = keyboard::get_instance().get_keyboard_event();
+        }
       }
 
-      if (mKey.character == 3) {
-        goto terminate_application;
+      if (mKey.character == 0) {
+        continue;                       // Resized or idle, so redraw.
       }
 
-      for (std::size_t fn = 0; fn < mKeyCallbacks.size(); ++fn) {
-        mKeyCallbacks[fn](mKey.character);
+      // Handle this key and any others already waiting, so that
+      // typeahead and pasted input are drawn once rather than once
+      // per key.
+      mFrameKeys = 0;
+
+      for (;;) {
+        if (mKey.character == 3) {
+          goto terminate_application;
+        }
+
+        if (mKey.character != 0) {
+          for (std::size_t fn = 0; fn < mKeyCallbacks.size(); ++fn) {
+            mKeyCallbacks[fn](mKey.character);
+          }
+
+          ++mFrameKeys;
+        }
+
+        mKey.character = 0;
+
+        if (!mRunning || mResized || !keyboard::get_instance().kbhit()) {
+          break;
+        }
+
+        mLastKey = mKey;
+        mKey     = keyboard::get_instance().get_keyboard_event();
       }
 
-     mKey.character = 0;
+      ++mKeyFrames;
+      mTotalKeys   += mFrameKeys;
+      mMaxFrameKeys = std::max(mMaxFrameKeys, mFrameKeys);
     }
 
 terminate_application:
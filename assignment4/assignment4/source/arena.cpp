@@ -0,0 +1,278 @@
+//
+// arena.cpp --- Per-frame memory arena implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 15:56:27 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 15:56:27
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file arena.cpp
+ * @author Paul Ward
+ * @brief Per-frame memory arena implementation.
+ */
+
+#include <algorithm>
+
+#include "arena.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief The size of a block, unless an allocation needs more.
+ */
+static const std::size_t DefaultBlockSize = 64 * 1024;
+
+/**
+ * @brief Round a value up to a multiple of an alignment.
+ * @param value The value.
+ * @param align The alignment, which must be a power of two.
+ */
+static inline
+std::size_t
+align_up(std::size_t value, std::size_t align)
+{
+  return (value + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief The arena made current by the running application.
+ */
+static frame_arena *CurrentArena = 0;
+
+/**
+ * @brief Return the current frame arena.
+ *
+ * If no application has made its arena current, a spare one is
+ * returned instead.
+ */
+frame_arena &
+frame_arena::get_current()
+{
+  static frame_arena sSpare;
+
+  return (CurrentArena != 0) ? *CurrentArena : sSpare;
+}
+
+/**
+ * @brief Make an arena the current one.
+ * @param arena The arena, or a null pointer to go back to the
+ *              spare arena.
+ */
+void
+frame_arena::set_current(frame_arena *arena)
+{
+  CurrentArena = arena;
+}
+
+/**
+ * @brief Constructor function.
+ */
+frame_arena::frame_arena()
+  : mBlock(0),
+    mUsed(0),
+    mFrameBytes(0),
+    mHighWater(0),
+    mHeapCalls(0)
+{}
+
+/**
+ * @brief Destructor function.
+ */
+frame_arena::~frame_arena()
+{
+  for (std::size_t i = 0; i < mBlocks.size(); ++i) {
+    delete [] mBlocks[i].data;
+  }
+}
+
+/**
+ * @brief Allocate memory for the rest of the frame.
+ * @param bytes The number of bytes.
+ * @param align The alignment, which must be a power of two.
+ * @returns The memory.
+ */
+void *
+frame_arena::allocate(std::size_t bytes, std::size_t align)
+{
+  std::size_t start = 0;
+
+  for (;;) {
+    if (mBlock < mBlocks.size()) {
+      // Blocks come from new[], so their start is suitably aligned
+      // for anything and aligning the offset is enough.
+      start = align_up(mUsed, align);
+
+      if (start + bytes <= mBlocks[mBlock].size) {
+        break;
+      }
+    }
+
+    next_block(bytes + align);
+  }
+
+  mFrameBytes += (start + bytes) - mUsed;
+  mUsed        = start + bytes;
+
+  return mBlocks[mBlock].data + start;
+}
+
+/**
+ * @brief Give memory back to the arena.
+ * @param ptr The memory.
+ * @param bytes The number of bytes.
+ *
+ * Only the most recent allocation can actually be given back;
+ * anything else waits for the arena to be reset.
+ */
+void
+frame_arena::deallocate(void *ptr, std::size_t bytes)
+{
+  unsigned char *at = __CAST(unsigned char *, ptr);
+
+  if (mBlock < mBlocks.size() &&
+      at + bytes == mBlocks[mBlock].data + mUsed)
+  {
+    mUsed = at - mBlocks[mBlock].data;
+  }
+}
+
+/**
+ * @brief Give back everything allocated since the last reset.
+ *
+ * If the frame needed more than one block, they are replaced with
+ * a single block big enough for all of it, so that the next frame
+ * allocates from one run of memory.
+ */
+void
+frame_arena::reset()
+{
+  mHighWater = std::max(mHighWater, mFrameBytes);
+
+  if (mBlock > 0) {
+    std::size_t total = 0;
+
+    for (std::size_t i = 0; i < mBlocks.size(); ++i) {
+      total += mBlocks[i].size;
+      delete [] mBlocks[i].data;
+    }
+
+    mBlocks.clear();
+    next_block(total);
+  }
+
+  mBlock      = 0;
+  mUsed       = 0;
+  mFrameBytes = 0;
+}
+
+/**
+ * @brief Return the number of bytes handed out this frame.
+ */
+std::size_t
+frame_arena::get_frame_bytes() const
+{
+  return mFrameBytes;
+}
+
+/**
+ * @brief Return the most bytes handed out in any one frame.
+ */
+std::size_t
+frame_arena::get_high_water() const
+{
+  return std::max(mHighWater, mFrameBytes);
+}
+
+/**
+ * @brief Return the number of bytes the arena holds.
+ */
+std::size_t
+frame_arena::get_capacity() const
+{
+  std::size_t total = 0;
+
+  for (std::size_t i = 0; i < mBlocks.size(); ++i) {
+    total += mBlocks[i].size;
+  }
+
+  return total;
+}
+
+/**
+ * @brief Return the number of times the arena has gone to the heap.
+ *
+ * Once the game has settled down this should stop increasing.  The
+ * rest of the game still goes to the heap, but only until it has
+ * settled down too:
+ *
+ * - Before the first key, for its views, the word list, the hangman
+ *   pictures and animation, the letters guessed, the callbacks, and
+ *   the first frame's damage regions and screen diff.
+ * - During the first won and lost games, as text contents, line
+ *   layouts, attribute runs and damage regions grow to fit the
+ *   longest message.  Their storage is kept from then on.
+ *
+ * After that the game makes no heap calls at all, which the game
+ * bench checks.
+ */
+std::size_t
+frame_arena::get_heap_calls() const
+{
+  return mHeapCalls;
+}
+
+/**
+ * @brief Move on to the next block, making one if need be.
+ * @param bytes The smallest size of block that will do.
+ */
+void
+frame_arena::next_block(std::size_t bytes)
+{
+  std::size_t next = mBlocks.empty() ? 0 : mBlock + 1;
+  block       blk;
+
+  mUsed = 0;
+
+  if (next < mBlocks.size() && mBlocks[next].size >= bytes) {
+    mBlock = next;
+    return;
+  }
+
+  blk.size = std::max(bytes, DefaultBlockSize);
+  blk.data = new unsigned char[blk.size];
+
+  mBlocks.insert(mBlocks.begin() + next, blk);
+  mBlock = next;
+
+  ++mHeapCalls;
+}                                       // frame_arena::next_block
+
+// arena.cpp ends here
@@ -0,0 +1,333 @@
+//
+// cells.cpp --- Character cell storage implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 18:38:02 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 18:38:02
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file cells.cpp
+ * @author Paul Ward
+ * @brief Character cell storage implementation.
+ */
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "cells.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Clip a block transfer.
+ * @param extent The size of the buffer being copied to.
+ * @param source_extent The size of the buffer being copied from.
+ * @param from The rectangle of the source buffer to copy.
+ * @param to Where the top-left corner of @c from lands.
+ * @param clip The rectangle of the destination that may be written to.
+ * @param area Set to the part of @c from that is left to copy.
+ * @param dx Set to the column offset from @c area to the destination.
+ * @param dy Set to the row offset from @c area to the destination.
+ * @returns @c true if there is anything left to copy.
+ *
+ * The source rectangle is clipped against the source buffer, and
+ * the destination is clipped against both @c clip and the buffer
+ * being copied to, so any of them may hang off the edge.
+ */
+static
+bool
+clip_transfer(const screen_size &extent,
+              const screen_size &source_extent,
+              const rect        &from,
+              const point       &to,
+              const rect        &clip,
+              rect              &area,
+              signed            &dx,
+              signed            &dy)
+{
+  signed left   = std::max(__CAST(signed, from.left()),   0);
+  signed top    = std::max(__CAST(signed, from.top()),    0);
+  signed right  = std::min(__CAST(signed, from.right()),
+                           __CAST(signed, source_extent.width));
+  signed bottom = std::min(__CAST(signed, from.bottom()),
+                           __CAST(signed, source_extent.height));
+  signed cl     = std::max(__CAST(signed, clip.left()),   0);
+  signed ct     = std::max(__CAST(signed, clip.top()),    0);
+  signed cr     = std::min(__CAST(signed, clip.right()),
+                           __CAST(signed, extent.width));
+  signed cb     = std::min(__CAST(signed, clip.bottom()),
+                           __CAST(signed, extent.height));
+
+  dx = __CAST(signed, to.x) - __CAST(signed, from.left());
+  dy = __CAST(signed, to.y) - __CAST(signed, from.top());
+
+  // Clip the source rectangle, translated into the destination,
+  // against the clip rectangle.
+  left   = std::max(left,   cl - dx);
+  top    = std::max(top,    ct - dy);
+  right  = std::min(right,  cr - dx);
+  bottom = std::min(bottom, cb - dy);
+
+  if (left >= right || top >= bottom) {
+    return false;
+  }
+
+  area = rect(left, top, right - left, bottom - top);
+
+  return true;
+}
+
+/**
+ * @brief Count the trailing zero bits of a word.
+ * @param word The word, which must not be zero.
+ */
+static inline
+std::size_t
+trailing_zeros(std::uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+
+  _BitScanForward64(&index, word);
+
+  return index;
+#elif defined(_MSC_VER)
+  unsigned long index;
+
+  if (_BitScanForward(&index, __CAST(unsigned long, word))) {
+    return index;
+  }
+
+  _BitScanForward(&index, __CAST(unsigned long, word >> 32));
+
+  return index + 32;
+#else
+  return __CAST(std::size_t, __builtin_ctzll(word));
+#endif
+}
+
+/**
+ * @brief Call a function for each run of opaque cells in a mask.
+ * @param mask The mask, one bit per cell, set for opaque cells.
+ * @param from The offset of the first cell to look at.
+ * @param count The number of cells to look at.
+ * @param fn Called with the position of each run relative to
+ *           @c from, and its length.
+ *
+ * The mask is read a 64-bit word at a time, so a word with no
+ * opaque cells costs one test however many cells it covers, and a
+ * word with no transparent cells is one run.
+ */
+template <class _Fn>
+static
+void
+opaque_runs(const std::uint64_t *mask,
+            std::size_t          from,
+            std::size_t          count,
+            _Fn                  fn)
+{
+  std::size_t done = 0;
+
+  while (done < count) {
+    std::size_t   bit   = from + done;
+    std::size_t   shift = bit % 64;
+    std::size_t   avail = std::min(64 - shift, count - done);
+    std::uint64_t word  = mask[bit / 64] >> shift;
+    std::size_t   pos   = 0;
+
+    if (avail < 64) {
+      word &= (std::uint64_t(1) << avail) - 1;
+    }
+
+    while (word != 0) {
+      std::size_t skip = trailing_zeros(word);
+      std::size_t run;
+
+      pos  += skip;
+      word >>= skip;
+      run   = ~word == 0 ? 64 : trailing_zeros(~word);
+
+      fn(done + pos, run);
+
+      pos  += run;
+      word  = run < 64 ? word >> run : 0;
+    }
+
+    done += avail;
+  }
+}
+
+/**
+ * @brief Copy a rectangle of cells from another buffer.
+ * @param extent The size of this buffer.
+ * @param source The buffer to copy from.
+ * @param source_extent The size of the source buffer.
+ * @param from The rectangle of the source buffer to copy.
+ * @param to Where the top-left corner of @c from lands.
+ * @param clip The rectangle of this buffer that may be written to.
+ * @param mask The source's transparency mask, or a null pointer if
+ *             every cell is opaque.
+ * @param written If set, called for each run of cells copied.
+ * @returns The rectangle of this buffer that was written to, which
+ *          is empty if nothing was copied.
+ *
+ * Once clipped, what is left is copied a row at a time with
+ * @c copy.  With a mask, only the runs of opaque cells are copied.
+ */
+rect
+cell_buffer::blit(const screen_size   &extent,
+                  const cell_buffer   &source,
+                  const screen_size   &source_extent,
+                  const rect          &from,
+                  const point         &to,
+                  const rect          &clip,
+                  const std::uint64_t *mask,
+                  const run_callback  &written)
+{
+  rect   area;
+  signed dx = 0;
+  signed dy = 0;
+
+  if (!clip_transfer(extent, source_extent, from, to, clip, area, dx, dy)) {
+    return rect();
+  }
+
+  for (signed y = area.top(); y < area.bottom(); ++y) {
+    std::size_t target = (y + dy) * extent.width + (area.left() + dx);
+    std::size_t offset = y * source_extent.width + area.left();
+
+    if (mask == 0) {
+      copy(target, source, offset, area.extent.width);
+
+      if (written) {
+        written(target, area.extent.width);
+      }
+
+      continue;
+    }
+
+    opaque_runs(mask,
+                offset,
+                area.extent.width,
+                [&](std::size_t pos, std::size_t run)
+                {
+                  copy(target + pos, source, offset + pos, run);
+
+                  if (written) {
+                    written(target + pos, run);
+                  }
+                });
+  }
+
+  return rect(area.left() + dx,
+              area.top() + dy,
+              area.extent.width,
+              area.extent.height);
+}                                       // cell_buffer::blit
+
+/**
+ * @brief Copy a rectangle of cells from a pair of 16-bit planes.
+ * @param extent The size of this buffer.
+ * @param chars The character plane to copy from.
+ * @param attrs The attribute plane to copy from.
+ * @param source_extent The size of the planes.
+ * @param from The rectangle of the planes to copy.
+ * @param to Where the top-left corner of @c from lands.
+ * @param clip The rectangle of this buffer that may be written to.
+ * @param mask The planes' transparency mask, or a null pointer if
+ *             every cell is opaque.
+ * @param written If set, called for each run of cells copied.
+ * @returns The rectangle of this buffer that was written to, which
+ *          is empty if nothing was copied.
+ *
+ * This is how pictures in a memory-mapped pack are drawn without
+ * first being copied into a picture map.
+ */
+rect
+cell_buffer::blit(const screen_size   &extent,
+                  const std::uint16_t *chars,
+                  const std::uint16_t *attrs,
+                  const screen_size   &source_extent,
+                  const rect          &from,
+                  const point         &to,
+                  const rect          &clip,
+                  const std::uint64_t *mask,
+                  const run_callback  &written)
+{
+  rect   area;
+  signed dx = 0;
+  signed dy = 0;
+
+  if (!clip_transfer(extent, source_extent, from, to, clip, area, dx, dy)) {
+    return rect();
+  }
+
+  for (signed y = area.top(); y < area.bottom(); ++y) {
+    std::size_t target = (y + dy) * extent.width + (area.left() + dx);
+    std::size_t offset = y * source_extent.width + area.left();
+
+    if (mask == 0) {
+      copy_planes(target, chars + offset, attrs + offset, area.extent.width);
+
+      if (written) {
+        written(target, area.extent.width);
+      }
+
+      continue;
+    }
+
+    opaque_runs(mask,
+                offset,
+                area.extent.width,
+                [&](std::size_t pos, std::size_t run)
+                {
+                  copy_planes(target + pos,
+                              chars + offset + pos,
+                              attrs + offset + pos,
+                              run);
+
+                  if (written) {
+                    written(target + pos, run);
+                  }
+                });
+  }
+
+  return rect(area.left() + dx,
+              area.top() + dy,
+              area.extent.width,
+              area.extent.height);
+}                                       // cell_buffer::blit
+
+// cells.cpp ends here
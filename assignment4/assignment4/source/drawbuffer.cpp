@@ -38,6 +38,8 @@
  * @brief Drawing buffer class implementation.
  */
  
+#include <algorithm>
+
 #include "drawbuffer.hpp"
 #include "screen.hpp"
 
@@ -112,17 +114,34 @@ glyphs dos_glyphs[] = {
 /**
  * @brief Global draw buffer object.
  */
-draw_buffer GlobalDrawBuffer;
+draw_buffer ovision::GlobalDrawBuffer;
 
 /**
  * @brief Default constructor function.
+ *
+ * The global draw buffer follows the screen around as it is resized.
  */
 draw_buffer::draw_buffer()
+  : mWrites(0),
+    mOverdraw(0)
 {
   mSize = screen::get_instance().get_size();
   
-  mData.reserve(mSize.offset());
-  mData.assign(mSize.offset(), achar(' ', default_attributes));
+  mCells.assign(mSize.offset(), achar(' ', default_attributes));
+  reset_clip();
+
+#if defined(OVISION_COUNT_OVERDRAW)
+  mStamps.assign(mSize.offset(), 0);
+  mGeneration = 1;
+#endif
+
+  if (this == &GlobalDrawBuffer) {
+    screen::get_instance().add_resize_callback(
+      [this](const screen_size &)
+      {
+        resize();
+      });
+  }
 }
 
 /**
@@ -134,8 +153,13 @@ draw_buffer::resize()
 {
   mSize = screen::get_instance().get_size();
 
-  mData.reserve(mSize.offset());
-  mData.assign(mSize.offset(), achar(' ', default_attributes));
+  mCells.assign(mSize.offset(), achar(' ', default_attributes));
+  reset_clip();
+
+#if defined(OVISION_COUNT_OVERDRAW)
+  mStamps.assign(mSize.offset(), 0);
+  mGeneration = 1;
+#endif
 }
 
 /**
@@ -144,27 +168,122 @@ draw_buffer::resize()
 std::size_t
 draw_buffer::size() const
 {
-  return mData.size();
+  return mCells.size();
+}
+
+/**
+ * @brief Return the dimensions of the buffer in cells.
+ */
+screen_size
+draw_buffer::get_size() const
+{
+  return mSize;
+}
+
+/**
+ * @brief Return the buffer cells.
+ */
+const cell_buffer &
+draw_buffer::cells() const
+{
+  return mCells;
+}
+
+/**
+ * @brief Return the clip rectangle.
+ */
+const rect &
+draw_buffer::get_clip() const
+{
+  return mClip;
+}
+
+/**
+ * @brief Restrict drawing to part of the buffer.
+ * @param area The area that may be drawn to.
+ *
+ * Everything apart from @c clear honours the clip rectangle, so a
+ * damaged area can be redrawn without touching its surroundings.
+ */
+void
+draw_buffer::set_clip(const rect &area)
+{
+  rect whole(0,
+             0,
+             __CAST(signed, mSize.width),
+             __CAST(signed, mSize.height));
+
+  mClip = whole.touches(area) ? (whole & area) : rect();
+}
+
+/**
+ * @brief Allow drawing anywhere in the buffer.
+ */
+void
+draw_buffer::reset_clip()
+{
+  mClip = rect(0,
+               0,
+               __CAST(signed, mSize.width),
+               __CAST(signed, mSize.height));
 }
 
 /**
- * @brief Return the buffer data.
+ * @brief Return the number of cells written since the counters
+ *        were reset.
+ *
+ * A run of cells counts once for each cell in it, so this is a
+ * measure of how much drawing was done, whether or not anything
+ * changed.
  */
-astring &
-draw_buffer::data()
+std::size_t
+draw_buffer::get_cell_writes() const
 {
-  return mData;
+  return mWrites;
+}
+
+/**
+ * @brief Return the number of cells written over since the
+ *        counters were reset.
+ *
+ * This is only counted when @c OVISION_COUNT_OVERDRAW is defined,
+ * and is otherwise always zero.  A painter that writes each cell
+ * once per frame keeps this at zero.
+ */
+std::size_t
+draw_buffer::get_overdraw() const
+{
+  return mOverdraw;
+}
+
+/**
+ * @brief Reset the write counters, ready for a new frame.
+ */
+void
+draw_buffer::reset_cell_writes()
+{
+  mWrites   = 0;
+  mOverdraw = 0;
+
+#if defined(OVISION_COUNT_OVERDRAW)
+  if (++mGeneration == 0) {
+    mStamps.assign(mStamps.size(), 0);
+    mGeneration = 1;
+  }
+#endif
 }
 
 /**
  * @brief Clear the draw buffer.
  * @param attr An attribute used for each cell in the cleared
  *             buffer.
+ *
+ * This ignores the clip rectangle.
  */
 void
 draw_buffer::clear(attr_t attr)
 {
-  mData.assign(mSize.offset(), achar(' ', attr));
+  mCells.assign(mSize.offset(), achar(' ', attr));
 }
 
 /**
@@ -177,12 +296,7 @@ draw_buffer::clear(attr_t attr)
 void
 draw_buffer::fill(attr_t attr, bool clear, char_t empty)
 {
-  for (std::size_t i = 0; i < mData.size(); ++i) {
-    if (clear) {
-      mData[i].character = empty;
-    }
-    mData[i].attribute = attr;
-  }
+  fill(mClip, attr, clear, empty);
 }
 
 /**
@@ -194,24 +308,14 @@ draw_buffer::fill(attr_t attr, bool clear, char_t empty)
  * @param empty The character to fill with if @c clear is @c true.
  */
 void
-draw_buffer::fill(rect &area, attr_t attr, bool clear, char_t empty)
+draw_buffer::fill(const rect &area, attr_t attr, bool clear, char_t empty)
 {
-  std::size_t left   = area.left();
-  std::size_t right  = area.right();
-  std::size_t top    = area.top();
-  std::size_t bottom = area.bottom();
-  std::size_t loc    = 0;
-  std::size_t width  = screen::get_instance().get_columns();
-
-  for (std::size_t x = left; x < right; ++x) {
-    for (std::size_t y = top; y < bottom; ++y) {
-      loc = x + y * width;
+  cell_span2d cells = span(area);
 
-      if (clear) {
-        mData[loc].character = empty;
-      }
-      mData[loc].attribute = attr;
-    }
+  if (clear) {
+    cells.fill(empty, attr);
+  } else {
+    cells.fill_attributes(attr);
   }
 }
 
@@ -222,50 +326,68 @@ draw_buffer::fill(rect &area, attr_t attr, bool clear, char_t empty)
  * @param inside The attribute for the rectangle internals.
  * @param decoration @c true if you wish there to be a drawn
  *                   border, @c false for no border.
+ *
+ * The border is the outermost ring of cells.  Without decoration
+ * it is drawn as spaces, so passing the same attribute for both
+ * simply fills the rectangle.
  */
 void
-draw_buffer::draw_rect(rect   &shape,
-                       attr_t  border,
-                       attr_t  inside,
-                       bool    decoration)
+draw_buffer::draw_rect(const rect &shape,
+                       attr_t      border,
+                       attr_t      inside,
+                       bool        decoration)
 {
   std::size_t left   = shape.left();
   std::size_t right  = shape.right();
   std::size_t top    = shape.top();
   std::size_t bottom = shape.bottom();
   std::size_t loc    = 0;
-  std::size_t width  = screen::get_instance().get_columns();
+  std::size_t width  = mSize.width;
+  std::size_t span   = right - left;
+  char_t      edge   = ' ';
+
+  if (right <= left) {
+    return;
+  }
 
-  for (std::size_t x = left; x < right; ++x) {
-    for (std::size_t y = top; y < bottom; ++y)
+  // Each row is written as the left edge, a run, and the right
+  // edge, so no cell is written twice.  Only the rows and columns
+  // inside the clip rectangle are written.
+  for (std::size_t y = top; y < bottom; ++y) {
+    if (__CAST(signed, y) <  mClip.top() ||
+        __CAST(signed, y) >= mClip.bottom())
     {
-      loc = x + y * width;
-
-      if (y == top || y == bottom - 1) {
-        if (decoration) {
-          if (x == left && y == top) {
-            mData[loc].character = dos_glyphs[TOP_LEFT].glyph;
-            mData[loc].attribute = border;
-          } else if (x == right - 1 && y == top) {
-            mData[loc].character = dos_glyphs[TOP_RIGHT].glyph;
-            mData[loc].attribute = border;
-          } else if (x == left && y == bottom - 1) {
-            mData[loc].character = dos_glyphs[BOTTOM_LEFT].glyph;
-            mData[loc].attribute = border;
-          } else if (x == right - 1 && y == bottom - 1) {
-            mData[loc].character = dos_glyphs[BOTTOM_RIGHT].glyph;
-            mData[loc].attribute = border;
-          } else {
-            mData[loc].character = dos_glyphs[VERTICAL].glyph;
-            mData[loc].attribute = border;
-          }
+      continue;
+    }
+
+    loc = left + y * width;
+
+    if (y == top || y == bottom - 1) {
+      if (decoration) {
+        edge = dos_glyphs[y == top ? TOP_LEFT : BOTTOM_LEFT].glyph;
+
+        put_clipped(loc, edge, border);
+
+        if (span > 1) {
+          edge = dos_glyphs[y == top ? TOP_RIGHT : BOTTOM_RIGHT].glyph;
+
+          fill_clipped(loc + 1,
+                       span - 2,
+                       dos_glyphs[VERTICAL].glyph,
+                       border);
+          put_clipped(loc + span - 1, edge, border);
         }
-      } else if (decoration && (x == left || x == right - 1)) {
-        mData[loc].character = dos_glyphs[HORIZONTAL].glyph;
-        mData[loc].attribute = border;
       } else {
-        mData[loc].character = ' ';
-        mData[loc].attribute = inside;
+        fill_clipped(loc, span, ' ', border);
+      }
+    } else {
+      edge = decoration ? dos_glyphs[HORIZONTAL].glyph : ' ';
+
+      put_clipped(loc, edge, border);
+
+      if (span > 1) {
+        fill_clipped(loc + 1, span - 2, ' ', inside);
+        put_clipped(loc + span - 1, edge, border);
       }
     }
   }
@@ -292,19 +414,22 @@ draw_buffer::move_buf(std::size_t  indent,
     count = mSize.offset() - indent;
   }
 
-  achar        *dest = &mData[indent];
+  std::size_t   dest = indent;
   const char_t *s    = __CAST(const char_t *, source);
 
   if (attr.count() > 0) {
     while (count-- && *s) {
-      dest->character = *s++;
-      dest->attribute = attr;
-      *dest++;
+      put_clipped(dest++, *s++, attr);
     }
   } else {
     while (count-- && *s) {
-      dest->character = *s++;
-      *dest++;
+      if (visible(dest)) {
+        mCells.put_character(dest, *s);
+        wrote(dest, 1);
+      }
+
+      dest++;
+      s++;
     }
   }
 }
@@ -330,22 +455,22 @@ draw_buffer::move_char(std::size_t indent,
     count = mSize.offset() - indent;
   }
   
-  if (attr.count() > 0 ) {
-    if (c) {
-      for (std::size_t pos = 0; pos < count; ++pos) {
-        mData[indent + pos].character = c;
-        mData[indent + pos].attribute = attr;
-      }
-    } else {
-      for (std::size_t pos = 0; pos < count; ++pos) {
-        mData[indent + pos].attribute = attr;
-      }
-    } 
-  } else {
-    for (std::size_t pos = 0; pos < count; ++pos) {
-      mData[indent + pos].character = c;
-    }
-  }
+  clip_run(indent,
+           count,
+           [&](std::size_t loc, std::size_t span)
+           {
+             if (attr.count() > 0 ) {
+               if (c) {
+                 mCells.fill(loc, span, c, attr);
+               } else {
+                 mCells.fill_attributes(loc, span, attr);
+               }
+             } else {
+               mCells.fill_characters(loc, span, c);
+             }
+
+             wrote(loc, span);
+           });
 }
 
 /**
@@ -367,15 +492,7 @@ draw_buffer::move_char(std::size_t indent,
     count = mSize.offset() - indent;
   }
 
-  if (c.character) {
-    for (std::size_t pos = 0; pos < count; ++pos) {
-      mData[indent + pos] = c;
-    }
-  } else {
-    for (std::size_t pos = 0; pos < count; ++pos) {
-      mData[indent + pos].attribute = c.attribute;
-    }
-  }
+  move_char(indent, c.character, c.attribute, count);
 }
 
 /**
@@ -392,9 +509,6 @@ draw_buffer::move_cstr(std::size_t   indent,
                        bool          decoration)
 {
   std::size_t pos = 0;
-  std::size_t i   = 0;
-  string_t    nstr(str);
-  std::size_t len = nstr.length();
 
   if (decoration) {
     move_char(indent - 2,
@@ -407,12 +521,12 @@ draw_buffer::move_cstr(std::size_t   indent,
               1);
   }
 
-  for (i = 0; i < len; ++i) {
-    if (nstr[i] == '\n') {
+  // Walk the string in place rather than copying it first.
+  for (; *str != 0; ++str) {
+    if (*str == '\n') {
       pos += (mSize.width - (pos % mSize.width));
     } else {
-      mData[indent + pos].character = nstr[i];
-      mData[indent + pos].attribute = attrs;
+      put_clipped(indent + pos, *str, attrs);
 
       pos++;
     }
@@ -501,6 +615,71 @@ draw_buffer::move_str(std::size_t     indent,
   move_cstr(indent, str.c_str(), attrs, decoration);
 }
 
+/**
+ * @brief Move a run-length attributed string to the buffer.
+ * @param indent The offset the string will be placed at.
+ * @param str The string.
+ * @param from The first character of the string to move.
+ * @param count The number of characters to move.
+ *
+ * Each stretch of a run between newlines is written as one span,
+ * with its attribute filled across the span in one go.
+ */
+void
+draw_buffer::move_str(std::size_t       indent,
+                      const run_string &str,
+                      std::size_t       from,
+                      std::size_t       count)
+{
+  const char_t *chars = str.characters().c_str();
+  std::size_t   last  = str.size();
+  std::size_t   pos   = 0;
+  std::size_t   start = 0;
+  std::size_t   end   = 0;
+  std::size_t   stop  = 0;
+  std::size_t   at    = 0;
+
+  if (count < last - std::min(from, last)) {
+    last = from + count;
+  }
+
+  for (std::size_t r = 0; r < str.runs().size(); ++r) {
+    const attr_t &attr = str.runs()[r].attribute;
+
+    start = std::max(str.runs()[r].start, from);
+    end   = std::min(str.run_end(r), last);
+
+    while (start < end) {
+      if (chars[start] == L'\n') {
+        pos += (mSize.width - (pos % mSize.width));
+        ++start;
+        continue;
+      }
+
+      for (stop = start; stop < end && chars[stop] != L'\n'; ++stop)
+        ;
+
+      at = indent + pos;
+
+      if (at < mSize.offset()) {
+        clip_run(at,
+                 std::min(stop - start, mSize.offset() - at),
+                 [&](std::size_t loc, std::size_t span)
+                 {
+                   mCells.put_run(loc,
+                                  chars + start + (loc - at),
+                                  span,
+                                  attr);
+                   wrote(loc, span);
+                 });
+      }
+
+      pos   += stop - start;
+      start  = stop;
+    }
+  }
+}                                       // draw_buffer::move_str
+
 /**
  * @brief Dump the buffer to standard output.
  * @note This is only available in debug builds.
@@ -511,6 +690,148 @@ draw_buffer::dump()
   screen::get_instance().render_buffer(*this);
 }
 
+/**
+ * @brief Return a view of a rectangle of the buffer.
+ * @param area The rectangle, which is clipped to the clip rectangle.
+ *
+ * Cells are counted as written as they are written through the
+ * view, so a view that is only read from, or only partly written,
+ * counts no more than it changes.
+ */
+cell_span2d
+draw_buffer::span(const rect &area)
+{
+  cell_span2d whole(mCells,
+                    mSize,
+                    mClip,
+                    [this](std::size_t indent, std::size_t count)
+                    {
+                      wrote(indent, count);
+                    });
+
+  return whole.sub(rect(area.left() - mClip.left(),
+                        area.top()  - mClip.top(),
+                        area.extent.width,
+                        area.extent.height));
+}
+
+/**
+ * @brief Return a read-only view of a rectangle of the buffer.
+ * @param area The rectangle, which is clipped to the clip rectangle.
+ *
+ * This is clipped just as the writable view is, so the two views of
+ * the same rectangle always cover the same cells.
+ */
+const_cell_span2d
+draw_buffer::span(const rect &area) const
+{
+  const_cell_span2d whole(mCells, mSize, mClip);
+
+  return whole.sub(rect(area.left() - mClip.left(),
+                        area.top()  - mClip.top(),
+                        area.extent.width,
+                        area.extent.height));
+}
+
+/**
+ * @brief Copy part of the buffer into a picture.
+ * @param dest The picture, which is resized to fit.
+ * @param from The rectangle of the buffer to copy.
+ *
+ * Anything in @c from that falls outside the buffer is left blank.
+ */
+void
+draw_buffer::copy_to(picmap &dest, const rect &from) const
+{
+  screen_size extent(__CAST(std::size_t, from.extent.width),
+                     __CAST(std::size_t, from.extent.height));
+
+  dest.set_size(extent);
+  dest.blit(mCells, mSize, from, point(0, 0));
+}
+
+/**
+ * @brief Copy part of a picture to the buffer.
+ * @param source The picture to copy from.
+ * @param from The rectangle of the picture to copy.
+ * @param to Where the top-left corner of @c from lands.
+ * @param clip The rectangle of the buffer that may be written to.
+ *
+ * The picture is copied a row at a time, and anything falling
+ * outside the picture, the clip rectangle or the buffer is dropped,
+ * as are the picture's transparent cells.  Only the cells actually
+ * copied are counted as written.
+ */
+void
+draw_buffer::blit(const picmap &source,
+                  const rect   &from,
+                  const point  &to,
+                  const rect   &clip)
+{
+  if (!clip.touches(mClip)) {
+    return;
+  }
+
+  mCells.blit(mSize,
+              source.cells(),
+              source.get_size(),
+              from,
+              to,
+              clip & mClip,
+              source.mask(),
+              [this](std::size_t indent, std::size_t count)
+              {
+                wrote(indent, count);
+              });
+}
+
+/**
+ * @brief Copy part of a picture to the buffer.
+ * @param source The picture to copy from.
+ * @param from The rectangle of the picture to copy.
+ * @param to Where the top-left corner of @c from lands.
+ */
+void
+draw_buffer::blit(const picmap &source,
+                  const rect   &from,
+                  const point  &to)
+{
+  blit(source, from, to, mClip);
+}
+
+/**
+ * @brief Copy part of a picture from a pack to the buffer.
+ * @param source The picture to copy from.
+ * @param from The rectangle of the picture to copy.
+ * @param to Where the top-left corner of @c from lands.
+ * @param clip The rectangle of the buffer that may be written to.
+ *
+ * The cells are read straight out of the pack's planes.
+ */
+void
+draw_buffer::blit(const picpack_image &source,
+                  const rect          &from,
+                  const point         &to,
+                  const rect          &clip)
+{
+  if (!clip.touches(mClip)) {
+    return;
+  }
+
+  mCells.blit(mSize,
+              source.characters,
+              source.attributes,
+              source.size,
+              from,
+              to,
+              clip & mClip,
+              source.mask,
+              [this](std::size_t indent, std::size_t count)
+              {
+                wrote(indent, count);
+              });
+}
+
 /**
  * @brief Put an attribute to the buffer.
  * @param indent The offset the attribute will be placed at.
@@ -519,7 +840,10 @@ draw_buffer::dump()
 void
 draw_buffer::put_attribute(std::size_t indent, attr_t attr)
 {
-  mData[indent].attribute = attr;
+  if (indent < mCells.size() && visible(indent)) {
+    mCells.put_attribute(indent, attr);
+    wrote(indent, 1);
+  }
 }
 
 /**
@@ -531,8 +855,7 @@ draw_buffer::put_attribute(std::size_t indent, attr_t attr)
 void
 draw_buffer::put_char(std::size_t indent, char_t c, attr_t attr)
 {
-  mData[indent].character = c;
-  mData[indent].attribute = attr;
+  put_clipped(indent, c, attr);
 }
 
 /**
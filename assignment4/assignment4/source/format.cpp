@@ -0,0 +1,80 @@
+//
+// format.cpp --- Allocation-free text formatting implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 14:07:47 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 14:07:47
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file format.cpp
+ * @author Paul Ward
+ * @brief Allocation-free text formatting implementation.
+ */
+
+#include "format.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Format an integer as decimal digits.
+ * @param out Where to write the digits; there must be room for
+ *            @c max_integer_chars characters.
+ * @param value The magnitude of the integer.
+ * @param negative Is the integer negative?
+ * @returns The number of characters written.  No null is written.
+ */
+std::size_t
+ovision::format_integer(char_t             *out,
+                        unsigned long long  value,
+                        bool                negative)
+{
+  char_t      digits[max_integer_chars];
+  std::size_t count = 0;
+  std::size_t len   = 0;
+
+  // Digits come out backwards, so collect them first.
+  do {
+    digits[count++] = __CAST(char_t, '0' + (value % 10));
+    value          /= 10;
+  } while (value != 0);
+
+  if (negative) {
+    out[len++] = '-';
+  }
+
+  while (count > 0) {
+    out[len++] = digits[--count];
+  }
+
+  return len;
+}
+
+// format.cpp ends here
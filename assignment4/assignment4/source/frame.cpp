@@ -55,7 +55,7 @@ frame::frame()
  * @brief Constructor function.
  * @param area The initial geometry of the frame.
  */
-frame::frame(rect &area)
+frame::frame(const rect &area)
   : view(area)
 {}
 
@@ -67,6 +67,7 @@ void
 frame::set_title(const string_t &title)
 {
   mTitle = title;
+  invalidate();
 }
 
 /**
@@ -84,24 +85,25 @@ frame::get_title()
 void
 frame::render()
 {
-  extern draw_buffer GlobalDrawBuffer;
-  std::size_t        half;
-  std::size_t        halfPos;
+  draw_buffer &target = canvas();
+  std::size_t  half;
+  std::size_t  halfPos;
 
   half    = mClientRect.extent.width / 2 - mTitle.length() / 2;
-  halfPos = mClientRect.origin.y * screen::get_instance().get_columns();
+  halfPos = mClientRect.origin.x +
+            mClientRect.origin.y * target.get_size().width;
 
   if (half % 2 != 0) {
     half--;
   }
 
-  view::render();
+  // Leave a hole in the top border for the decorated title.
+  render_around(rect(mClientRect.left() + __CAST(signed, half) - 2,
+                     mClientRect.top(),
+                     __CAST(signed, mTitle.length()) + 4,
+                     1));
 
-  GlobalDrawBuffer.draw_rect(mInnerRect,
-                             mInnerAttr,
-                             mInnerAttr);
-
-  GlobalDrawBuffer.move_str(half + halfPos, mTitle, mClientAttr, true);
+  target.move_str(half + halfPos, mTitle, mClientAttr, true);
 }
 
 // frame.cpp ends here
@@ -40,18 +40,26 @@
 
 #include <random>
 #include <ctime>
-#include <sstream>
 #include <fstream>
 #include <algorithm>
 #include <cctype>
+#include <climits>
+#include <cstdlib>
 #include <random>
+#include <vector>
 
+#include "format.hpp"
 #include "posix.hpp"
 #include "gamepic.hpp"
 #include "game.hpp"
 
 using namespace ovision;
 
+/**
+ * @brief Milliseconds between frames of the hanging graphic.
+ */
+static const long AnimationDelay = 60;
+
 /**
  * @brief Constructor method.
  * @param wordFile The path of the word file to use.
@@ -79,8 +87,19 @@ game::read_word_file()
   char          ch;
   string_t      buf;
 
-  // Open the file.
+  // Open the file.  Only Microsoft's library opens a file by a wide
+  // name; elsewhere, the name goes through the multibyte encoding.
+#if defined(_WIN32)
   file.open(mWordFile);
+#else
+  std::vector<char> path(mWordFile.length() * MB_LEN_MAX + 1, '\0');
+
+  if (std::wcstombs(path.data(), mWordFile.c_str(), path.size()) !=
+      __CAST(std::size_t, -1))
+  {
+    file.open(path.data());
+  }
+#endif
 
   // If the file isn't open, complain.
   if (!file.is_open()) {
@@ -166,21 +185,17 @@ game::reset_guesses()
 void
 game::compose_guesses()
 {
-#if defined(OVISION_UNICODE)
-  std::wstringstream str;
-#else
-  std::stringstream  str;
-#endif
+  format_buffer<64> str;
 
   if (mLivesLeft == 0) {
-    str << "You have used up all your guesses.";
+    str << L"You have used up all your guesses.";
   } else {
-    str << mLivesLeft << " incorrect "
-        << (mLivesLeft == 1 ? "guess" : "guesses")
-        << " remaining.";
+    str << mLivesLeft << L" incorrect "
+        << (mLivesLeft == 1 ? L"guess" : L"guesses")
+        << L" remaining.";
   }
 
-  mRemainingText.set_text(str.str());
+  mRemainingText.set_text(str.c_str(), str.length());
 }
 
 /**
@@ -250,6 +265,19 @@ game::locate_characters(char_t ch)
   return valid;
 }
 
+/**
+ * @brief Play the hanging graphic on to the lives used so far.
+ *
+ * The graphic steps a frame at a time from the idle callback, so
+ * only the cells that change are redrawn.
+ */
+void
+game::show_lives_used()
+{
+  mGraphic.play_to(mTotalGuesses - mLivesLeft);
+  mApp.set_idle_timeout(AnimationDelay);
+}
+
 /**
  * @brief Game logic callback function.
  * @param msgBuffer Buffer used for messages.
@@ -273,8 +301,7 @@ game::game_logic(text   &msgBuffer,
     mUsedGuesses[guess]++;
     mLivesLeft--;
 
-    mGraphic.set_picmap(pic_generator::compute_picmap(mLivesLeft,
-      mTotalGuesses));
+    show_lives_used();
 
     msgBuffer.set_attribute(fg_red | fg_intense | bg_blue);
     msgBuffer.set_text(L"Uh oh, you have already tried that letter!");
@@ -291,8 +318,7 @@ game::game_logic(text   &msgBuffer,
     mUsedGuesses[guess]++;
     mLivesLeft--;
 
-    mGraphic.set_picmap(pic_generator::compute_picmap(mLivesLeft,
-      mTotalGuesses));
+    show_lives_used();
 
     msgBuffer.set_attribute(fg_red | fg_intense | bg_blue);
     msgBuffer.set_text(L"Sorry, that was an incorrect guess!");
@@ -304,11 +330,7 @@ game::game_logic(text   &msgBuffer,
   
   if (mLivesLeft == 0) {                // Have we used all our lives?
     // Yes.  Hang the victim until he is dead.
-#if defined(OVISION_UNICODE)
-    std::wstringstream str;
-#else
-    std::stringstream  str;
-#endif
+    format_buffer<128> str;
 
     str << L"The word was: " << mWordVector[mWordChosen];
 
@@ -316,10 +338,9 @@ game::game_logic(text   &msgBuffer,
     mGameFrame.set_inner_attribute(fg_white | fg_intense | bg_red);
 
     wordBuffer.set_attribute(fg_yellow | fg_intense | bg_red);
-    wordBuffer.set_text(str.str());
+    wordBuffer.set_text(str.c_str(), str.length());
 
-    mGraphic.set_picmap(pic_generator::compute_picmap(0,
-      mTotalGuesses));
+    show_lives_used();
 
     msgBuffer.set_attribute(fg_yellow | fg_intense | bg_red);
     msgBuffer.set_text(L"HARD LUCK - GAME OVER!  New game? (Y/N)");
@@ -341,11 +362,7 @@ game::game_logic(text   &msgBuffer,
 int
 game::run()
 {
-#if defined(OVISION_UNICODE)
-  std::wstringstream wordsLoaded;
-#else
-  std::stringstream  wordsLoaded;
-#endif
+  format_buffer<128> wordsLoaded;
 
   // Set up the UI components.
   mGameFrame = frame(rect(screen_point(0, 0),
@@ -381,21 +398,25 @@ game::run()
   mGraphic = picture(rect(5, 3, 24, 12));
 
   wordsLoaded << mWordVector.size()
-               << " word" << (mWordVector.size() == 1 ? "" : "s")
-               << " loaded, "
-    << mTotalGuesses << " incorrect guesses per game.";
+              << L" word" << (mWordVector.size() == 1 ? L"" : L"s")
+              << L" loaded, "
+              << mTotalGuesses << L" incorrect guesses per game.";
 
-  mStatusText = text(wordsLoaded.str(),
+  mStatusText = text(wordsLoaded.c_str(),
                      screen_point(2, 23),
                      fg_grey | bg_black);
 
+  // The frames rarely change, so keep them as cached layers and
+  // let the text drawn over them be redrawn on its own.
+  mGameFrame.set_cached(true);
+  mInputView.set_cached(true);
+
   mApp.set_title(L"Hangman");
   mApp.disable_cursor();  
 
   mGameFrame.set_title(string_t(_T("Super Hangman : Intel 8086 Edition")));
 
-  mGraphic.set_picmap(pic_generator::compute_picmap(mTotalGuesses,
-                                                    mTotalGuesses));
+  mGraphic.set_animation(pic_generator::compute_animation(mTotalGuesses));
 
   // Initialise game logic.
   reset_guesses();
@@ -452,8 +473,7 @@ game::run()
             mMessageText.set_text(
                 L"A new word has been chosen, start guessing!");
             
-            mGraphic.set_picmap( pic_generator::compute_picmap(mTotalGuesses,
-                                                               mTotalGuesses));
+            mGraphic.seek(0);
                               
             compose_guesses();
             compose_word_text();
@@ -464,6 +484,18 @@ game::run()
         }
       });                               // lambda
   
+  // Move the hanging graphic on a frame at a time, and stop waking
+  // up once it has caught up.
+  mApp.add_idle_callback(
+      [this]()
+      {
+        mGraphic.step();
+
+        if (!mGraphic.is_playing()) {
+          mApp.set_idle_timeout(-1);
+        }
+      });                               // lambda
+
   // Start the application.
   return mApp.start();
 }                                       // run
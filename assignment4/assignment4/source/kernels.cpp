@@ -0,0 +1,495 @@
+//
+// kernels.cpp --- Cell fill kernels implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 13:25:32 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 13:25:32
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file kernels.cpp
+ * @author Paul Ward
+ * @brief Cell fill kernels implementation.
+ *
+ * Each kernel uses unaligned stores for the body of the run and a
+ * scalar loop for whatever is left over, so rows of any width and
+ * alignment are handled.  Rows are short (a few hundred cells at
+ * most), so there is nothing to be gained from aligning first.
+ */
+
+#include "kernels.hpp"
+
+/**
+ * @def OVISION_X86
+ * @brief Are we building for an x86 or x86-64 processor?
+ *
+ * @def OVISION_AVX2
+ * @brief Can the compiler build the AVX2 kernels?
+ *
+ * The 256-bit integer intrinsics first shipped with Visual C++ 2012,
+ * so the AVX2 kernels are left out of older Microsoft builds.
+ *
+ * @def TARGET_SSE2
+ * @brief Mark a function as using SSE2.
+ *
+ * @def TARGET_AVX2
+ * @brief Mark a function as using AVX2.
+ *
+ * Microsoft's compiler will happily emit SSE2 and AVX2 instructions
+ * in any function, but GCC and Clang need to be told that a
+ * function may use them.
+ */
+#if defined(_M_X64) || defined(_M_IX86) || \
+    defined(__x86_64__) || defined(__i386__)
+# define OVISION_X86
+# if defined(_MSC_VER)
+#  include <intrin.h>
+#  define TARGET_SSE2
+#  define TARGET_AVX2
+#  if _MSC_VER >= 1700
+#   define OVISION_AVX2
+#  endif
+# else
+#  include <immintrin.h>
+#  define TARGET_SSE2 __attribute__((target("sse2")))
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+#  define OVISION_AVX2
+# endif
+#endif
+
+using namespace ovision;
+
+/**
+ * @brief 16-bit fill kernel type.
+ */
+typedef void (*fill16_fn)(std::uint16_t *, std::size_t, std::uint16_t);
+
+/**
+ * @brief 32-bit fill kernel type.
+ */
+typedef void (*fill32_fn)(std::uint32_t *, std::size_t, std::uint32_t);
+
+/**
+ * @brief 32-bit masked fill kernel type.
+ */
+typedef void (*fill32_masked_fn)(std::uint32_t *,
+                                 std::size_t,
+                                 std::uint32_t,
+                                 std::uint32_t);
+
+/**
+ * @brief Scalar 16-bit fill.
+ */
+static
+void
+fill16_scalar(std::uint16_t *dst, std::size_t count, std::uint16_t value)
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = value;
+  }
+}
+
+/**
+ * @brief Scalar 32-bit fill.
+ */
+static
+void
+fill32_scalar(std::uint32_t *dst, std::size_t count, std::uint32_t value)
+{
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = value;
+  }
+}
+
+/**
+ * @brief Scalar 32-bit masked fill.
+ */
+static
+void
+fill32_masked_scalar(std::uint32_t *dst,
+                     std::size_t    count,
+                     std::uint32_t  value,
+                     std::uint32_t  mask)
+{
+  value &= mask;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = (dst[i] & ~mask) | value;
+  }
+}
+
+#if defined(OVISION_X86)
+
+/**
+ * @brief SSE2 16-bit fill.
+ */
+static TARGET_SSE2
+void
+fill16_sse2(std::uint16_t *dst, std::size_t count, std::uint16_t value)
+{
+  __m128i     v = _mm_set1_epi16(__CAST(short, value));
+  std::size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+  }
+
+  fill16_scalar(dst + i, count - i, value);
+}
+
+/**
+ * @brief SSE2 32-bit fill.
+ */
+static TARGET_SSE2
+void
+fill32_sse2(std::uint32_t *dst, std::size_t count, std::uint32_t value)
+{
+  __m128i     v = _mm_set1_epi32(__CAST(int, value));
+  std::size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+  }
+
+  fill32_scalar(dst + i, count - i, value);
+}
+
+/**
+ * @brief SSE2 32-bit masked fill.
+ */
+static TARGET_SSE2
+void
+fill32_masked_sse2(std::uint32_t *dst,
+                   std::size_t    count,
+                   std::uint32_t  value,
+                   std::uint32_t  mask)
+{
+  __m128i     v = _mm_set1_epi32(__CAST(int, value & mask));
+  __m128i     m = _mm_set1_epi32(__CAST(int, mask));
+  std::size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m128i *at  = reinterpret_cast<__m128i *>(dst + i);
+    __m128i  old = _mm_loadu_si128(at);
+
+    _mm_storeu_si128(at, _mm_or_si128(_mm_andnot_si128(m, old), v));
+  }
+
+  fill32_masked_scalar(dst + i, count - i, value, mask);
+}
+
+/**
+ * @brief Can we use SSE2?
+ *
+ * Every x86-64 processor has it, but a 32-bit build may still be
+ * run on a processor that does not.
+ */
+static
+bool
+have_sse2()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+  return true;
+#elif defined(_MSC_VER)
+  int regs[4];
+
+  __cpuid(regs, 1);
+
+  return (regs[3] & (1 << 26)) != 0;
+#else
+  return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+
+#if defined(OVISION_AVX2)
+
+/**
+ * @brief AVX2 16-bit fill.
+ */
+static TARGET_AVX2
+void
+fill16_avx2(std::uint16_t *dst, std::size_t count, std::uint16_t value)
+{
+  __m256i     v = _mm256_set1_epi16(__CAST(short, value));
+  std::size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+  }
+
+  fill16_scalar(dst + i, count - i, value);
+}
+
+/**
+ * @brief AVX2 32-bit fill.
+ */
+static TARGET_AVX2
+void
+fill32_avx2(std::uint32_t *dst, std::size_t count, std::uint32_t value)
+{
+  __m256i     v = _mm256_set1_epi32(__CAST(int, value));
+  std::size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+  }
+
+  fill32_scalar(dst + i, count - i, value);
+}
+
+/**
+ * @brief AVX2 32-bit masked fill.
+ */
+static TARGET_AVX2
+void
+fill32_masked_avx2(std::uint32_t *dst,
+                   std::size_t    count,
+                   std::uint32_t  value,
+                   std::uint32_t  mask)
+{
+  __m256i     v = _mm256_set1_epi32(__CAST(int, value & mask));
+  __m256i     m = _mm256_set1_epi32(__CAST(int, mask));
+  std::size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i *at  = reinterpret_cast<__m256i *>(dst + i);
+    __m256i  old = _mm256_loadu_si256(at);
+
+    _mm256_storeu_si256(at,
+                        _mm256_or_si256(_mm256_andnot_si256(m, old), v));
+  }
+
+  fill32_masked_scalar(dst + i, count - i, value, mask);
+}
+
+/**
+ * @brief Can we use AVX2?
+ *
+ * The processor has to support it, and the operating system has to
+ * save the YMM registers on a context switch.
+ */
+static
+bool
+have_avx2()
+{
+#if defined(_MSC_VER)
+  int regs[4];
+
+  __cpuid(regs, 0);
+  if (regs[0] < 7) {
+    return false;
+  }
+
+  __cpuid(regs, 1);
+  if (!(regs[2] & (1 << 27)) || !(regs[2] & (1 << 28))) {
+    return false;                       // No OSXSAVE or no AVX.
+  }
+
+  if ((_xgetbv(0) & 0x6) != 0x6) {
+    return false;                       // XMM and YMM state not saved.
+  }
+
+  __cpuidex(regs, 7, 0);
+
+  return (regs[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // OVISION_AVX2
+
+#endif // OVISION_X86
+
+/**
+ * @brief Kernel dispatch table.
+ */
+typedef struct {
+  bool             selected;            //!< Has a kernel set been chosen?
+  kernels::isa_t   isa;                 //!< Chosen instruction set.
+  fill16_fn        fill16;              //!< 16-bit fill kernel.
+  fill32_fn        fill32;              //!< 32-bit fill kernel.
+  fill32_masked_fn fill32_masked;       //!< 32-bit masked fill kernel.
+} dispatch_table;
+
+/**
+ * @brief The kernels in use.
+ *
+ * This is zero-initialised before any constructor runs, so the
+ * kernels can be used from static initialisers.
+ */
+static dispatch_table dispatch;
+
+/**
+ * @brief Make sure a kernel set has been chosen.
+ */
+static inline
+void
+ensure_selected()
+{
+  if (!dispatch.selected) {
+    kernels::select_isa(kernels::best_isa());
+  }
+}
+
+/**
+ * @brief Return the widest instruction set this processor supports.
+ */
+kernels::isa_t
+kernels::best_isa()
+{
+#if defined(OVISION_X86)
+# if defined(OVISION_AVX2)
+  if (have_avx2()) {
+    return isa_avx2;
+  }
+# endif
+
+  if (have_sse2()) {
+    return isa_sse2;
+  }
+
+  return isa_scalar;
+#else
+  return isa_scalar;
+#endif
+}
+
+/**
+ * @brief Return the instruction set of the kernels in use.
+ */
+kernels::isa_t
+kernels::current_isa()
+{
+  ensure_selected();
+
+  return dispatch.isa;
+}
+
+/**
+ * @brief Use the kernels for the given instruction set.
+ * @param isa The instruction set.
+ *
+ * Asking for more than the processor supports gets the best that it
+ * does support.  This is mostly useful for comparing kernels against
+ * each other.
+ */
+void
+kernels::select_isa(isa_t isa)
+{
+  if (isa > best_isa()) {
+    isa = best_isa();
+  }
+
+  dispatch.isa           = isa;
+  dispatch.fill16        = fill16_scalar;
+  dispatch.fill32        = fill32_scalar;
+  dispatch.fill32_masked = fill32_masked_scalar;
+
+#if defined(OVISION_X86)
+  if (isa == isa_sse2) {
+    dispatch.fill16        = fill16_sse2;
+    dispatch.fill32        = fill32_sse2;
+    dispatch.fill32_masked = fill32_masked_sse2;
+  }
+#endif
+#if defined(OVISION_AVX2)
+  if (isa == isa_avx2) {
+    dispatch.fill16        = fill16_avx2;
+    dispatch.fill32        = fill32_avx2;
+    dispatch.fill32_masked = fill32_masked_avx2;
+  }
+#endif
+
+  dispatch.selected = true;
+}
+
+/**
+ * @brief Return the name of an instruction set.
+ * @param isa The instruction set.
+ */
+const char *
+kernels::isa_name(isa_t isa)
+{
+  switch (isa) {
+    case isa_sse2: return "sse2";
+    case isa_avx2: return "avx2";
+    default:       return "scalar";
+  }
+}
+
+/**
+ * @brief Fill a run of 16-bit values.
+ * @param dst The first value.
+ * @param count The number of values.
+ * @param value The value to fill with.
+ */
+void
+kernels::fill16(std::uint16_t *dst, std::size_t count, std::uint16_t value)
+{
+  ensure_selected();
+
+  dispatch.fill16(dst, count, value);
+}
+
+/**
+ * @brief Fill a run of 32-bit values.
+ * @param dst The first value.
+ * @param count The number of values.
+ * @param value The value to fill with.
+ */
+void
+kernels::fill32(std::uint32_t *dst, std::size_t count, std::uint32_t value)
+{
+  ensure_selected();
+
+  dispatch.fill32(dst, count, value);
+}
+
+/**
+ * @brief Replace some of the bits of a run of 32-bit values.
+ * @param dst The first value.
+ * @param count The number of values.
+ * @param value The bits to fill with.
+ * @param mask Which bits of each value to replace.
+ */
+void
+kernels::fill32_masked(std::uint32_t *dst,
+                       std::size_t    count,
+                       std::uint32_t  value,
+                       std::uint32_t  mask)
+{
+  ensure_selected();
+
+  dispatch.fill32_masked(dst, count, value, mask);
+}
+
+// kernels.cpp ends here
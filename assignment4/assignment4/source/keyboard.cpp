@@ -63,6 +63,35 @@ keyboard::keyboard()
   mLastKey.character = 0;
   mLastKey.modifier  = 0;
   mLastKey.scancode  = 0;
+
+#if defined(OVISION_HEADLESS)
+  mScriptPos = 0;
+  mWaits     = 0;
+  mEvents    = 0;
+  mArmed     = false;
+#endif
+}
+
+// The rest of this file is the Win32 console input back end.  The
+// VT terminal back end can be found in keyboard_vt.cpp.
+#if defined(OVISION_WIN32)
+
+/**
+ * @brief Pass a screen buffer resize on to the screen.
+ *
+ * The console reports resizes through the input queue, so we are
+ * the ones who see them.
+ */
+void
+keyboard::buffer_event()
+{
+  if (mInputRecord.EventType == WINDOW_BUFFER_SIZE_EVENT) {
+    COORD size = mInputRecord.Event.WindowBufferSizeEvent.dwSize;
+
+    screen::get_instance().buffer_resized(
+      screen_size(__CAST(std::size_t, size.X),
+                  __CAST(std::size_t, size.Y)));
+  }
 }
 
 /**
@@ -98,6 +127,7 @@ keyboard::kbhit()
                        &mInputRecord,
                        1,
                        &cEvents);
+      buffer_event();
       continue;
     }
 
@@ -114,6 +144,27 @@ keyboard::kbhit()
   return false;
 }
 
+/**
+ * @brief Wait for console input.
+ * @param timeout The longest time to wait, in milliseconds.  A
+ *                negative value waits for as long as it takes.
+ * @returns @c true if there is an event in the input queue;
+ *          otherwise @c false is returned when the timeout expires.
+ *
+ * The console input handle is signalled for any event, not just
+ * key presses, so @c get_keyboard_event might still return no
+ * character.  Either way the caller sleeps in the kernel rather
+ * than spinning.
+ */
+bool
+keyboard::wait(long timeout)
+{
+  DWORD ms = timeout < 0 ? INFINITE : __CAST(DWORD, timeout);
+
+  return WaitForSingleObject(screen::get_instance().input_handle(), ms)
+         == WAIT_OBJECT_0;
+}
+
 /**
  * @brief Get a keyboard event from the input buffer.
  * @returns Information about the keyboard event, if any.
@@ -133,9 +184,11 @@ keyboard::get_keyboard_event()
                    1,
                    &cEvents);
 
+  buffer_event();
 
-
-  if (mInputRecord.Event.KeyEvent.bKeyDown) {
+  if (mInputRecord.EventType == KEY_EVENT &&
+      mInputRecord.Event.KeyEvent.bKeyDown)
+  {
     DWORD dwCtlState  = mInputRecord.Event.KeyEvent.dwControlKeyState;
     mLastKey.modifier = 0;
 
@@ -164,4 +217,6 @@ keyboard::get_keyboard_event()
   return mLastKey;
 }                                       // keyboard::get_keyboard_event
 
+#endif // OVISION_WIN32
+
 // keyboard.cpp ends here
@@ -0,0 +1,238 @@
+//
+// keyboard_headless.cpp --- Scripted keyboard handling.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 09:17:26 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 09:17:26
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file keyboard_headless.cpp
+ * @author Paul Ward
+ * @brief Scripted keyboard handling.
+ *
+ * This is the headless back end for the keyboard class.  Key presses
+ * come from a script fed in ahead of time rather than from a device,
+ * so that @c application::start can be driven from a benchmark or
+ * test.
+ *
+ * Once the script runs out every further key press is Control+C,
+ * which makes the application shut down cleanly.
+ *
+ * A script can also hold pauses, during which no input arrives.
+ * They really are waited out, and the number of calls to @c wait is
+ * counted, so the CPU time and wakeups of an idle main loop can be
+ * measured.
+ */
+
+#include "compiler.hpp"
+
+#if defined(OVISION_HEADLESS)
+
+#include <algorithm>
+#include <thread>
+
+#include "keyboard.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Is the next scripted event ready to be read?
+ *
+ * The delay before an event starts the first time anyone asks about
+ * the event, which is when a real device would start being quiet.
+ */
+bool
+keyboard::ready()
+{
+  if (mScriptPos >= mScript.length() || mDelays[mScriptPos] <= 0) {
+    return true;
+  }
+
+  if (!mArmed) {
+    mArmed   = true;
+    mReadyAt = script_clock::now() +
+               std::chrono::milliseconds(mDelays[mScriptPos]);
+  }
+
+  return script_clock::now() >= mReadyAt;
+}
+
+/**
+ * @brief Clear any keyboard events.
+ *
+ * The script is fed before the application starts, and the
+ * application clears the keyboard as it starts, so this does not
+ * throw the script away.
+ */
+void
+keyboard::clear()
+{}
+
+/**
+ * @brief Has any key been pressed?
+ * @returns @c true if there is a scripted key press left and its
+ *          pause is over; otherwise @c false is returned.
+ */
+bool
+keyboard::kbhit()
+{
+  return mScriptPos < mScript.length() && ready();
+}
+
+/**
+ * @brief Wait for a key press.
+ * @param timeout The longest time to wait, in milliseconds, or a
+ *                negative value to wait for as long as it takes.
+ * @returns @c true if there is an event to read, or @c false if the
+ *          timeout passed first.
+ *
+ * The thread sleeps through any pause before the next event.  Once
+ * the script is exhausted there is always an event to read, which is
+ * Control+C.
+ */
+bool
+keyboard::wait(long timeout)
+{
+  script_clock::time_point until;
+
+  ++mWaits;
+
+  if (ready()) {
+    return true;
+  }
+
+  until = mReadyAt;
+
+  if (timeout >= 0) {
+    until = std::min(until,
+                     script_clock::now() +
+                       std::chrono::milliseconds(timeout));
+  }
+
+  std::this_thread::sleep_until(until);
+
+  return ready();
+}
+
+/**
+ * @brief Get the next scripted keyboard event.
+ * @returns Information about the keyboard event.
+ *
+ * Only the character is filled in.  When the script is exhausted
+ * Control+C is returned.
+ */
+ovision::key_t
+keyboard::get_keyboard_event()
+{
+  // Reading blocks until the event arrives, as it does on a console.
+  while (!ready()) {
+    std::this_thread::sleep_until(mReadyAt);
+  }
+
+  mLastKey.modifier  = 0;
+  mLastKey.scancode  = 0;
+  mLastKey.character = 3;
+
+  if (mScriptPos < mScript.length()) {
+    mLastKey.character = mScript[mScriptPos++];
+    mArmed             = false;
+  }
+
+  ++mEvents;
+
+  return mLastKey;
+}
+
+/**
+ * @brief Append key presses to the script.
+ * @param keys The characters to press, in order.
+ *
+ * Whatever has already been played back is dropped first, so the
+ * script does not grow without bound when fed repeatedly.
+ */
+void
+keyboard::feed(const std::string &keys)
+{
+  mScript.erase(0, mScriptPos);
+  mDelays.erase(mDelays.begin(), mDelays.begin() + mScriptPos);
+  mScriptPos = 0;
+
+  mScript += keys;
+  mDelays.resize(mScript.length(), 0);
+}
+
+/**
+ * @brief Append a pause to the script.
+ * @param milliseconds How long no input arrives for.
+ *
+ * The pause ends with an event that is not a key press, such as a
+ * key being released, which is read as a character of zero.
+ */
+void
+keyboard::pause(long milliseconds)
+{
+  feed(std::string(1, '\0'));
+
+  mDelays.back() = milliseconds;
+}
+
+/**
+ * @brief Return the number of times @c wait has been called.
+ */
+std::size_t
+keyboard::get_waits() const
+{
+  return mWaits;
+}
+
+/**
+ * @brief Return the number of events read.
+ */
+std::size_t
+keyboard::get_events() const
+{
+  return mEvents;
+}
+
+/**
+ * @brief Reset the wait and event counts.
+ */
+void
+keyboard::reset_stats()
+{
+  mWaits  = 0;
+  mEvents = 0;
+}
+
+#endif // OVISION_HEADLESS
+
+// keyboard_headless.cpp ends here
@@ -0,0 +1,159 @@
+//
+// keyboard_vt.cpp --- VT terminal keyboard handling.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 15:54:45 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 15:54:45
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file keyboard_vt.cpp
+ * @author Paul Ward
+ * @brief VT terminal keyboard handling.
+ *
+ * This is the POSIX back end for the keyboard class.  The screen
+ * puts the terminal into raw mode, so input arrives here a byte at
+ * a time, and Control+C arrives as a character rather than a signal.
+ */
+
+#include "compiler.hpp"
+
+#if defined(OVISION_POSIX)
+
+#include <cerrno>
+
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+
+#include "keyboard.hpp"
+#include "screen.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Clear any keyboard events.
+ */
+void
+keyboard::clear()
+{
+  tcflush(screen::get_instance().input_handle(), TCIFLUSH);
+}
+
+/**
+ * @brief Has any key been pressed?
+ * @returns @c true if there is input waiting to be read; otherwise
+ *          @c false is returned.
+ *
+ * This should not be used for keyboard entry, only for looping
+ * until a key is pressed.
+ */
+bool
+keyboard::kbhit()
+{
+  struct pollfd pfd;
+
+  pfd.fd      = screen::get_instance().input_handle();
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+
+  return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+/**
+ * @brief Wait for terminal input.
+ * @param timeout The longest time to wait, in milliseconds.  A
+ *                negative value waits for as long as it takes.
+ * @returns @c true if there is input waiting or the terminal window
+ *          changed size; otherwise @c false is returned when the
+ *          timeout expires.
+ *
+ * Signals other than @c SIGWINCH restart the wait with the full
+ * timeout.  Errors from @c poll are passed on as input so that the
+ * following read reports them.
+ */
+bool
+keyboard::wait(long timeout)
+{
+  struct pollfd pfd;
+  int           n;
+
+  pfd.fd     = screen::get_instance().input_handle();
+  pfd.events = POLLIN;
+
+  for (;;) {
+    pfd.revents = 0;
+    n           = poll(&pfd, 1, timeout < 0 ? -1 : __CAST(int, timeout));
+
+    if (n >= 0) {
+      return n > 0;
+    }
+
+    if (errno != EINTR || screen::get_instance().poll_resize()) {
+      return true;
+    }
+  }
+}
+
+/**
+ * @brief Get a keyboard event from the terminal.
+ * @returns Information about the keyboard event, if any.
+ *
+ * Terminals do not report modifier state or scan codes, so only the
+ * character is filled in.  Escape sequences for function and cursor
+ * keys are returned a byte at a time.
+ *
+ * If the read is interrupted because the terminal window changed
+ * size, the screen is told to pick up the new size and no character
+ * is returned.
+ */
+ovision::key_t
+keyboard::get_keyboard_event()
+{
+  unsigned char ch = 0;
+  ssize_t       n  = 0;
+
+  n = read(screen::get_instance().input_handle(), &ch, 1);
+
+  if (n < 0 && errno == EINTR) {
+    screen::get_instance().poll_resize();
+  }
+
+  mLastKey.modifier  = 0;
+  mLastKey.scancode  = 0;
+  mLastKey.character = n == 1 ? __CAST(char, ch) : 0;
+
+  return mLastKey;
+}                                       // keyboard::get_keyboard_event
+
+#endif // OVISION_POSIX
+
+// keyboard_vt.cpp ends here
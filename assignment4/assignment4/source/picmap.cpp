@@ -38,10 +38,23 @@
  * @brief Picture map implementation.
  */
  
+#include <algorithm>
+
 #include "picmap.hpp"
 
 using namespace ovision;
 
+/**
+ * @brief Return the number of mask words needed for some cells.
+ * @param cells The number of cells.
+ */
+static inline
+std::size_t
+mask_words(std::size_t cells)
+{
+  return (cells + 63) / 64;
+}
+
 /**
  * @brief Default constructor function.
  */
@@ -63,7 +76,22 @@ picmap::picmap(screen_size_type width, screen_size_type height)
   mArea.extent.width = width;
   mArea.extent.height = height;
 
-  mData.assign(mArea.extent.offset(), achar(L' ', bg_black));
+  mCells.assign(mArea.extent.offset(), achar(L' ', bg_black));
+}
+
+/**
+ * @brief Constructor function.
+ * @param width The picture width.
+ * @param height The picture height.
+ * @param glyphs The picture glyphs, one row after another.
+ * @param attrs The attribute for each glyph.
+ */
+picmap::picmap(screen_size_type  width,
+               screen_size_type  height,
+               const char_t      glyphs[],
+               const attr_t      attrs[])
+{
+  load(width, height, glyphs, attrs);
 }
 
 /**
@@ -72,17 +100,18 @@ picmap::picmap(screen_size_type width, screen_size_type height)
  */
 picmap::picmap(const picmap &other)
 {
-  mArea = other.mArea;
-  mData = other.mData;
+  mArea  = other.mArea;
+  mCells = other.mCells;
+  mMask  = other.mMask;
 }
 
 /**
- * @brief Return the picture data.
+ * @brief Return the picture cells.
  */
-astring &
-picmap::data()
+const cell_buffer &
+picmap::cells() const
 {
-  return mData;
+  return mCells;
 }
 
 /**
@@ -98,19 +127,29 @@ picmap::get_area()
  * @brief Return the size of the ASCII/Unicode data.
  */
 std::size_t
-picmap::size()
+picmap::size() const
+{
+  return mCells.size();
+}
+
+/**
+ * @brief Return the dimensions of the picture in cells.
+ */
+screen_size
+picmap::get_size() const
 {
-  return mData.size();
+  return screen_size(__CAST(std::size_t, mArea.extent.width),
+                     __CAST(std::size_t, mArea.extent.height));
 }
 
 /**
  * @brief Return the picture element at a given index.
  * @param index The index of the picture element to obtain.
  */
-achar &
-picmap::at(std::size_t index)
+achar
+picmap::get(std::size_t index) const
 {
-  return mData.at(index);
+  return mCells.get(index);
 }
 
 /**
@@ -119,10 +158,21 @@ picmap::at(std::size_t index)
  * @param value The ASCII/unicode glyph to assign.
  */
 void
-picmap::assign(std::size_t elems, achar &value)
+picmap::assign(std::size_t elems, const achar &value)
 {
-  mData.reserve(elems);
-  mData.assign(elems, value);
+  mCells.assign(elems, value);
+  mMask.clear();
+}
+
+/**
+ * @brief Set the picture element at a given index.
+ * @param index The index of the picture element to set.
+ * @param value The new glyph and attribute.
+ */
+void
+picmap::put(std::size_t index, const achar &value)
+{
+  mCells.put(index, value.character, value.attribute);
 }
 
 /**
@@ -131,20 +181,195 @@ picmap::assign(std::size_t elems, achar &value)
  * @note This function will blank out the picture with spaces.
  */
 void
-picmap::set_size(screen_size &extent)
+picmap::set_size(const screen_size &extent)
 {
   mArea.extent = extent;
 
-  mData.assign(mArea.extent.offset(), achar(L' ', bg_black));
+  mCells.assign(mArea.extent.offset(), achar(L' ', bg_black));
+  mMask.clear();
+}
+
+/**
+ * @brief Load the picture from glyph and attribute arrays.
+ * @param width The picture width.
+ * @param height The picture height.
+ * @param glyphs The picture glyphs, one row after another.
+ * @param attrs The attribute for each glyph.
+ */
+void
+picmap::load(screen_size_type  width,
+             screen_size_type  height,
+             const char_t      glyphs[],
+             const attr_t      attrs[])
+{
+  std::size_t len = width * height;
+
+  mArea.origin.x      = 0;
+  mArea.origin.y      = 0;
+  mArea.extent.width  = __CAST(size_type, width);
+  mArea.extent.height = __CAST(size_type, height);
+
+  mCells.assign(len, achar(L' ', bg_black));
+  mMask.clear();
+
+  for (std::size_t i = 0; i < len; ++i) {
+    mCells.put(i, glyphs[i], attrs[i]);
+  }
 }
 
 /**
  * @brief Clear the picture data.
+ *
+ * The picture is left empty, with a size of zero by zero.
  */
 void
 picmap::clear()
 {
-  mData.clear();
+  mArea.extent.width = mArea.extent.height = 0;
+
+  mCells.assign(0, achar(L' ', bg_black));
+  mMask.clear();
+}
+
+/**
+ * @brief Does the picture have a transparency mask?
+ */
+bool
+picmap::has_mask() const
+{
+  return !mMask.empty();
+}
+
+/**
+ * @brief Return the transparency mask.
+ * @returns One bit per cell, set where the cell is opaque, or a null
+ *          pointer if the picture has no mask.
+ */
+const std::uint64_t *
+picmap::mask() const
+{
+  return mMask.empty() ? 0 : mMask.data();
+}
+
+/**
+ * @brief Is a cell opaque?
+ * @param index The offset of the cell.
+ */
+bool
+picmap::is_opaque(std::size_t index) const
+{
+  if (mMask.empty()) {
+    return true;
+  }
+
+  return ((mMask[index / 64] >> (index % 64)) & 1) != 0;
+}
+
+/**
+ * @brief Make a cell opaque or transparent.
+ * @param index The offset of the cell.
+ * @param flag @c true to make the cell opaque.
+ *
+ * The picture gains a mask, opaque everywhere, the first time a
+ * cell is made transparent.
+ */
+void
+picmap::set_opaque(std::size_t index, bool flag)
+{
+  std::uint64_t bit = std::uint64_t(1) << (index % 64);
+
+  if (mMask.empty()) {
+    if (flag) {
+      return;
+    }
+
+    mMask.assign(mask_words(mCells.size()), ~std::uint64_t(0));
+  }
+
+  if (flag) {
+    mMask[index / 64] |= bit;
+  } else {
+    mMask[index / 64] &= ~bit;
+  }
+}
+
+/**
+ * @brief Replace the transparency mask.
+ * @param bits One bit per cell, set where the cell is opaque, or a
+ *             null pointer to make every cell opaque.
+ *
+ * A mask that has every cell opaque is dropped, so that blitting
+ * the picture takes the quicker unmasked path.
+ */
+void
+picmap::set_mask(const std::uint64_t *bits)
+{
+  std::size_t count = mCells.size();
+  std::size_t words = mask_words(count);
+
+  mMask.clear();
+
+  if (bits == 0) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < words; ++i) {
+    std::uint64_t want = ~std::uint64_t(0);
+
+    if (i == words - 1 && count % 64 != 0) {
+      want = (std::uint64_t(1) << (count % 64)) - 1;
+    }
+
+    if ((bits[i] & want) != want) {
+      mMask.assign(bits, bits + words);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Make every cell showing a key glyph transparent.
+ * @param key The key glyph.
+ */
+void
+picmap::set_key(char_t key)
+{
+  for (std::size_t i = 0; i < mCells.size(); ++i) {
+    if (mCells.character(i) == key) {
+      set_opaque(i, false);
+    }
+  }
+}
+
+/**
+ * @brief Make every cell opaque again.
+ */
+void
+picmap::clear_mask()
+{
+  mMask.clear();
+}
+
+/**
+ * @brief Return a view of a rectangle of the picture.
+ * @param area The rectangle, which is clipped to the picture.
+ *
+ * Writing through the view leaves the transparency mask alone.
+ */
+cell_span2d
+picmap::span(const rect &area)
+{
+  return cell_span2d(mCells, get_size(), area);
+}
+
+/**
+ * @brief Return a read-only view of a rectangle of the picture.
+ * @param area The rectangle, which is clipped to the picture.
+ */
+const_cell_span2d
+picmap::span(const rect &area) const
+{
+  return const_cell_span2d(mCells, get_size(), area);
 }
 
 /**
@@ -159,11 +384,11 @@ picmap::clear()
 void
 picmap::fill(const screen_point &origin, attr_t attr)
 {
-  std::size_t pos = mData.size();
-  std::size_t i   = 0;
+  std::size_t pos   = mCells.size();
+  std::size_t start = origin.x + origin.y * get_size().width;
 
-  for (i = origin.offset(); i < pos; ++i) {
-    mData[i].attribute = attr;
+  if (start < pos) {
+    mCells.fill_attributes(start, pos - start, attr);
   }
 }
 
@@ -176,16 +401,63 @@ picmap::fill(const screen_point &origin, attr_t attr)
  * This fill method does not fill with a character or glyph, but with
  * an attribute.  Eventually there might be a character/glyph fill
  * function.
+ *
+ * The region is offset by @c origin and clipped to the picture.
  */
 void
 picmap::fill(const screen_point &origin, const rect &region, attr_t attr)
 {
-  std::size_t pos = region.origin.offset() + origin.offset();
-  std::size_t i   = 0;
+  rect area(__CAST(signed, region.left()) + __CAST(signed, origin.x),
+            __CAST(signed, region.top())  + __CAST(signed, origin.y),
+            __CAST(signed, region.extent.width),
+            __CAST(signed, region.extent.height));
 
-  for (i = 0; i < pos; ++i) {
-    mData[i].attribute = attr;
-  }
+  span(area).fill_attributes(attr);
+}
+
+/**
+ * @brief Copy part of another picture onto this one.
+ * @param source The picture to copy from.
+ * @param from The rectangle of @c source to copy.
+ * @param to Where the top-left corner of @c from lands.
+ *
+ * Anything that falls outside either picture is clipped, and cells
+ * that are transparent in @c source are skipped.  This picture's
+ * own mask is left as it is.
+ */
+void
+picmap::blit(const picmap &source, const rect &from, const point &to)
+{
+  mCells.blit(get_size(),
+              source.mCells,
+              source.get_size(),
+              from,
+              to,
+              rect(0, 0, mArea.extent.width, mArea.extent.height),
+              source.mask());
+}
+
+/**
+ * @brief Copy part of a cell buffer onto this picture.
+ * @param source The cells to copy from.
+ * @param source_extent The size of @c source.
+ * @param from The rectangle of @c source to copy.
+ * @param to Where the top-left corner of @c from lands.
+ *
+ * Anything that falls outside either buffer is clipped.
+ */
+void
+picmap::blit(const cell_buffer &source,
+             const screen_size &source_extent,
+             const rect        &from,
+             const point       &to)
+{
+  mCells.blit(get_size(),
+              source,
+              source_extent,
+              from,
+              to,
+              rect(0, 0, mArea.extent.width, mArea.extent.height));
 }
 
 // picmap.cpp ends here
@@ -0,0 +1,599 @@
+//
+// picpack.cpp --- Memory-mapped picture pack implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 11:11:42 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 11:11:42
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file picpack.cpp
+ * @author Paul Ward
+ * @brief Memory-mapped picture pack implementation.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "picpack.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief The magic number at the start of every pack.
+ */
+static const char PackMagic[4] = { 'O', 'V', 'P', 'K' };
+
+/**
+ * @brief The size of the pack header in bytes.
+ */
+static const std::size_t HeaderSize = 16;
+
+/**
+ * @brief The size of a table of contents entry in bytes.
+ */
+static const std::size_t EntrySize = 32;
+
+/**
+ * @brief Read a little-endian 16-bit word.
+ * @param data Where the word is.
+ */
+static inline
+std::uint16_t
+read16(const unsigned char *data)
+{
+  return __CAST(std::uint16_t, data[0] | (data[1] << 8));
+}
+
+/**
+ * @brief Read a little-endian 32-bit word.
+ * @param data Where the word is.
+ */
+static inline
+std::uint32_t
+read32(const unsigned char *data)
+{
+  return __CAST(std::uint32_t, read16(data)) |
+         (__CAST(std::uint32_t, read16(data + 2)) << 16);
+}
+
+/**
+ * @brief Append a little-endian 16-bit word.
+ * @param out The bytes to append to.
+ * @param value The word.
+ */
+static inline
+void
+write16(std::vector<unsigned char> &out, std::uint16_t value)
+{
+  out.push_back(__CAST(unsigned char, value & 0xFF));
+  out.push_back(__CAST(unsigned char, value >> 8));
+}
+
+/**
+ * @brief Append a little-endian 32-bit word.
+ * @param out The bytes to append to.
+ * @param value The word.
+ */
+static inline
+void
+write32(std::vector<unsigned char> &out, std::uint32_t value)
+{
+  write16(out, __CAST(std::uint16_t, value & 0xFFFF));
+  write16(out, __CAST(std::uint16_t, value >> 16));
+}
+
+/**
+ * @brief Overwrite a little-endian 32-bit word.
+ * @param out The bytes to change.
+ * @param at The offset of the word.
+ * @param value The word.
+ */
+static inline
+void
+patch32(std::vector<unsigned char> &out, std::size_t at, std::size_t value)
+{
+  out[at]     = __CAST(unsigned char, value & 0xFF);
+  out[at + 1] = __CAST(unsigned char, (value >> 8) & 0xFF);
+  out[at + 2] = __CAST(unsigned char, (value >> 16) & 0xFF);
+  out[at + 3] = __CAST(unsigned char, (value >> 24) & 0xFF);
+}
+
+/**
+ * @brief Pad with zero bytes up to a multiple of an alignment.
+ * @param out The bytes to pad.
+ * @param align The alignment, which must be a power of two.
+ */
+static inline
+void
+pad(std::vector<unsigned char> &out, std::size_t align)
+{
+  out.resize((out.size() + align - 1) & ~(align - 1), 0);
+}
+
+/**
+ * @brief Return the picture element at a given index.
+ * @param index The index of the picture element to obtain.
+ */
+achar
+picpack_image::get(std::size_t index) const
+{
+  return achar(__CAST(char_t, characters[index]), attr_t(attributes[index]));
+}
+
+/**
+ * @brief Copy the picture into a picture map.
+ * @param dest The picture map, which is resized to fit.
+ *
+ * This is only needed when a picture is to be changed; drawing it
+ * does not need a copy.
+ */
+void
+picpack_image::copy_to(picmap &dest) const
+{
+  screen_size extent(size);
+  std::size_t count = size.width * size.height;
+
+  dest.set_size(extent);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    dest.put(i, get(i));
+  }
+
+  dest.set_mask(mask);
+}
+
+/**
+ * @brief Constructor function.
+ */
+picpack::picpack()
+  : mData(0),
+    mBytes(0)
+#if defined(_WIN32)
+  , mFile(INVALID_HANDLE_VALUE),
+    mMapping(0)
+#endif
+{}
+
+/**
+ * @brief Destructor function.
+ */
+picpack::~picpack()
+{
+  close();
+}
+
+/**
+ * @brief Open a pack.
+ * @param path The path to the pack.
+ * @returns @c true if the pack was opened, or @c false if it could
+ *          not be mapped or is not a pack this version understands.
+ *
+ * Any pack that was already open is closed first, and every view
+ * taken from it becomes invalid.
+ */
+bool
+picpack::open(const std::string &path)
+{
+  close();
+
+  if (!map(path)) {
+    return false;
+  }
+
+  if (!read_contents()) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Close the pack.
+ */
+void
+picpack::close()
+{
+  mImages.clear();
+  unmap();
+}
+
+/**
+ * @brief Is a pack open?
+ */
+bool
+picpack::is_open() const
+{
+  return mData != 0;
+}
+
+/**
+ * @brief Return the number of pictures in the pack.
+ */
+std::size_t
+picpack::size() const
+{
+  return mImages.size();
+}
+
+/**
+ * @brief Return a picture by its position in the pack.
+ * @param index The position.
+ */
+const picpack_image &
+picpack::at(std::size_t index) const
+{
+  if (index >= mImages.size()) {
+    throw std::out_of_range("picpack::at");
+  }
+
+  return mImages[index];
+}
+
+/**
+ * @brief Find a picture by name.
+ * @param name The name of the picture.
+ * @returns The picture, or a null pointer if there is none by that
+ *          name.
+ */
+const picpack_image *
+picpack::find(const std::string &name) const
+{
+  for (std::size_t i = 0; i < mImages.size(); ++i) {
+    if (name == mImages[i].name) {
+      return &mImages[i];
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * @brief Map a file into memory.
+ * @param path The path to the file.
+ * @returns @c true if the file was mapped.
+ */
+bool
+picpack::map(const std::string &path)
+{
+#if defined(_WIN32)
+  LARGE_INTEGER bytes;
+  HANDLE        file;
+  HANDLE        mapping;
+  void         *view;
+
+  file = CreateFileA(path.c_str(),
+                     GENERIC_READ,
+                     FILE_SHARE_READ,
+                     NULL,
+                     OPEN_EXISTING,
+                     FILE_ATTRIBUTE_NORMAL,
+                     NULL);
+
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  if (!GetFileSizeEx(file, &bytes) || bytes.QuadPart == 0 ||
+      bytes.HighPart != 0)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if (mapping == NULL) {
+    CloseHandle(file);
+    return false;
+  }
+
+  view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (view == NULL) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  mFile    = file;
+  mMapping = mapping;
+  mData    = __CAST(const unsigned char *, view);
+  mBytes   = __CAST(std::size_t, bytes.LowPart);
+#else
+  struct stat info;
+  int         fd;
+  void       *view;
+
+  fd = ::open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  view = mmap(0, __CAST(std::size_t, info.st_size), PROT_READ, MAP_PRIVATE,
+              fd, 0);
+
+  // The mapping keeps the file open, so the descriptor is not
+  // needed any more.
+  ::close(fd);
+
+  if (view == MAP_FAILED) {
+    return false;
+  }
+
+  mData  = __CAST(const unsigned char *, view);
+  mBytes = __CAST(std::size_t, info.st_size);
+#endif
+
+  return true;
+}
+
+/**
+ * @brief Unmap the file, if one is mapped.
+ */
+void
+picpack::unmap()
+{
+  if (mData == 0) {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(mData);
+  CloseHandle(mMapping);
+  CloseHandle(mFile);
+
+  mFile    = INVALID_HANDLE_VALUE;
+  mMapping = 0;
+#else
+  munmap(const_cast<unsigned char *>(mData), mBytes);
+#endif
+
+  mData  = 0;
+  mBytes = 0;
+}
+
+/**
+ * @brief Check the header and read the table of contents.
+ * @returns @c true if the pack is sound.
+ *
+ * Every offset is checked against the size of the pack, so a
+ * truncated or damaged pack is turned away here rather than read
+ * past the end of the mapping later.
+ */
+bool
+picpack::read_contents()
+{
+  std::size_t contents;
+  std::size_t count;
+
+  if (mBytes < HeaderSize ||
+      std::memcmp(mData, PackMagic, sizeof(PackMagic)) != 0 ||
+      read16(mData + 4) < 1 || read16(mData + 4) > version ||
+      read32(mData + 12) != mBytes)
+  {
+    return false;
+  }
+
+  count    = read16(mData + 6);
+  contents = read32(mData + 8);
+
+  if (contents > mBytes || count > (mBytes - contents) / EntrySize) {
+    return false;
+  }
+
+  mImages.reserve(count);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const unsigned char *entry = mData + contents + i * EntrySize;
+    picpack_image        image;
+    std::uint64_t        cells;
+    std::uint64_t        bytes;
+    std::size_t          chars;
+    std::size_t          attrs;
+    std::size_t          mask;
+
+    // The name has to be terminated within its field.
+    if (entry[max_name] != '\0') {
+      return false;
+    }
+
+    image.name        = reinterpret_cast<const char *>(entry);
+    image.size.width  = read16(entry + 16);
+    image.size.height = read16(entry + 18);
+    chars             = read32(entry + 20);
+    attrs             = read32(entry + 24);
+    mask              = read32(entry + 28);
+
+    // The sizes are worked out in 64 bits, as the largest picture's
+    // planes would wrap a 32-bit size_t.
+    cells = __CAST(std::uint64_t, image.size.width) * image.size.height;
+    bytes = cells * 2;
+
+    if (((chars | attrs) & 1) != 0 ||
+        chars > mBytes || bytes > mBytes - chars ||
+        attrs > mBytes || bytes > mBytes - attrs)
+    {
+      return false;
+    }
+
+    // A version 1 pack has no masks, and this field is zero.
+    bytes = (cells + 63) / 64 * 8;
+
+    if (mask != 0 &&
+        ((mask & 7) != 0 || mask > mBytes || bytes > mBytes - mask))
+    {
+      return false;
+    }
+
+    // The planes are used as they are, so this relies on the
+    // machine being little-endian, as every machine with a Win32
+    // console is.
+    image.characters = reinterpret_cast<const std::uint16_t *>(mData + chars);
+    image.attributes = reinterpret_cast<const std::uint16_t *>(mData + attrs);
+    image.mask       = mask == 0 ? 0 :
+                       reinterpret_cast<const std::uint64_t *>(mData + mask);
+
+    mImages.push_back(image);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Add a picture to the pack.
+ * @param name The name of the picture, which is cut down to
+ *             @c picpack::max_name characters.
+ * @param source The picture.
+ */
+void
+picpack_writer::add(const std::string &name, const picmap &source)
+{
+  const cell_buffer &cells = source.cells();
+  entry              item;
+
+  item.name = name.substr(0, picpack::max_name);
+  item.size = source.get_size();
+
+  item.chars.reserve(cells.size());
+  item.attrs.reserve(cells.size());
+
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    std::uint32_t c = __CAST(uchar_t, cells.character(i));
+
+    item.chars.push_back(__CAST(std::uint16_t, c > 0xFFFF ? 0xFFFD : c));
+    item.attrs.push_back(cells.attribute(i));
+  }
+
+  if (source.has_mask()) {
+    item.mask.assign(source.mask(),
+                     source.mask() + (cells.size() + 63) / 64);
+  }
+
+  mEntries.push_back(item);
+}
+
+/**
+ * @brief Write the pack.
+ * @param path The path to write the pack to.
+ * @returns @c true if the pack was written.
+ *
+ * The pack is built up in memory and written in one go.  The table
+ * of contents is written first with empty offsets, which are filled
+ * in as the planes are laid out after it.
+ */
+bool
+picpack_writer::write(const std::string &path) const
+{
+  std::vector<unsigned char> out;
+  std::ofstream              file;
+
+  out.insert(out.end(), PackMagic, PackMagic + sizeof(PackMagic));
+  write16(out, picpack::version);
+  write16(out, __CAST(std::uint16_t, mEntries.size()));
+  write32(out, __CAST(std::uint32_t, HeaderSize));
+  write32(out, 0);                      // Size, filled in at the end.
+
+  for (std::size_t i = 0; i < mEntries.size(); ++i) {
+    const entry &item = mEntries[i];
+
+    out.insert(out.end(), item.name.begin(), item.name.end());
+    out.resize(out.size() + (16 - item.name.size()), 0);
+    write16(out, __CAST(std::uint16_t, item.size.width));
+    write16(out, __CAST(std::uint16_t, item.size.height));
+    write32(out, 0);                    // Character plane.
+    write32(out, 0);                    // Attribute plane.
+    write32(out, 0);                    // Mask, if there is one.
+  }
+
+  for (std::size_t i = 0; i < mEntries.size(); ++i) {
+    const entry &item  = mEntries[i];
+    std::size_t  toc   = HeaderSize + i * EntrySize;
+
+    pad(out, 4);
+    patch32(out, toc + 20, out.size());
+
+    for (std::size_t j = 0; j < item.chars.size(); ++j) {
+      write16(out, item.chars[j]);
+    }
+
+    pad(out, 4);
+    patch32(out, toc + 24, out.size());
+
+    for (std::size_t j = 0; j < item.attrs.size(); ++j) {
+      write16(out, item.attrs[j]);
+    }
+
+    if (!item.mask.empty()) {
+      pad(out, 8);
+      patch32(out, toc + 28, out.size());
+
+      for (std::size_t j = 0; j < item.mask.size(); ++j) {
+        write32(out, __CAST(std::uint32_t, item.mask[j] & 0xFFFFFFFF));
+        write32(out, __CAST(std::uint32_t, item.mask[j] >> 32));
+      }
+    }
+  }
+
+  pad(out, 4);
+  patch32(out, 12, out.size());
+
+  file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file.write(reinterpret_cast<const char *>(out.data()),
+             __CAST(std::streamsize, out.size()));
+
+  return file.good();
+}
+
+// picpack.cpp ends here
@@ -38,6 +38,8 @@
  * @brief Picture class implementation.
  */
  
+#include <algorithm>
+
 #include "screen.hpp"
 #include "drawbuffer.hpp"
 #include "picture.hpp"
@@ -48,15 +50,25 @@ using namespace ovision;
  * @brief Default constructor function.
  */
 picture::picture()
-  : view()
+  : view(),
+    mShared(0),
+    mImage(0),
+    mAnimation(0),
+    mFrame(0),
+    mTarget(0)
 {}
 
 /**
  * @brief Constructor function.
  * @param area A rectangle that defines the views extents.
  */
-picture::picture(rect &area)
-  : view(area)
+picture::picture(const rect &area)
+  : view(area),
+    mShared(0),
+    mImage(0),
+    mAnimation(0),
+    mFrame(0),
+    mTarget(0)
 {
   mContent.set_size(screen_size(mInnerRect.extent.width,
                                 mInnerRect.extent.height));
@@ -69,19 +81,180 @@ picture::picture(rect &area)
 void
 picture::set_picmap(const picmap &data)
 {
-  mContent = data;
+  mContent   = data;
+  mShared    = 0;
+  mImage     = 0;
+  mAnimation = 0;
+  invalidate();
+}
+
+/**
+ * @brief Show a picture map without copying it.
+ * @param data The picture map data.
+ *
+ * The view only keeps a pointer, so the picture map has to outlive
+ * the view and must not change while it is shown.  This is meant
+ * for pictures that are composed once and then kept.
+ */
+void
+picture::share_picmap(const picmap &data)
+{
+  mShared    = &data;
+  mImage     = 0;
+  mAnimation = 0;
+  invalidate();
+}
+
+/**
+ * @brief Show a picture from a pack without copying it.
+ * @param data The picture.
+ *
+ * The picture is drawn straight out of the pack, so the pack has to
+ * stay open for as long as the view shows it.
+ */
+void
+picture::share_image(const picpack_image &data)
+{
+  mImage     = &data;
+  mShared    = 0;
+  mAnimation = 0;
+  invalidate();
 }
 
 /**
  * @brief Get the picture map data.
  * @returns The picture map data.
+ *
+ * A shared picture map or pack picture is copied first, so that it
+ * is never changed through the view.  An animation stops, as its
+ * deltas would no longer match the picture.  Call @c invalidate
+ * after changing the picture through this, as the view cannot tell
+ * that it has changed.
  */
 picmap &
 picture::get_picmap()
 {
+  if (mShared != 0) {
+    mContent = *mShared;
+    mShared  = 0;
+  }
+
+  if (mImage != 0) {
+    mImage->copy_to(mContent);
+    mImage = 0;
+  }
+
+  mAnimation = 0;
+
   return mContent;
 }
 
+/**
+ * @brief Show a frame of an animation.
+ * @param anim The animation, which has to outlive the view.
+ * @param index The frame to show.
+ *
+ * The keyframe is copied into the view, and then moved on to the
+ * frame asked for.  From then on, the view changes frame by
+ * applying just the cells that differ.
+ */
+void
+picture::set_animation(const animation &anim, std::size_t index)
+{
+  mContent   = anim.get_keyframe();
+  mShared    = 0;
+  mImage     = 0;
+  mAnimation = &anim;
+  mFrame     = 0;
+  mTarget    = 0;
+
+  invalidate();
+  seek(index);
+}
+
+/**
+ * @brief Jump straight to a frame of the animation.
+ * @param index The frame.
+ *
+ * Only the area covered by the frames passed through is redrawn.
+ */
+void
+picture::seek(std::size_t index)
+{
+  if (mAnimation == 0) {
+    return;
+  }
+
+  mTarget = std::min(index, mAnimation->size() - 1);
+
+  while (step()) {
+    // Keep stepping.
+  }
+}
+
+/**
+ * @brief Play the animation towards a frame.
+ * @param index The frame to stop at.
+ *
+ * Each call to @c step moves one frame nearer, forwards or
+ * backwards.  An idle callback is the place to call it from.
+ */
+void
+picture::play_to(std::size_t index)
+{
+  if (mAnimation != 0) {
+    mTarget = std::min(index, mAnimation->size() - 1);
+  }
+}
+
+/**
+ * @brief Move the animation one frame nearer its target.
+ * @returns @c true if the frame changed, or @c false if there is no
+ *          animation or it is already at its target.
+ */
+bool
+picture::step()
+{
+  rect changed;
+
+  if (mAnimation == 0 || mFrame == mTarget) {
+    return false;
+  }
+
+  if (mFrame < mTarget) {
+    changed = mAnimation->forward(mContent, mFrame++);
+  } else {
+    changed = mAnimation->backward(mContent, mFrame--);
+  }
+
+  if (changed.area() > 0) {
+    invalidate(rect(mInnerRect.left() + changed.left(),
+                    mInnerRect.top()  + changed.top(),
+                    changed.extent.width,
+                    changed.extent.height));
+  }
+
+  return true;
+}
+
+/**
+ * @brief Is the animation still moving towards its target?
+ */
+bool
+picture::is_playing() const
+{
+  return mAnimation != 0 && mFrame != mTarget;
+}
+
+/**
+ * @brief Return the animation frame shown.
+ */
+std::size_t
+picture::get_frame() const
+{
+  return mFrame;
+}
+
 /**
  * @brief Fill the view.
  * @param attr The attribute to fill with.
@@ -89,34 +262,85 @@ picture::get_picmap()
 void
 picture::fill(attr_t attr)
 {
-  mContent.fill(screen_point(0, 0), attr);
+  get_picmap().fill(screen_point(0, 0), attr);
+  invalidate();
+}
+
+/**
+ * @brief Is a cell of a picture opaque?
+ * @param mask The picture's mask, or null if it has none.
+ * @param index The offset of the cell in the picture.
+ */
+static inline
+bool
+opaque_at(const std::uint64_t *mask, std::size_t index)
+{
+  return mask == 0 || ((mask[index / 64] >> (index % 64)) & 1) != 0;
 }
 
 /**
  * @brief Render the view.
+ *
+ * The picture is copied into the inner rectangle of the view, and
+ * clipped to it.  The view is drawn around the picture, and under a
+ * masked picture only its transparent cells are filled in, so that
+ * no cell is written twice.
  */
 void
 picture::render()
 {
-  extern draw_buffer GlobalDrawBuffer;
-  std::size_t        left   = mInnerRect.left();
-  std::size_t        right  = mInnerRect.right();
-  std::size_t        top    = mInnerRect.top();
-  std::size_t        bottom = mInnerRect.bottom();
-  std::size_t        width  = screen::get_instance().get_columns();
-  std::size_t        height = screen::get_instance().get_rows();
-  std::size_t        pos    = 0;
-  std::size_t        idx    = 0;
-
-  view::render();
-
-  for (std::size_t y = top; y < bottom; ++y) {
-    for (std::size_t x = left; x < right; ++x) {  
-      pos = x + y * width;
-
-      GlobalDrawBuffer.put_char(pos, mContent.at(idx++));
+  const picmap        &content = mShared != 0 ? *mShared : mContent;
+  screen_size          extent  = mImage != 0
+                                   ? mImage->size
+                                   : content.get_size();
+  const std::uint64_t *mask    = mImage != 0 ? mImage->mask : content.mask();
+  point                to(mInnerRect.left(), mInnerRect.top());
+  rect                 from(0,
+                            0,
+                            __CAST(signed, extent.width),
+                            __CAST(signed, extent.height));
+  rect                 shown(mInnerRect.left(),
+                             mInnerRect.top(),
+                             std::min(__CAST(signed, extent.width),
+                                      mInnerRect.extent.width),
+                             std::min(__CAST(signed, extent.height),
+                                      mInnerRect.extent.height));
+
+  render_around(shown);
+
+  // The inside of the view is blank, so the cells that show through
+  // a masked picture are filled a run at a time.
+  for (signed y = 0; mask != 0 && y < shown.extent.height; ++y) {
+    std::size_t row = __CAST(std::size_t, y) * extent.width;
+    signed      x   = 0;
+
+    while (x < shown.extent.width) {
+      signed start = x;
+
+      while (x < shown.extent.width && !opaque_at(mask, row + x)) {
+        ++x;
+      }
+
+      if (x > start) {
+        canvas().fill(rect(shown.left() + start,
+                           shown.top() + y,
+                           x - start,
+                           1),
+                      mInnerAttr,
+                      true);
+      }
+
+      while (x < shown.extent.width && opaque_at(mask, row + x)) {
+        ++x;
+      }
     }
   }
+
+  if (mImage != 0) {
+    canvas().blit(*mImage, from, to, mInnerRect);
+  } else {
+    canvas().blit(content, from, to, mInnerRect);
+  }
 }
 
 // picture.cpp ends here
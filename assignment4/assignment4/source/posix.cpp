@@ -45,18 +45,25 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <stdexcept>
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-#include <Shlwapi.h>
-#include <psapi.h>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+# include <Shlwapi.h>
+# include <psapi.h>
 
-#pragma comment(lib, "shlwapi.lib")
-#pragma comment(lib, "psapi.lib")
+# pragma comment(lib, "shlwapi.lib")
+# pragma comment(lib, "psapi.lib")
+#else
+# include <cerrno>
+# include <cwchar>
+#endif
 
 #include "types.hpp"
 #include "compiler.hpp"
 #include "posix.hpp"
+#include "arena.hpp"
 
 /**
  * @brief Strip directory, suffix, and extension from file names.
@@ -71,6 +78,7 @@ posix::basename(TCHAR *path, const bool stripExt)
 {
   TCHAR *strptr = path;
   
+#if defined(_WIN32)
   // Strip the file extension, if required.
   if (stripExt) {
     PathRemoveExtension(strptr);
@@ -78,6 +86,21 @@ posix::basename(TCHAR *path, const bool stripExt)
 
   // Extract the file name component.
   strptr = PathFindFileName(strptr);
+#else
+  TCHAR *found = std::wcsrchr(strptr, L'/');
+
+  // Extract the file name component.
+  if (found != 0) {
+    strptr = found + 1;
+  }
+
+  // Strip the file extension, if required.  A leading dot names a
+  // hidden file rather than starting an extension.
+  found = std::wcsrchr(strptr, L'.');
+  if (stripExt && found != 0 && found != strptr) {
+    *found = L'\0';
+  }
+#endif
 
   // Return it.
   return strptr;
@@ -94,6 +117,8 @@ const TCHAR *
 posix::getprogname()
 {
   static TCHAR THE_PROGRAM_NAME[MAX_PATH];
+
+#if defined(_WIN32)
   HANDLE       hProcess = GetCurrentProcess();
 
   /*
@@ -114,10 +139,67 @@ posix::getprogname()
   CloseHandle(hProcess);
     
   return (const TCHAR *)basename(THE_PROGRAM_NAME);
+#else
+  // The C library already keeps the name the program was run as.
+# if defined(__GLIBC__)
+  const char  *name = program_invocation_short_name;
+# else
+  const char  *name = ::getprogname();
+# endif
+
+  if (std::mbstowcs(THE_PROGRAM_NAME, name, MAX_PATH - 1) ==
+      __CAST(std::size_t, -1))
+  {
+    throw std::runtime_error("Could not get program name.");
+  }
+  THE_PROGRAM_NAME[MAX_PATH - 1] = L'\0';
+
+  return THE_PROGRAM_NAME;
+#endif
 }
 
-#pragma warning (push)
-#pragma warning (disable : 4996)
+#if !defined(_WIN32)
+/**
+ * @brief Rewrite a Microsoft-style wide format for the C library.
+ * @param fmt The format string.
+ * @param out Where the rewritten format goes.
+ *
+ * Microsoft's wide printf family takes @c %s and @c %c to mean wide
+ * strings and characters, which is what every caller here passes.
+ * The C library reads them as narrow, and wants @c %ls and @c %lc.
+ */
+template <class _String>
+static
+void
+widen_format(const TCHAR *fmt, _String &out)
+{
+  for (; *fmt != L'\0'; ++fmt) {
+    out += *fmt;
+
+    if (*fmt != L'%') {
+      continue;
+    }
+
+    // Copy the flags, width and precision, then look at the type.
+    while (std::wcschr(L"-+ #0123456789.*", fmt[1]) != 0 &&
+           fmt[1] != L'\0')
+    {
+      out += *++fmt;
+    }
+
+    if (fmt[1] == L's' || fmt[1] == L'c') {
+      out += L'l';
+    } else if (fmt[1] == L'%') {
+      out += *++fmt;
+    }
+  }
+}
+#endif
+
+#if defined(_MSC_VER)
+# pragma warning (push)
+# pragma warning (disable : 4996)
+#endif
 /**
  * @brief Display a formatted warning message.
  * @param fmt The format string.
@@ -143,16 +225,39 @@ posix::getprogname()
 void
 posix::vwarn(const TCHAR *fmt, va_list args)
 {
-  std::vector<TCHAR> buffer(100, '\0');
+  // The buffer comes from the frame arena, so a warning issued
+  // while the game is running does not go to the heap.
+  std::vector<TCHAR, ovision::arena_allocator<TCHAR>> buffer(100, '\0');
+
+#if !defined(_WIN32)
+  std::basic_string<TCHAR,
+                    std::char_traits<TCHAR>,
+                    ovision::arena_allocator<TCHAR>>  format;
+
+  widen_format(fmt, format);
+  fmt = format.c_str();
+#endif
     
   // Loop forever
   while (true) {     
+    va_list pass;
+
+    // Each attempt needs its own copy of the arguments; on some ABIs
+    // formatting them consumes the list.
+#if defined(va_copy)
+    va_copy(pass, args);
+#else
+    pass = args;
+#endif
+
     // This is the meat of the function, and uses a hack to succeed.
     // We treat a vector of characters as a C string. 
     auto n = _vsntprintf((TCHAR *)buffer.data(),
                            buffer.size(),
                            fmt,
-                           args);
+                           pass);
+
+    va_end(pass);
       
     // Has the vsnprintf operation succeeded in the amount of space we
     // have set aside for it?
@@ -185,7 +290,9 @@ posix::vwarn(const TCHAR *fmt, va_list args)
 #endif
     << getprogname() << ": " << buffer.data() << std::endl;
 }
-#pragma warning (pop)
+#if defined(_MSC_VER)
+# pragma warning (pop)
+#endif
 
 /**
  * @brief Display a formatted warning message.
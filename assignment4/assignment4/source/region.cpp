@@ -0,0 +1,300 @@
+//
+// region.cpp --- Rectangular screen region implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 14:20:53 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 14:20:53
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file region.cpp
+ * @author Paul Ward
+ * @brief Rectangular screen region implementation.
+ */
+
+#include <algorithm>
+
+#include "region.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Does a rectangle cover no cells?
+ * @param area The rectangle.
+ */
+static
+bool
+no_cells(const rect &area)
+{
+  return area.right() <= area.left() || area.bottom() <= area.top();
+}
+
+/**
+ * @brief Add the parts of a rectangle outside an area to a vector.
+ * @param r The rectangle.
+ * @param area The area to cut out of it.
+ * @param out The vector to add the pieces to.
+ *
+ * The rectangle is replaced by up to four pieces: the rows above
+ * and below the area, and the parts of the rows alongside it to the
+ * left and right.
+ */
+static
+void
+cut_rect(const rect &r, const rect &area, region::rect_vector &out)
+{
+  if (!r.touches(area)) {
+    out.push_back(r);
+    return;
+  }
+
+  signed top    = std::max(r.top(), area.top());
+  signed bottom = std::min(r.bottom(), area.bottom());
+
+  if (area.top() > r.top()) {
+    out.push_back(rect(r.left(),
+                       r.top(),
+                       r.extent.width,
+                       area.top() - r.top()));
+  }
+
+  if (area.bottom() < r.bottom()) {
+    out.push_back(rect(r.left(),
+                       area.bottom(),
+                       r.extent.width,
+                       r.bottom() - area.bottom()));
+  }
+
+  if (area.left() > r.left()) {
+    out.push_back(rect(r.left(),
+                       top,
+                       area.left() - r.left(),
+                       bottom - top));
+  }
+
+  if (area.right() < r.right()) {
+    out.push_back(rect(area.right(),
+                       top,
+                       r.right() - area.right(),
+                       bottom - top));
+  }
+}                                       // cut_rect
+
+/**
+ * @brief Default constructor function.
+ */
+region::region()
+  : mRects(),
+    mScratch(),
+    mPieces()
+{}
+
+/**
+ * @brief Constructor function.
+ * @param area The initial area of the region.
+ */
+region::region(const rect &area)
+  : mRects(),
+    mScratch(),
+    mPieces()
+{
+  if (!no_cells(area)) {
+    mRects.push_back(area);
+  }
+}
+
+/**
+ * @brief Copy constructor function.
+ * @param other The region to copy.
+ *
+ * Only the rectangles are copied; the scratch vectors are not.
+ */
+region::region(const region &other)
+  : mRects(other.mRects),
+    mScratch(),
+    mPieces()
+{}
+
+/**
+ * @brief Copy assignment function.
+ * @param other The region to copy.
+ *
+ * The rectangles are copied into the storage this region already
+ * has, so assigning to a reused region does not allocate.
+ */
+region &
+region::operator = (const region &other)
+{
+  if (this != &other) {
+    mRects.assign(other.mRects.begin(), other.mRects.end());
+  }
+
+  return *this;
+}
+
+/**
+ * @brief Is the region empty?
+ */
+bool
+region::empty() const
+{
+  return mRects.empty();
+}
+
+/**
+ * @brief Return the number of rectangles in the region.
+ */
+std::size_t
+region::size() const
+{
+  return mRects.size();
+}
+
+/**
+ * @brief Return the number of cells in the region.
+ */
+std::size_t
+region::area() const
+{
+  std::size_t cells = 0;
+
+  for (std::size_t i = 0; i < mRects.size(); ++i) {
+    cells += __CAST(std::size_t, mRects[i].extent.width) *
+             __CAST(std::size_t, mRects[i].extent.height);
+  }
+
+  return cells;
+}
+
+/**
+ * @brief Return one of the rectangles in the region.
+ * @param idx The index of the rectangle.
+ */
+const rect &
+region::operator [] (std::size_t idx) const
+{
+  return mRects[idx];
+}
+
+/**
+ * @brief Empty the region.
+ */
+void
+region::clear()
+{
+  mRects.clear();
+}
+
+/**
+ * @brief Add an area to the region.
+ * @param area The area to add.
+ *
+ * Only the parts of the area not already in the region are added,
+ * so the rectangles stay apart.
+ */
+void
+region::add(const rect &area)
+{
+  if (no_cells(area)) {
+    return;
+  }
+
+  mPieces.clear();
+  mPieces.push_back(area);
+
+  for (std::size_t i = 0; i < mRects.size() && !mPieces.empty(); ++i) {
+    mScratch.clear();
+
+    for (std::size_t j = 0; j < mPieces.size(); ++j) {
+      cut_rect(mPieces[j], mRects[i], mScratch);
+    }
+
+    mPieces.swap(mScratch);
+  }
+
+  mRects.insert(mRects.end(), mPieces.begin(), mPieces.end());
+}
+
+/**
+ * @brief Remove an area from the region.
+ * @param area The area to remove.
+ */
+void
+region::subtract(const rect &area)
+{
+  if (no_cells(area)) {
+    return;
+  }
+
+  mScratch.clear();
+
+  for (std::size_t i = 0; i < mRects.size(); ++i) {
+    cut_rect(mRects[i], area, mScratch);
+  }
+
+  mRects.swap(mScratch);
+}
+
+/**
+ * @brief Reduce the region to the parts inside an area.
+ * @param area The area to keep.
+ */
+void
+region::intersect(const rect &area)
+{
+  std::size_t kept = 0;
+
+  for (std::size_t i = 0; i < mRects.size(); ++i) {
+    if (mRects[i].touches(area)) {
+      mRects[kept++] = mRects[i] & area;
+    }
+  }
+
+  mRects.resize(kept);
+}
+
+/**
+ * @brief Does any of the region touch an area?
+ * @param area The area to test.
+ */
+bool
+region::touches(const rect &area) const
+{
+  for (std::size_t i = 0; i < mRects.size(); ++i) {
+    if (mRects[i].touches(area)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// region.cpp ends here
@@ -43,12 +43,147 @@
 #include <cstdlib>
 #include <utility>
 #include <numeric>
+#include <algorithm>
 
-#include "posix.hpp"
+#include "arena.hpp"
 #include "screen.hpp"
 
 using namespace ovision;
 
+/**
+ * @brief Returns the singleton class instance.
+ */
+screen &
+screen::get_instance()
+{
+  static screen sInstance;
+
+  return sInstance;
+}
+
+/**
+ * @brief Default constructor function.
+ */
+screen::screen()
+  : mLastResizeToken(0)
+{}
+
+/**
+ * @brief Is the cursor disabled?
+ */
+bool
+screen::cursor_disabled()
+{
+  return mCursorDisabled;
+}
+
+/**
+ * @brief Forget what we last presented.
+ *
+ * The next call to @c render_buffer will write the whole frame.
+ */
+void
+screen::invalidate_buffer()
+{
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Return the presentation counters.
+ */
+const present_stats &
+screen::get_present_stats() const
+{
+  return mShadow.stats();
+}
+
+/**
+ * @brief Reset the presentation counters.
+ */
+void
+screen::reset_present_stats()
+{
+  mShadow.reset_stats();
+}
+
+/**
+ * @brief Add a callback for `screen resized' events.
+ * @param fn The function to add.
+ * @returns A token to pass to @c remove_resize_callback once the
+ *          callback, or whatever it refers to, goes away.
+ * @see resize_callback_t
+ */
+screen::resize_token_t
+screen::add_resize_callback(resize_callback_t fn)
+{
+  mResizeCallbacks.push_back(std::make_pair(++mLastResizeToken, fn));
+
+  return mLastResizeToken;
+}
+
+/**
+ * @brief Remove a callback for `screen resized' events.
+ * @param token The token @c add_resize_callback returned for it.
+ *
+ * Removing a callback that has already gone does nothing.
+ */
+void
+screen::remove_resize_callback(resize_token_t token)
+{
+  for (std::size_t fn = 0; fn < mResizeCallbacks.size(); ++fn) {
+    if (mResizeCallbacks[fn].first == token) {
+      mResizeCallbacks.erase(mResizeCallbacks.begin() + fn);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Return the number of geometry system calls made.
+ *
+ * The geometry is cached, and only queried when the screen is
+ * resized, so this should not move while the screen is left alone.
+ */
+std::size_t
+screen::get_geometry_queries() const
+{
+  return mGeometryQueries;
+}
+
+/**
+ * @brief Reset the geometry system call counter.
+ */
+void
+screen::reset_geometry_queries()
+{
+  mGeometryQueries = 0;
+}
+
+/**
+ * @brief Tell everyone who is interested that the geometry changed.
+ *
+ * Whatever was on the screen can no longer be trusted, so the next
+ * frame is presented in full.
+ */
+void
+screen::notify_resize()
+{
+  screen_size extent = get_size();
+
+  mShadow.invalidate();
+
+  for (std::size_t fn = 0; fn < mResizeCallbacks.size(); ++fn) {
+    mResizeCallbacks[fn].second(extent);
+  }
+}
+
+// The rest of this file is the Win32 console back end.  The VT
+// terminal back end can be found in screen_vt.cpp, and the headless
+// one in screen_headless.cpp.
+#if defined(OVISION_WIN32)
+
+#include "posix.hpp"
+
 /**
  * @brief Default Windows console mode flags.
  */
@@ -72,14 +207,26 @@ screen::ensure_capacity(std::size_t count)
 }
 
 /**
- * @brief Returns the singleton class instance.
+ * @brief Query the console screen buffer.
+ * @param info Where to put the screen buffer information.
+ * @returns Whatever @c GetConsoleScreenBufferInfo returns.
+ *
+ * Every geometry query goes through here so that it is counted, and
+ * so that the cached geometry is kept up to date.
  */
-screen &
-screen::get_instance()
+BOOL
+screen::query_geometry(CONSOLE_SCREEN_BUFFER_INFO *info)
 {
-  static screen sInstance;
+  BOOL res = GetConsoleScreenBufferInfo(mHOutput, info);
 
-  return sInstance;
+  mGeometryQueries++;
+
+  if (res) {
+    mGeometry = screen_size(__CAST(std::size_t, info->dwSize.X),
+                            __CAST(std::size_t, info->dwSize.Y));
+  }
+
+  return res;
 }
 
 /**
@@ -100,12 +247,6 @@ screen::call_console_event_handler(DWORD dwCtrlType)
   return screen::get_instance().console_event_handler(dwCtrlType);
 }
 
-/**
- * @brief Default constructor function.
- */
-screen::screen()
-{}
-
 /**
  * @brief Initialise the Windows console.
  */
@@ -131,6 +272,9 @@ screen::init()
   }
   
   mInitialised = true;
+
+  CONSOLE_SCREEN_BUFFER_INFO info;
+  query_geometry(&info);
   
   GetConsoleMode(mHInput, &mSavedConsoleMode);
   SetConsoleCtrlHandler(screen::call_console_event_handler, TRUE);
@@ -141,6 +285,7 @@ screen::init()
   mOldTitle = string_t(oldTitle);
   
   set_size(screen_size(80, 25));
+  mShadow.invalidate();
   
   if (mCursorDisabled) {
     disable_cursor();
@@ -191,6 +336,8 @@ screen::resume()
 
   SetConsoleCtrlHandler(screen::call_console_event_handler, TRUE);
   SetConsoleMode(mHInput, DEFAULT_CONSOLE_MODE);
+
+  mShadow.invalidate();
 }
 
 /**
@@ -215,6 +362,8 @@ screen::clear_screen() const
                                get_size().offset(),
                                coord,
                                &cWritten);
+
+    mShadow.invalidate();
   }
 }
 
@@ -224,15 +373,7 @@ screen::clear_screen() const
 std::size_t
 screen::get_columns() const
 {
-  if (mInitialised) {
-    CONSOLE_SCREEN_BUFFER_INFO info;
-
-    GetConsoleScreenBufferInfo(mHOutput, &info);
-
-    return __CAST(std::size_t, info.dwSize.X);
-  }
-
-  return 80;
+  return get_size().width;
 }
 
 /**
@@ -241,36 +382,43 @@ screen::get_columns() const
 std::size_t
 screen::get_rows() const
 {
-  if (mInitialised) {
-    CONSOLE_SCREEN_BUFFER_INFO info;
-
-    GetConsoleScreenBufferInfo(mHOutput, &info);
-
-    return __CAST(std::size_t, info.dwSize.Y);
-  }
-
-  return 25;
+  return get_size().height;
 }
 
 /**
  * @brief Return the number of character cells the console can
  * address.
+ *
+ * This is cached, and only refreshed when the console tells us that
+ * the screen buffer has been resized.
  */
 screen_size 
 screen::get_size() const
 {
   if (mInitialised) {
-    CONSOLE_SCREEN_BUFFER_INFO info;
-
-    GetConsoleScreenBufferInfo(mHOutput, &info);
-
-    return screen_size(__CAST(std::size_t, info.dwSize.X),
-                       __CAST(std::size_t, info.dwSize.Y));
+    return mGeometry;
   }
 
   return screen_size(80, 25);
 }
 
+/**
+ * @brief The console screen buffer has been resized.
+ * @param extent The new size of the screen buffer.
+ *
+ * This is called by the keyboard when it reads a
+ * @c WINDOW_BUFFER_SIZE_EVENT from the console input queue.
+ */
+void
+screen::buffer_resized(const screen_size &extent)
+{
+  if (mInitialised && extent != mGeometry) {
+    mGeometry = extent;
+
+    notify_resize();
+  }
+}
+
 // DANGER * DANGER * DANGER * DANGER * DANGER * DANGER * DANGER * DANGER
 //
 // The logic flow of this function is dangerous for your health.  Please
@@ -332,10 +480,9 @@ fake_recurse:
 
   if (mInitialised) {
     CONSOLE_SCREEN_BUFFER_INFO info;
-    extern draw_buffer         GlobalDrawBuffer;
 
     // Try to get the console buffer info.
-    if (!GetConsoleScreenBufferInfo(mHOutput, &info)) {
+    if (!query_geometry(&info)) {
       // Not a console, bye.
       return;
     }
@@ -404,7 +551,7 @@ fake_recurse:
 
     // Test it.
     // Try to get the console buffer info.
-    GetConsoleScreenBufferInfo(mHOutput, &info);
+    query_geometry(&info);
 
     if (info.srWindow.Right  < __CAST(SHORT, extent.width) ||
         info.srWindow.Bottom < __CAST(SHORT, extent.height))
@@ -415,7 +562,7 @@ fake_recurse:
     }
 
 give_up:
-    GlobalDrawBuffer.resize();
+    notify_resize();
     recurseTries = 0;
   }                                     // if (mInitialised)
 }                                       // screen::set_size
@@ -516,23 +663,21 @@ screen::get_character(const screen_point &pos) const
 astring
 screen::get_characters(const screen_point &pos, std::size_t count)
 {
-  COORD    coord;
-  DWORD    cRead;
-  WORD    *attr;
-  TCHAR   *ch;
-  astring  res;
+  frame_arena &arena = frame_arena::get_current();
+  COORD        coord;
+  DWORD        cRead;
+  WORD        *attr;
+  TCHAR       *ch;
+  astring      res;
 
   res.reserve(count);
 
-  if ((attr = (WORD *)malloc(sizeof(WORD) * count)) == NULL) {
-    shutdown();
-    perror("Out of memory.");
-  }
-
-  if ((ch = (TCHAR *)malloc(sizeof(TCHAR) * count)) == NULL) {
-    shutdown();
-    perror("Out of memory.");
-  }
+  // The arrays are only needed until the cells are copied out, so
+  // they come from the frame arena rather than the heap.
+  attr = __CAST(WORD *, arena.allocate(sizeof(WORD) * count,
+                                       std::alignment_of<WORD>::value));
+  ch   = __CAST(TCHAR *, arena.allocate(sizeof(TCHAR) * count,
+                                        std::alignment_of<TCHAR>::value));
 
   coord.Y = __CAST(SHORT, pos.x);
   coord.X = __CAST(SHORT, pos.y);
@@ -540,12 +685,12 @@ screen::get_characters(const screen_point &pos, std::size_t count)
   ReadConsoleOutputAttribute(mHOutput, attr, count, coord, &cRead);
   ReadConsoleOutputCharacter(mHOutput, ch, count, coord, &cRead);
 
-  for (count = 0; count < cRead; count++) {
-    res.push_back(achar(ch[count], attr[count]));
+  for (DWORD i = 0; i < cRead; i++) {
+    res.push_back(achar(ch[i], attr[i]));
   }
 
-  free(attr);
-  free(ch);
+  arena.deallocate(ch, sizeof(TCHAR) * count);
+  arena.deallocate(attr, sizeof(WORD) * count);
 
   return res;
 }
@@ -563,8 +708,7 @@ screen::set_character(const screen_point &pos, achar value)
   COORD      dwBufferSize  = { 1, 1 };
   COORD      dwBufferCoord = { 0, 0 };
   SMALL_RECT region;
-
-  ensure_capacity(1);
+  CHAR_INFO  cell;
 
   coord.Y = __CAST(short, pos.x);
   coord.X = __CAST(short, pos.y);
@@ -573,18 +717,22 @@ screen::set_character(const screen_point &pos, achar value)
   region.Left = region.Right  = coord.X;
 
 #if defined(OVISION_UNICODE)
-  mOutputBufferCI[0].Char.UnicodeChar = value.character;
+  cell.Char.UnicodeChar = value.character;
 #else
-  mOutputBufferCI[0].Char.AsciiChar   = value.character;
+  cell.Char.AsciiChar   = value.character;
 #endif
 
-  mOutputBufferCI[0].Attributes = __CAST(WORD, value.attribute.to_ulong());
+  cell.Attributes = __CAST(WORD, value.attribute.to_ulong());
 
   WriteConsoleOutput(mHOutput,
-                     mOutputBufferCI,
+                     &cell,
                      dwBufferSize,
                      dwBufferCoord,
                      &region);
+
+  // The console no longer matches the shadow, so the next frame has
+  // to be presented in full.
+  mShadow.invalidate();
 }
 
 /**
@@ -596,15 +744,6 @@ screen::input_handle()
   return mHInput;
 }
 
-/**
- * @brief Is the cursor disabled?
- */
-bool
-screen::cursor_disabled()
-{
-  return mCursorDisabled;
-}
-
 /**
  * @brief Set the title of the console window.
  * @param title The new title to use.
@@ -631,32 +770,86 @@ screen::restore_title()
 /**
  * @brief Renders a @c draw_buffer to the console.
  * @param buffer The buffer to render.
+ *
+ * The buffer is compared against the shadow of the last frame we
+ * presented, and only the changed cells are converted and written.
+ * Spans on consecutive rows are merged into a single rectangle so
+ * that a block of changes costs one @c WriteConsoleOutput call.
+ *
+ * The conversion buffer is only ever updated for changed cells, so
+ * it always mirrors the shadow.  This means cells inside a merged
+ * rectangle that did not change still hold the right values.
+ *
+ * With @c OVISION_DRAWBUFFER_PACKED defined, the draw buffer's cells
+ * already have the layout of a @c CHAR_INFO, so they are handed to
+ * the console as they are and there is no conversion at all.
  */
 void
 screen::render_buffer(draw_buffer &buffer)
 {
-  COORD      size  = { get_columns(), get_rows() };
-  COORD      coord = { 0, 0 };
-  SMALL_RECT wr    = { 0, 0, get_columns(), get_rows() };
+  screen_size        extent = buffer.get_size();
+  COORD              size   = { __CAST(SHORT, extent.width),
+                                __CAST(SHORT, extent.height) };
+  const cell_buffer &cells  = buffer.cells();
+  std::size_t        first  = 0;
+  std::size_t        last   = 0;
+
+  const std::vector<dirty_span> &spans = mShadow.diff(buffer);
+
+#if defined(OVISION_DRAWBUFFER_PACKED) && !defined(OVISION_DRAWBUFFER_SOA)
+  const CHAR_INFO *output = cells.char_info();
+#else
+  const CHAR_INFO *output = 0;
 
   ensure_capacity(buffer.size());
 
-  for (std::size_t i = 0; i < buffer.size(); ++i) {
-    mOutputBufferCI[i].Char.UnicodeChar = buffer.data()[i].character;
-    mOutputBufferCI[i].Attributes       = 
-      __CAST(WORD, buffer.data()[i].attribute.to_ulong());
+  for (std::size_t i = 0; i < spans.size(); ++i) {
+    std::size_t base = spans[i].row * extent.width;
+
+    for (std::size_t x = spans[i].left; x < spans[i].right; ++x) {
+      mOutputBufferCI[base + x].Char.UnicodeChar = cells.character(base + x);
+      mOutputBufferCI[base + x].Attributes       = cells.attribute(base + x);
+    }
   }
 
-  WriteConsoleOutput(mHOutput,
-                     mOutputBufferCI,
-                     size,
-                     coord,
-                     &wr);
+  output = mOutputBufferCI;
+#endif
+
+  while (first < spans.size()) {
+    std::size_t left  = spans[first].left;
+    std::size_t right = spans[first].right;
+
+    for (last = first;
+         last + 1 < spans.size() && spans[last + 1].row == spans[last].row + 1;
+         ++last)
+    {
+      left  = std::min(left,  spans[last + 1].left);
+      right = std::max(right, spans[last + 1].right);
+    }
+
+    COORD      coord = { __CAST(SHORT, left),
+                         __CAST(SHORT, spans[first].row) };
+    SMALL_RECT wr    = { __CAST(SHORT, left),
+                         __CAST(SHORT, spans[first].row),
+                         __CAST(SHORT, right - 1),
+                         __CAST(SHORT, spans[last].row) };
+
+    WriteConsoleOutput(mHOutput,
+                       output,
+                       size,
+                       coord,
+                       &wr);
+
+    mShadow.record_write((right - left) *
+                         (spans[last].row - spans[first].row + 1));
+
+    first = last + 1;
+  }
 
   if (mCursorDisabled) {
     disable_cursor();
   }
-}
+}                                       // screen::render_buffer
 
 /**
  * @brief Handles control code events.
@@ -676,4 +869,6 @@ screen::console_event_handler(DWORD dwCtrlType)
   return FALSE;
 }
 
+#endif // OVISION_WIN32
+
 // screen.cpp ends here
@@ -0,0 +1,403 @@
+//
+// screen_headless.cpp --- Headless screen handling.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 17:29:10 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 17:29:10
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file screen_headless.cpp
+ * @author Paul Ward
+ * @brief Headless screen handling.
+ *
+ * This is the headless back end for the screen class.  Frames are
+ * presented to an in-memory surface rather than a console, so the
+ * whole rendering path can be run, timed and checked without a
+ * terminal attached.
+ *
+ * Presented frames go through the same shadow diff as the real back
+ * ends, so the presentation counters mean the same thing here.  If
+ * asked to, the screen will also keep a copy of each frame it
+ * presents.
+ */
+
+#include "compiler.hpp"
+
+#if defined(OVISION_HEADLESS)
+
+#include <cstddef>
+#include <algorithm>
+
+#include "screen.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Initialise the in-memory screen.
+ * @returns Always @c true.
+ *
+ * A size set before the screen is initialised is kept, otherwise
+ * the screen starts out at 80 by 25.
+ */
+bool
+screen::init()
+{
+  if (mInitialised) {
+    return true;
+  }
+
+  mInitialised = true;
+
+  set_size(get_size());
+  clear_screen();
+
+  return true;
+}
+
+/**
+ * @brief Shut down the in-memory screen.
+ */
+void
+screen::shutdown()
+{
+  mInitialised = false;
+}
+
+/**
+ * @brief Suspend the screen.
+ *
+ * There is nothing to hand back, so this does nothing.
+ */
+void
+screen::suspend()
+{}
+
+/**
+ * @brief Resume the screen.
+ */
+void
+screen::resume()
+{
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Clear the in-memory screen.
+ */
+void
+screen::clear_screen() const
+{
+  std::fill(mSurface.begin(),
+            mSurface.end(),
+            achar(' ', default_attributes));
+
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Returns the number of columns on the screen.
+ */
+std::size_t
+screen::get_columns() const
+{
+  return get_size().width;
+}
+
+/**
+ * @brief Returns the number of rows on the screen.
+ */
+std::size_t
+screen::get_rows() const
+{
+  return get_size().height;
+}
+
+/**
+ * @brief Return the number of character cells on the screen.
+ */
+screen_size
+screen::get_size() const
+{
+  if (mSize.width == 0 || mSize.height == 0) {
+    return screen_size(80, 25);
+  }
+
+  return mSize;
+}
+
+/**
+ * @brief Set the screen size to the given size.
+ * @param extent The screen size.
+ *
+ * Unlike the real back ends, this may be called before the screen
+ * is initialised, so that a benchmark can pick its own size.
+ */
+void
+screen::set_size(const screen_size &extent)
+{
+  mSize = extent;
+  mSurface.assign(extent.offset(), achar(' ', default_attributes));
+
+  notify_resize();
+}
+
+/**
+ * @brief Returns the current cursor position.
+ */
+screen_point
+screen::get_cursor_pos() const
+{
+  return mCursorPos;
+}
+
+/**
+ * @brief Sets the cursor position
+ * @param position The position to place the cursor.
+ */
+void
+screen::set_cursor_pos(const screen_point &position) const
+{
+  mCursorPos = position;
+}
+
+/**
+ * @brief Disables the cursor.
+ */
+void
+screen::disable_cursor()
+{
+  mCursorDisabled = true;
+}
+
+/**
+ * @brief Enables the cursor.
+ */
+void
+screen::enable_cursor()
+{
+  mCursorDisabled = false;
+}
+
+/**
+ * @brief Returns the character at the given position.
+ * @param pos The position.
+ * @returns A character/attribute pair.
+ */
+achar
+screen::get_character(const screen_point &pos) const
+{
+  if (pos.x >= mSize.width || pos.y >= mSize.height) {
+    return achar(' ', default_attributes);
+  }
+
+  return mSurface[pos.x + pos.y * mSize.width];
+}
+
+/**
+ * @brief Returns a specific number of sequential characters.
+ * @param pos The starting position.
+ * @param count The number of characters to get.
+ * @returns A character/attribute string.
+ */
+astring
+screen::get_characters(const screen_point &pos, std::size_t count)
+{
+  std::size_t start = std::min(pos.x + pos.y * mSize.width,
+                               mSurface.size());
+  std::size_t end   = std::min(start + count, mSurface.size());
+  astring     res;
+
+  res.assign(mSurface.begin() + start, mSurface.begin() + end);
+
+  return res;
+}
+
+/**
+ * @brief Sets the character at the given position to the given
+ *        value.
+ * @param pos The position.
+ * @param value The character/attribute pair.
+ */
+void
+screen::set_character(const screen_point &pos, achar value)
+{
+  if (pos.x < mSize.width && pos.y < mSize.height) {
+    mSurface[pos.x + pos.y * mSize.width] = value;
+  }
+
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Returns the input descriptor.
+ *
+ * There is no input device, so this is always -1.
+ */
+int
+screen::input_handle()
+{
+  return -1;
+}
+
+/**
+ * @brief Pick up a change in the window size.
+ * @returns Always @c false.
+ *
+ * The in-memory screen only changes size through @c set_size, so
+ * there is never anything to pick up.
+ */
+bool
+screen::poll_resize()
+{
+  return false;
+}
+
+/**
+ * @brief Set the title of the window.
+ * @param title The new title to use.
+ */
+void
+screen::set_title(const string_t &title)
+{
+  mTitle = title;
+}
+
+/**
+ * @brief Restores the previous window title.
+ */
+void
+screen::restore_title()
+{
+  mTitle.clear();
+}
+
+/**
+ * @brief Returns what the screen currently shows.
+ */
+const astring &
+screen::get_surface() const
+{
+  return mSurface;
+}
+
+/**
+ * @brief Returns the current window title.
+ */
+const string_t &
+screen::get_title() const
+{
+  return mTitle;
+}
+
+/**
+ * @brief Start capturing presented frames.
+ * @param limit The most frames to keep.
+ *
+ * Each frame that @c render_buffer presents is copied until @c limit
+ * frames have been captured.  A limit of zero stops capturing, which
+ * is what benchmarks want, as the copy is not free.
+ */
+void
+screen::capture_frames(std::size_t limit)
+{
+  mCaptureLimit = limit;
+
+  if (mCaptured.size() > limit) {
+    mCaptured.resize(limit);
+  }
+}
+
+/**
+ * @brief Returns the frames captured so far.
+ */
+const std::vector<astring> &
+screen::get_captured_frames() const
+{
+  return mCaptured;
+}
+
+/**
+ * @brief Throw away any captured frames.
+ */
+void
+screen::clear_captured_frames()
+{
+  mCaptured.clear();
+}
+
+/**
+ * @brief Renders a @c draw_buffer to the in-memory screen.
+ * @param buffer The buffer to render.
+ *
+ * Only the spans reported by the shadow are copied to the surface,
+ * which is counted as one write, just as a real back end would
+ * count its one console write.
+ */
+void
+screen::render_buffer(draw_buffer &buffer)
+{
+  screen_size        extent  = buffer.get_size();
+  const cell_buffer &cells   = buffer.cells();
+  std::size_t        columns = std::min(extent.width,  mSize.width);
+  std::size_t        rows    = std::min(extent.height, mSize.height);
+  std::size_t        written = 0;
+
+  const std::vector<dirty_span> &spans = mShadow.diff(buffer);
+
+  for (std::size_t i = 0; i < spans.size(); ++i) {
+    std::size_t base  = spans[i].row * extent.width;
+    std::size_t dest  = spans[i].row * mSize.width;
+    std::size_t right = std::min(spans[i].right, columns);
+
+    if (spans[i].row >= rows || spans[i].left >= right) {
+      continue;
+    }
+
+    for (std::size_t x = spans[i].left; x < right; ++x) {
+      mSurface[dest + x] = cells.get(base + x);
+    }
+
+    written += right - spans[i].left;
+  }
+
+  if (!spans.empty()) {
+    mShadow.record_write(written);
+  }
+
+  if (mCaptured.size() < mCaptureLimit) {
+    mCaptured.push_back(mSurface);
+  }
+}                                       // screen::render_buffer
+
+#endif // OVISION_HEADLESS
+
+// screen_headless.cpp ends here
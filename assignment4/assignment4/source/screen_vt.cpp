@@ -0,0 +1,806 @@
+//
+// screen_vt.cpp --- VT terminal screen handling.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 18:04:12 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 18:04:12
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file screen_vt.cpp
+ * @author Paul Ward
+ * @brief VT terminal screen handling.
+ *
+ * This is the POSIX back end for the screen class.  It drives any
+ * VT-compatible terminal (xterm and friends, the Linux console, or
+ * anything on the other end of an ssh session) using escape
+ * sequences.
+ *
+ * Each frame is composed into a single output buffer, which is then
+ * handed to the terminal with one @c write(2) call.
+ */
+
+#include "compiler.hpp"
+
+#if defined(OVISION_POSIX)
+
+#include <cstddef>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+
+#include <csignal>
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+
+#include "screen.hpp"
+#include "style.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Map a Win32 colour index (blue, green, red) to an ANSI
+ *        colour index (red, green, blue).
+ */
+static const unsigned ansi_colours[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+
+/**
+ * @def ATTR_REVERSE
+ * @brief Reverse video attribute bit.
+ *
+ * @def ATTR_UNDERSCORE
+ * @brief Underscore attribute bit.
+ *
+ * These have the same values as their Win32 @c COMMON_LVB_*
+ * counterparts.
+ */
+#define ATTR_REVERSE    0x4000
+#define ATTR_UNDERSCORE 0x8000
+
+/**
+ * @brief Append an unsigned number to an output buffer.
+ * @param out The output buffer.
+ * @param value The number.
+ */
+static
+void
+append_number(std::string &out, std::size_t value)
+{
+  char        digits[24];
+  std::size_t len = 0;
+
+  do {
+    digits[len++] = __CAST(char, '0' + (value % 10));
+    value        /= 10;
+  } while (value > 0);
+
+  while (len > 0) {
+    out += digits[--len];
+  }
+}
+
+/**
+ * @brief Append a cursor positioning sequence to an output buffer.
+ * @param out The output buffer.
+ * @param row The zero-based row.
+ * @param column The zero-based column.
+ */
+static
+void
+append_cup(std::string &out, std::size_t row, std::size_t column)
+{
+  out += "\x1b[";
+  append_number(out, row + 1);
+  out += ';';
+  append_number(out, column + 1);
+  out += 'H';
+}
+
+/**
+ * @brief Append an SGR sequence for an attribute to an output buffer.
+ * @param out The output buffer.
+ * @param attr The attribute, as Win32 console attribute bits.
+ *
+ * The sequence always resets the terminal attributes first, so it
+ * does not matter what the previous cell looked like.
+ */
+static
+void
+append_sgr(std::string &out, unsigned long attr)
+{
+  out += "\x1b[0;";
+  append_number(out,
+                ((attr & FOREGROUND_INTENSITY) ? 90 : 30) +
+                ansi_colours[attr & 0x07]);
+  out += ';';
+  append_number(out,
+                ((attr & BACKGROUND_INTENSITY) ? 100 : 40) +
+                ansi_colours[(attr >> 4) & 0x07]);
+
+  if (attr & ATTR_REVERSE) {
+    out += ";7";
+  }
+
+  if (attr & ATTR_UNDERSCORE) {
+    out += ";4";
+  }
+
+  out += 'm';
+}
+
+/**
+ * @brief Append a character to an output buffer as UTF-8.
+ * @param out The output buffer.
+ * @param ch The character.
+ *
+ * Control characters are replaced with spaces, as the terminal would
+ * otherwise act upon them.
+ */
+static
+void
+append_utf8(std::string &out, char_t ch)
+{
+  unsigned long cp = __CAST(unsigned long, ch);
+
+  if (cp < 0x20 || cp == 0x7F || cp > 0x10FFFF) {
+    out += ' ';
+  } else if (cp < 0x80) {
+    out += __CAST(char, cp);
+  } else if (cp < 0x800) {
+    out += __CAST(char, 0xC0 | (cp >> 6));
+    out += __CAST(char, 0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += __CAST(char, 0xE0 | (cp >> 12));
+    out += __CAST(char, 0x80 | ((cp >> 6) & 0x3F));
+    out += __CAST(char, 0x80 | (cp & 0x3F));
+  } else {
+    out += __CAST(char, 0xF0 | (cp >> 18));
+    out += __CAST(char, 0x80 | ((cp >> 12) & 0x3F));
+    out += __CAST(char, 0x80 | ((cp >> 6) & 0x3F));
+    out += __CAST(char, 0x80 | (cp & 0x3F));
+  }
+}
+
+/**
+ * @brief Put the terminal back the way we found it at exit.
+ *
+ * This is registered with @c atexit so that a call to @c exit from
+ * somewhere deep inside the application does not leave the user's
+ * terminal in raw mode.
+ */
+static
+void
+restore_terminal_at_exit()
+{
+  screen::get_instance().shutdown();
+}
+
+/**
+ * @brief Has the terminal window changed size?
+ *
+ * This is set from the @c SIGWINCH handler and cleared when the
+ * screen picks the new size up.
+ */
+static volatile std::sig_atomic_t resize_pending = 0;
+
+/**
+ * @brief @c SIGWINCH handler.
+ * @param signo The signal number.
+ *
+ * Nothing else is safe to do from a signal handler, so this just
+ * notes that the window size changed.
+ */
+static
+void
+window_changed(int signo)
+{
+  (void)signo;
+
+  resize_pending = 1;
+}
+
+/**
+ * @brief Install or remove the @c SIGWINCH handler.
+ * @param install @c true to install the handler, @c false to go
+ *                back to the default action.
+ *
+ * The handler is installed without @c SA_RESTART so that a blocked
+ * read of the keyboard returns, and the keyboard can tell the screen
+ * to pick the new size up.
+ */
+static
+void
+catch_window_changes(bool install)
+{
+  struct sigaction sa;
+
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags   = 0;
+  sa.sa_handler = install ? window_changed : SIG_DFL;
+
+  sigaction(SIGWINCH, &sa, NULL);
+}
+
+/**
+ * @brief Write data to the terminal.
+ * @param data The data to write.
+ * @param count The number of bytes to write.
+ *
+ * This only loops if the kernel accepts less than the whole buffer
+ * or the write is interrupted by a signal.
+ */
+void
+screen::write_out(const char *data, std::size_t count) const
+{
+  while (count > 0) {
+    ssize_t n = write(mOutputFd, data, count);
+
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return;
+    }
+
+    data  += n;
+    count -= __CAST(std::size_t, n);
+  }
+}
+
+/**
+ * @brief Write data to the terminal.
+ * @param data The data to write.
+ */
+void
+screen::write_out(const std::string &data) const
+{
+  write_out(data.data(), data.size());
+}
+
+/**
+ * @brief Put the terminal into raw mode.
+ *
+ * Input is delivered a byte at a time without echo, and control
+ * characters such as Control+C are passed to us rather than
+ * generating signals.
+ */
+void
+screen::enter_raw_mode()
+{
+  struct termios raw = mSavedTermios;
+
+  raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+  raw.c_oflag &= ~(OPOST);
+  raw.c_cflag |= CS8;
+  raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+
+  raw.c_cc[VMIN]  = 1;
+  raw.c_cc[VTIME] = 0;
+
+  if (tcsetattr(mInputFd, TCSAFLUSH, &raw) == 0) {
+    mRawMode = true;
+  }
+}
+
+/**
+ * @brief Restore the terminal attributes saved before raw mode.
+ */
+void
+screen::leave_raw_mode()
+{
+  if (mRawMode) {
+    tcsetattr(mInputFd, TCSAFLUSH, &mSavedTermios);
+    mRawMode = false;
+  }
+}
+
+/**
+ * @brief Ask the terminal how large its window is.
+ *
+ * This is only done when we start, when we resume and when the
+ * terminal tells us the window changed size.
+ */
+void
+screen::query_terminal_size()
+{
+  struct winsize ws;
+
+  mGeometryQueries++;
+
+  if (ioctl(mOutputFd, TIOCGWINSZ, &ws) == 0 &&
+      ws.ws_col > 0 &&
+      ws.ws_row > 0)
+  {
+    mTermSize = screen_size(__CAST(std::size_t, ws.ws_col),
+                            __CAST(std::size_t, ws.ws_row));
+  } else {
+    mTermSize = screen_size(80, 25);
+  }
+}
+
+/**
+ * @brief Initialise the terminal.
+ *
+ * This saves the terminal attributes, switches to raw mode and the
+ * alternate screen, and sets up the default screen size.
+ */
+bool
+screen::init()
+{
+  static bool registered = false;
+
+  mInputFd  = STDIN_FILENO;
+  mOutputFd = STDOUT_FILENO;
+
+  if (!isatty(mInputFd) || !isatty(mOutputFd)) {
+    return false;
+  }
+
+  if (tcgetattr(mInputFd, &mSavedTermios) != 0) {
+    return false;
+  }
+
+  if (!registered) {
+    atexit(restore_terminal_at_exit);
+    registered = true;
+  }
+
+  mInitialised = true;
+
+  mFrame.reserve(4096);
+  query_terminal_size();
+  enter_raw_mode();
+  catch_window_changes(true);
+
+  // Save the title, switch to the alternate screen, turn off
+  // auto-wrap and clear.
+  write_out("\x1b[22;0t\x1b[?1049h\x1b[?7l\x1b[0m\x1b[2J");
+  mAltScreen = true;
+
+  set_size(screen_size(80, 25));
+  mShadow.invalidate();
+
+  if (mCursorDisabled) {
+    disable_cursor();
+  }
+
+  return true;
+}                                       // screen::init
+
+/**
+ * @brief Restore the terminal to its previous state.
+ */
+void
+screen::shutdown()
+{
+  suspend();
+}
+
+/**
+ * @brief Temporarily suspend the current terminal state.
+ *
+ * This leaves the alternate screen, shows the cursor and restores
+ * the terminal attributes, so the shell sees the terminal as it was
+ * before we started.
+ *
+ * The screen is put back even if raw mode could not be entered, as
+ * @c init switches to the alternate screen either way.
+ */
+void
+screen::suspend()
+{
+  if (!mInitialised) {
+    return;
+  }
+
+  if (mAltScreen) {
+    write_out("\x1b[0m\x1b[?7h\x1b[?25h\x1b[?1049l");
+    restore_title();
+    mAltScreen = false;
+  }
+
+  leave_raw_mode();
+  catch_window_changes(false);
+}
+
+/**
+ * @brief Resumes the terminal state from the last suspended state.
+ *
+ * This puts the terminal back into raw mode on the alternate screen.
+ * The whole frame is written out again on the next render.
+ */
+void
+screen::resume()
+{
+  tcgetattr(mInputFd, &mSavedTermios);
+  enter_raw_mode();
+  catch_window_changes(true);
+
+  write_out("\x1b[22;0t\x1b[?1049h\x1b[?7l");
+  mAltScreen = true;
+  query_terminal_size();
+
+  mSavedScreenSize = screen_size(get_columns(), get_rows());
+  mSavedCursorPos  = get_cursor_pos();
+
+  if (mCursorDisabled) {
+    disable_cursor();
+  }
+
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Clear the terminal screen.
+ */
+void
+screen::clear_screen() const
+{
+  if (mInitialised) {
+    write_out("\x1b[0m\x1b[2J");
+
+    mShadow.invalidate();
+  }
+}
+
+/**
+ * @brief Returns the number of columns the application can address.
+ */
+std::size_t
+screen::get_columns() const
+{
+  return get_size().width;
+}
+
+/**
+ * @brief Returns the number of rows the application can address.
+ */
+std::size_t
+screen::get_rows() const
+{
+  return get_size().height;
+}
+
+/**
+ * @brief Return the number of character cells the application can
+ *        address.
+ *
+ * Terminals cannot always be resized on request, so this is the
+ * size the application asked for rather than the size of the
+ * terminal window.  Anything outside the window is clipped when the
+ * frame is presented.
+ */
+screen_size
+screen::get_size() const
+{
+  if (mInitialised) {
+    return mSize;
+  }
+
+  return screen_size(80, 25);
+}
+
+/**
+ * @brief Set the screen size to the given size.
+ * @param extent The screen size.
+ *
+ * Terminals that understand the xterm window manipulation sequence
+ * will resize their window to match.
+ */
+void
+screen::set_size(const screen_size &extent)
+{
+  std::string seq;
+
+  if (!mInitialised) {
+    return;
+  }
+
+  mSize = extent;
+
+  seq += "\x1b[8;";
+  append_number(seq, extent.height);
+  seq += ';';
+  append_number(seq, extent.width);
+  seq += 't';
+
+  write_out(seq);
+  query_terminal_size();
+
+  notify_resize();
+}
+
+/**
+ * @brief Returns the current cursor position.
+ *
+ * Terminals cannot be asked this without a round trip, so this is
+ * the position the cursor was last placed at.
+ */
+screen_point
+screen::get_cursor_pos() const
+{
+  return mCursorPos;
+}
+
+/**
+ * @brief Sets the cursor position
+ * @param position The position to place the cursor.
+ */
+void
+screen::set_cursor_pos(const screen_point &position) const
+{
+  std::string seq;
+
+  mCursorPos = position;
+
+  append_cup(seq, position.y, position.x);
+  write_out(seq);
+}
+
+/**
+ * @brief Disables the cursor.
+ */
+void
+screen::disable_cursor()
+{
+  mCursorDisabled = true;
+
+  write_out("\x1b[?25l");
+}
+
+/**
+ * @brief Enables the cursor.
+ */
+void
+screen::enable_cursor()
+{
+  mCursorDisabled = false;
+
+  write_out("\x1b[?25h");
+}
+
+/**
+ * @brief Returns the character at the given position.
+ * @param pos The position.
+ * @returns A character/attribute pair.
+ *
+ * Terminals cannot be read back, so this comes from the shadow of
+ * the last presented frame.
+ */
+achar
+screen::get_character(const screen_point &pos) const
+{
+  return mShadow.get(pos);
+}
+
+/**
+ * @brief Returns a specific number of sequential characters.
+ * @param pos The starting position.
+ * @param count The number of characters to get.
+ * @returns A character/attribute string.
+ */
+astring
+screen::get_characters(const screen_point &pos, std::size_t count)
+{
+  std::size_t width = get_columns();
+  std::size_t start = pos.x + pos.y * width;
+  astring     res;
+
+  res.reserve(count);
+
+  for (std::size_t i = start; i < start + count; ++i) {
+    res.push_back(mShadow.get(screen_point(i % width, i / width)));
+  }
+
+  return res;
+}
+
+/**
+ * @brief Sets the character at the given position to the given
+ *        value.
+ * @param pos The position.
+ * @param value The character/attribute pair.
+ */
+void
+screen::set_character(const screen_point &pos, achar value)
+{
+  std::string seq;
+
+  append_cup(seq, pos.y, pos.x);
+  append_attribute(seq, value.attribute.to_ulong());
+  append_utf8(seq, value.character);
+
+  write_out(seq);
+
+  mShadow.invalidate();
+}
+
+/**
+ * @brief Returns the terminal input descriptor.
+ */
+int
+screen::input_handle()
+{
+  return mInputFd;
+}
+
+/**
+ * @brief Pick up a change in the terminal window size.
+ * @returns @c true if the size was picked up; otherwise @c false is
+ *          returned.
+ *
+ * This does nothing unless @c SIGWINCH has been delivered since the
+ * last call, so it is cheap enough to call whenever a read of the
+ * keyboard is interrupted.
+ */
+bool
+screen::poll_resize()
+{
+  if (!resize_pending || !mInitialised) {
+    return false;
+  }
+
+  resize_pending = 0;
+
+  query_terminal_size();
+  notify_resize();
+
+  return true;
+}
+
+/**
+ * @brief Set the title of the terminal window.
+ * @param title The new title to use.
+ */
+void
+screen::set_title(const string_t &title)
+{
+  std::string seq = "\x1b]2;";
+
+  for (std::size_t i = 0; i < title.length(); ++i) {
+    append_utf8(seq, title[i]);
+  }
+
+  seq += '\x07';
+
+  write_out(seq);
+}
+
+/**
+ * @brief Restores the previous terminal window title.
+ *
+ * The title was pushed onto the terminal's title stack when the
+ * screen was initialised, so this simply pops it back off.
+ */
+void
+screen::restore_title()
+{
+  write_out("\x1b[23;0t");
+}
+
+/**
+ * @brief Append an SGR sequence for an attribute word to an output
+ *        buffer.
+ * @param out The output buffer.
+ * @param attr A classic attribute or an interned style ID.
+ *
+ * The sequence for each style ID is built the first time the ID is
+ * seen and kept, so an extended style costs no more to present than
+ * a classic one.
+ */
+void
+screen::append_attribute(std::string &out, unsigned long attr)
+{
+  std::uint16_t word  = __CAST(std::uint16_t, attr);
+  std::size_t   index = word & (style_table::interned_bit - 1);
+
+  if (!style_table::is_interned(word)) {
+    append_sgr(out, attr);
+    return;
+  }
+
+  if (index >= mStyleSgr.size()) {
+    mStyleSgr.resize(index + 1);
+  }
+
+  if (mStyleSgr[index].empty()) {
+    style_table::get_instance().resolve(word).append_sgr(
+      mStyleSgr[index]);
+  }
+
+  out += mStyleSgr[index];
+}
+
+/**
+ * @brief Renders a @c draw_buffer to the terminal.
+ * @param buffer The buffer to render.
+ *
+ * The changed spans reported by the shadow are composed into a
+ * single output buffer and written with one system call.  A new SGR
+ * sequence is only emitted when the attribute changes, so a run of
+ * cells that look alike shares one sequence.
+ */
+void
+screen::render_buffer(draw_buffer &buffer)
+{
+  screen_size        extent  = buffer.get_size();
+  const cell_buffer &cells   = buffer.cells();
+  std::size_t        columns = std::min(extent.width,  mTermSize.width);
+  std::size_t        rows    = std::min(extent.height, mTermSize.height);
+  std::size_t        written = 0;
+  unsigned long      current = ~0UL;
+
+  const std::vector<dirty_span> &spans = mShadow.diff(buffer);
+
+  if (spans.empty()) {
+    return;
+  }
+
+  mFrame.clear();
+
+  for (std::size_t i = 0; i < spans.size(); ++i) {
+    std::size_t base  = spans[i].row * extent.width;
+    std::size_t right = std::min(spans[i].right, columns);
+
+    if (spans[i].row >= rows || spans[i].left >= right) {
+      continue;
+    }
+
+    append_cup(mFrame, spans[i].row, spans[i].left);
+
+    for (std::size_t x = spans[i].left; x < right; ++x) {
+      unsigned long attr = cells.attribute(base + x);
+
+      if (attr != current) {
+        append_attribute(mFrame, attr);
+        current = attr;
+      }
+
+      append_utf8(mFrame, cells.character(base + x));
+    }
+
+    written += right - spans[i].left;
+  }
+
+  if (!mCursorDisabled) {
+    append_cup(mFrame, mCursorPos.y, mCursorPos.x);
+  }
+
+  write_out(mFrame);
+  mShadow.record_write(written);
+}                                       // screen::render_buffer
+
+#endif // OVISION_POSIX
+
+// screen_vt.cpp ends here
@@ -0,0 +1,237 @@
+//
+// shadow.cpp --- Shadow frame buffer implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 14:22:12 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 14:22:12
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+
+/**
+ * @file shadow.cpp
+ * @author Paul Ward
+ * @brief Shadow frame buffer implementation.
+ */
+
+#include "shadow.hpp"
+#include "drawbuffer.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Default constructor function.
+ */
+shadow_buffer::shadow_buffer()
+  : mSize(screen_size(0, 0)),
+    mCells(),
+    mValid(false),
+    mSpans()
+{
+  reset_stats();
+}
+
+/**
+ * @brief Mark the shadow as no longer matching the console.
+ *
+ * This should be called whenever something other than the presenter
+ * touches the console contents, such as a clear or a resize.  The
+ * next diff will then report the whole frame as dirty.
+ */
+void
+shadow_buffer::invalidate()
+{
+  mValid = false;
+}
+
+/**
+ * @brief Does the shadow match what is on the console?
+ */
+bool
+shadow_buffer::valid() const
+{
+  return mValid;
+}
+
+/**
+ * @brief Return a cell from the last presented frame.
+ * @param pos The position of the cell.
+ * @returns The cell, or a blank cell if the shadow does not cover
+ *          the given position.
+ */
+achar
+shadow_buffer::get(const screen_point &pos) const
+{
+  if (!mValid || pos.x >= mSize.width || pos.y >= mSize.height) {
+    return achar(' ', default_attributes);
+  }
+
+  return mCells.get(pos.x + pos.y * mSize.width);
+}
+
+/**
+ * @brief Compare a frame against the shadow.
+ * @param buffer The frame about to be presented.
+ * @returns The row spans that differ from the last presented frame.
+ *
+ * Each row is scanned from the left for the first changed cell and
+ * from the right for the last, so a row produces at most one span.
+ * Only the cells that actually differ are counted as changed, not
+ * the whole span.
+ *
+ * The shadow is updated as it goes, so once this returns the caller
+ * is expected to write every reported span to the console, and to
+ * account for what it wrote with @c record_write.
+ */
+const std::vector<dirty_span> &
+shadow_buffer::diff(draw_buffer &buffer)
+{
+  screen_size        extent = buffer.get_size();
+  std::size_t        width  = extent.width;
+  std::size_t        height = extent.height;
+  const cell_buffer &cells  = buffer.cells();
+  dirty_span         span;
+
+  mSpans.clear();
+  mStats.presents++;
+
+  if (width == 0 || height == 0) {
+    return mSpans;
+  }
+
+  // If the console no longer reflects the shadow, then everything is
+  // dirty and we simply take a full copy.
+  if (!mValid || mSize != extent || mCells.size() != buffer.size()) {
+    mSize  = extent;
+    mValid = true;
+
+    mCells = cells;
+
+    for (std::size_t row = 0; row < height; ++row) {
+      span.row   = row;
+      span.left  = 0;
+      span.right = width;
+
+      mSpans.push_back(span);
+    }
+
+    mStats.cells_changed += buffer.size();
+
+    return mSpans;
+  }
+
+  for (std::size_t row = 0; row < height; ++row) {
+    std::size_t base  = row * width;
+    std::size_t left  = 0;
+    std::size_t right = width;
+
+    // Find the first changed cell.
+    while (left < width) {
+      mStats.cells_compared++;
+
+      if (!mCells.same(base + left, cells)) {
+        break;
+      }
+
+      left++;
+    }
+
+    if (left == width) {
+      continue;
+    }
+
+    // Find the last changed cell.
+    while (right - 1 > left) {
+      mStats.cells_compared++;
+
+      if (!mCells.same(base + right - 1, cells)) {
+        break;
+      }
+
+      right--;
+    }
+
+    // Both ends of the span differ.  The cells between them have
+    // not been looked at yet, so count the ones that differ too.
+    mStats.cells_changed += (right - left > 1) ? 2 : 1;
+
+    for (std::size_t x = left + 1; x + 1 < right; ++x) {
+      mStats.cells_compared++;
+
+      if (!mCells.same(base + x, cells)) {
+        mStats.cells_changed++;
+      }
+    }
+
+    mCells.copy(base + left, cells, base + left, right - left);
+
+    span.row   = row;
+    span.left  = left;
+    span.right = right;
+
+    mSpans.push_back(span);
+  }
+
+  return mSpans;
+}                                       // shadow_buffer::diff
+
+/**
+ * @brief Return the presentation counters.
+ */
+const present_stats &
+shadow_buffer::stats() const
+{
+  return mStats;
+}
+
+/**
+ * @brief Reset the presentation counters.
+ */
+void
+shadow_buffer::reset_stats()
+{
+  mStats.presents       = 0;
+  mStats.cells_compared = 0;
+  mStats.cells_changed  = 0;
+  mStats.cells_written  = 0;
+  mStats.writes         = 0;
+}
+
+/**
+ * @brief Account for a write made to the console.
+ * @param cells The number of cells the write covered.
+ */
+void
+shadow_buffer::record_write(std::size_t cells)
+{
+  mStats.cells_written += cells;
+  mStats.writes++;
+}
+
+// shadow.cpp ends here
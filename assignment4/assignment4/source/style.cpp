@@ -0,0 +1,525 @@
+//
+// style.cpp --- Extended character styles implementation.
+//
+// Copyright (c) 2026 Paul Ward <asmodai@gmail.com>
+//
+// Time-stamp: <Sunday Oct 18, 2026 13:47:24 asmodai>
+// Revision:   1
+//
+// Author:     Paul Ward <asmodai@gmail.com>
+// Maintainer: Paul Ward <asmodai@gmail.com>
+// Created:    18 Oct 2026 13:47:24
+// Keywords:   
+// URL:        not distributed yet
+//
+// {{{ License:
+//
+// This file is part of Object Vision.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+// }}}
+// {{{ Commentary:
+//
+// }}}
+/**
+ * @file style.cpp
+ * @author Paul Ward
+ * @brief Extended character styles implementation.
+ */
+
+#include "style.hpp"
+
+using namespace ovision;
+
+/**
+ * @brief Map an ANSI colour index (red, green, blue) to a Win32
+ *        colour index (blue, green, red), and back again.
+ */
+static const unsigned swap_colours[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+
+/**
+ * @brief The classic colours, in ANSI order, as 0xRRGGBB.
+ */
+static const std::uint32_t classic_rgb[16] = {
+  0x000000, 0x800000, 0x008000, 0x808000,
+  0x000080, 0x800080, 0x008080, 0xC0C0C0,
+  0x808080, 0xFF0000, 0x00FF00, 0xFFFF00,
+  0x0000FF, 0xFF00FF, 0x00FFFF, 0xFFFFFF
+};
+
+/**
+ * @brief The levels of each channel in the 256-colour cube.
+ */
+static const std::uint32_t cube_levels[6] = {
+  0x00, 0x5F, 0x87, 0xAF, 0xD7, 0xFF
+};
+
+/**
+ * @def ATTR_INTENSITY
+ * @brief Foreground intensity bit in a classic attribute.
+ *
+ * @def ATTR_REVERSE
+ * @brief Reverse video bit in a classic attribute.
+ *
+ * @def ATTR_UNDERSCORE
+ * @brief Underscore bit in a classic attribute.
+ */
+#define ATTR_INTENSITY  0x0008
+#define ATTR_REVERSE    0x4000
+#define ATTR_UNDERSCORE 0x8000
+
+/**
+ * @brief Append an unsigned number to an output buffer.
+ * @param out The output buffer.
+ * @param value The number.
+ */
+static
+void
+append_number(std::string &out, std::size_t value)
+{
+  char        digits[24];
+  std::size_t len = 0;
+
+  do {
+    digits[len++] = __CAST(char, '0' + (value % 10));
+    value        /= 10;
+  } while (value > 0);
+
+  while (len > 0) {
+    out += digits[--len];
+  }
+}
+
+/**
+ * @brief Append the SGR parameters for a colour to an output buffer.
+ * @param out The output buffer.
+ * @param c The colour.
+ * @param base 30 for a foreground colour, 40 for a background one.
+ */
+static
+void
+append_colour(std::string &out, const colour &c, std::size_t base)
+{
+  out += ';';
+
+  switch (c.kind) {
+    case colour::colour_16:
+      append_number(out, (c.value < 8 ? base : base + 60) + (c.value & 7));
+      break;
+
+    case colour::colour_256:
+      append_number(out, base + 8);
+      out += ";5;";
+      append_number(out, c.value);
+      break;
+
+    case colour::colour_rgb:
+      append_number(out, base + 8);
+      out += ";2;";
+      append_number(out, (c.value >> 16) & 0xFF);
+      out += ';';
+      append_number(out, (c.value >> 8) & 0xFF);
+      out += ';';
+      append_number(out, c.value & 0xFF);
+      break;
+
+    default:
+      append_number(out, base + 9);
+      break;
+  }
+}                                       // append_colour
+
+/**
+ * @brief Return the terminal's default colour.
+ */
+colour
+colour::none()
+{
+  colour ret;
+
+  ret.kind  = colour_default;
+  ret.value = 0;
+
+  return ret;
+}
+
+/**
+ * @brief Return one of the 16 classic colours.
+ * @param index The ANSI colour index, 0 to 15.
+ */
+colour
+colour::ansi(unsigned index)
+{
+  colour ret;
+
+  ret.kind  = colour_16;
+  ret.value = index & 0x0F;
+
+  return ret;
+}
+
+/**
+ * @brief Return one of the 256 indexed colours.
+ * @param index The colour index, 0 to 255.
+ */
+colour
+colour::indexed(unsigned index)
+{
+  colour ret;
+
+  ret.kind  = colour_256;
+  ret.value = index & 0xFF;
+
+  return ret;
+}
+
+/**
+ * @brief Return a 24-bit colour.
+ * @param red The red channel, 0 to 255.
+ * @param green The green channel, 0 to 255.
+ * @param blue The blue channel, 0 to 255.
+ */
+colour
+colour::rgb(unsigned red, unsigned green, unsigned blue)
+{
+  colour ret;
+
+  ret.kind  = colour_rgb;
+  ret.value = ((red & 0xFF) << 16) | ((green & 0xFF) << 8) | (blue & 0xFF);
+
+  return ret;
+}
+
+/**
+ * @brief Return the colour as 0xRRGGBB.
+ * @param foreground Is this a foreground colour?  The default
+ *                   colour is taken to be grey on black.
+ */
+std::uint32_t
+colour::to_rgb(bool foreground) const
+{
+  switch (kind) {
+    case colour_16:
+      return classic_rgb[value];
+
+    case colour_256:
+      if (value < 16) {
+        return classic_rgb[value];
+      }
+
+      if (value < 232) {
+        std::uint32_t n = value - 16;
+
+        return (cube_levels[n / 36] << 16) |
+               (cube_levels[(n / 6) % 6] << 8) |
+               cube_levels[n % 6];
+      }
+
+      {
+        std::uint32_t grey = 8 + (value - 232) * 10;
+
+        return (grey << 16) | (grey << 8) | grey;
+      }
+
+    case colour_rgb:
+      return value;
+
+    case colour_default:
+    default:
+      return foreground ? classic_rgb[7] : classic_rgb[0];
+  }
+}                                       // colour::to_rgb
+
+/**
+ * @brief Return the classic colour closest to this one.
+ * @param foreground Is this a foreground colour?
+ * @returns An ANSI colour index, 0 to 15.
+ */
+unsigned
+colour::nearest_ansi(bool foreground) const
+{
+  std::uint32_t want = to_rgb(foreground);
+  unsigned      best = 0;
+  long          dist = -1;
+
+  if (kind == colour_16) {
+    return value;
+  }
+
+  for (unsigned i = 0; i < 16; ++i) {
+    long dr = __CAST(long, (want >> 16) & 0xFF) -
+              __CAST(long, (classic_rgb[i] >> 16) & 0xFF);
+    long dg = __CAST(long, (want >> 8) & 0xFF) -
+              __CAST(long, (classic_rgb[i] >> 8) & 0xFF);
+    long db = __CAST(long, want & 0xFF) -
+              __CAST(long, classic_rgb[i] & 0xFF);
+    long d  = dr * dr + dg * dg + db * db;
+
+    if (dist < 0 || d < dist) {
+      best = i;
+      dist = d;
+    }
+  }
+
+  return best;
+}                                       // colour::nearest_ansi
+
+/**
+ * @brief Are two colours the same?
+ */
+bool
+ovision::operator == (const colour &lhs, const colour &rhs)
+{
+  return lhs.kind == rhs.kind && lhs.value == rhs.value;
+}
+
+/**
+ * @brief Does one colour order before another?
+ */
+bool
+ovision::operator < (const colour &lhs, const colour &rhs)
+{
+  if (lhs.kind != rhs.kind) {
+    return lhs.kind < rhs.kind;
+  }
+
+  return lhs.value < rhs.value;
+}
+
+/**
+ * @brief Default constructor function.
+ *
+ * The default style is the terminal's own colours.
+ */
+style::style()
+  : foreground(colour::none()),
+    background(colour::none()),
+    flags(0)
+{}
+
+/**
+ * @brief Constructor function.
+ * @param fg The foreground colour.
+ * @param bg The background colour.
+ * @param styleFlags The style flags.
+ */
+style::style(const colour &fg, const colour &bg, std::uint16_t styleFlags)
+  : foreground(fg),
+    background(bg),
+    flags(styleFlags)
+{}
+
+/**
+ * @brief Return the style a classic attribute describes.
+ * @param word The attribute word.
+ */
+style
+style::from_attribute(std::uint16_t word)
+{
+  style ret(colour::ansi(swap_colours[word & 0x07] | (word & 0x08)),
+            colour::ansi(swap_colours[(word >> 4) & 0x07] |
+                         ((word >> 4) & 0x08)));
+
+  if (word & ATTR_REVERSE) {
+    ret.flags |= style_reverse;
+  }
+
+  if (word & ATTR_UNDERSCORE) {
+    ret.flags |= style_underline;
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Can a classic attribute describe this style exactly?
+ */
+bool
+style::is_classic() const
+{
+  return foreground.kind == colour::colour_16 &&
+         background.kind == colour::colour_16 &&
+         (flags & ~(style_underline | style_reverse)) == 0;
+}
+
+/**
+ * @brief Return the classic attribute closest to this style.
+ *
+ * Colours go to the nearest classic colour, bold becomes an intense
+ * foreground, and italic is lost.
+ */
+std::uint16_t
+style::to_attribute() const
+{
+  unsigned      fg   = foreground.nearest_ansi(true);
+  unsigned      bg   = background.nearest_ansi(false);
+  std::uint16_t word = 0;
+
+  word = __CAST(std::uint16_t, swap_colours[fg & 0x07] | (fg & 0x08));
+  word |= __CAST(std::uint16_t,
+                 (swap_colours[bg & 0x07] | (bg & 0x08)) << 4);
+
+  if (flags & style_bold) {
+    word |= ATTR_INTENSITY;
+  }
+
+  if (flags & style_reverse) {
+    word |= ATTR_REVERSE;
+  }
+
+  if (flags & style_underline) {
+    word |= ATTR_UNDERSCORE;
+  }
+
+  return word;
+}
+
+/**
+ * @brief Append an SGR sequence for this style to an output buffer.
+ * @param out The output buffer.
+ *
+ * The sequence resets the terminal attributes first, so it does not
+ * matter what the previous cell looked like.  The VT presenter
+ * builds this once for each style ID and keeps it.
+ */
+void
+style::append_sgr(std::string &out) const
+{
+  out += "\x1b[0";
+
+  if (flags & style_bold) {
+    out += ";1";
+  }
+
+  if (flags & style_italic) {
+    out += ";3";
+  }
+
+  if (flags & style_underline) {
+    out += ";4";
+  }
+
+  if (flags & style_reverse) {
+    out += ";7";
+  }
+
+  append_colour(out, foreground, 30);
+  append_colour(out, background, 40);
+
+  out += 'm';
+}
+
+/**
+ * @brief Are two styles the same?
+ */
+bool
+ovision::operator == (const style &lhs, const style &rhs)
+{
+  return lhs.foreground == rhs.foreground &&
+         lhs.background == rhs.background &&
+         lhs.flags      == rhs.flags;
+}
+
+/**
+ * @brief Does one style order before another?
+ */
+bool
+ovision::operator < (const style &lhs, const style &rhs)
+{
+  if (!(lhs.foreground == rhs.foreground)) {
+    return lhs.foreground < rhs.foreground;
+  }
+
+  if (!(lhs.background == rhs.background)) {
+    return lhs.background < rhs.background;
+  }
+
+  return lhs.flags < rhs.flags;
+}
+
+/**
+ * @brief Return the style table.
+ */
+style_table &
+style_table::get_instance()
+{
+  static style_table sInstance;
+
+  return sInstance;
+}
+
+/**
+ * @brief Return the attribute word for a style.
+ * @param s The style.
+ * @returns A classic attribute if one describes the style, or if
+ *          the table is full or the console cannot do any better;
+ *          otherwise the style's ID.
+ */
+std::uint16_t
+style_table::intern(const style &s)
+{
+#if defined(OVISION_WIN32)
+  return s.to_attribute();
+#else
+  style_map::const_iterator it = mIndex.find(s);
+  std::uint16_t             id = 0;
+
+  if (s.is_classic()) {
+    return s.to_attribute();
+  }
+
+  if (it != mIndex.end()) {
+    return it->second;
+  }
+
+  if (mStyles.size() >= max_styles) {
+    return s.to_attribute();
+  }
+
+  id = __CAST(std::uint16_t, interned_bit | mStyles.size());
+
+  mStyles.push_back(s);
+  mIndex[s] = id;
+
+  return id;
+#endif
+}                                       // style_table::intern
+
+/**
+ * @brief Return the style for an attribute word.
+ * @param word A classic attribute or a style ID.
+ */
+style
+style_table::resolve(std::uint16_t word) const
+{
+  std::size_t index = word & (interned_bit - 1);
+
+  if (is_interned(word) && index < mStyles.size()) {
+    return mStyles[index];
+  }
+
+  return style::from_attribute(word);
+}
+
+/**
+ * @brief Return the number of interned styles.
+ */
+std::size_t
+style_table::size() const
+{
+  return mStyles.size();
+}
+
+// style.cpp ends here
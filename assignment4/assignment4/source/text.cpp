@@ -38,34 +38,14 @@
  * @brief Text view implementation.
  */
  
+#include <algorithm>
+
 #include "text.hpp"
+#include "region.hpp"
 #include "screen.hpp"
 
 using namespace ovision;
 
-/**
- * @brief Scan a string and count the number of newlines.
- * @param str The string to scan.
- * @returns The number of newlines found in the string or, if no
- *          newlines are found, @c 0 is returned.
- */
-static
-std::size_t
-scan_for_newline(const string_t &str)
-{
-  std::size_t len = str.length();
-  std::size_t i   = 0;
-  std::size_t nls = 1;
-
-  for (i = 0; i < len; ++i) {
-    if (str[i] == '\n') {
-      nls++;
-    }
-  }
-
-  return nls;
-}
-
 /**
  * @brief Convenience function for the constructors.
  *
@@ -78,14 +58,15 @@ scan_for_newline(const string_t &str)
  * functions.
  */
 void
-text::vs2010_does_not_do_delegated_ctors_hrmph(const string_t &content,
-                                               screen_point   &location,
-                                               std::size_t     width,
-                                               text_align      alignment,
-                                               attr_t          attr)
+text::vs2010_does_not_do_delegated_ctors_hrmph(const string_t     &content,
+                                               const screen_point &location,
+                                               std::size_t         width,
+                                               text_align          alignment,
+                                               attr_t              attr)
 {
   mWidth     = width;
   mAlignment = alignment;
+  mWordWrap  = false;
 
   mClientRect.origin = location;
   mInnerRect.origin  = location;
@@ -93,12 +74,15 @@ text::vs2010_does_not_do_delegated_ctors_hrmph(const string_t &content,
   mClientAttr = attr;
   mInnerAttr  = attr;
 
-  mInnerRect.extent.height = scan_for_newline(content);
+  mInnerRect.extent.height = 0;
   mInnerRect.extent.width  = mWidth;
 
-  mContents.from_string(content, mInnerAttr);
+  mContents.assign(content, mInnerAttr);
 
   mClientRect.extent = mInnerRect.extent;
+
+  layout();
+  invalidate();
 }
 
 /**
@@ -107,8 +91,12 @@ text::vs2010_does_not_do_delegated_ctors_hrmph(const string_t &content,
 text::text()
   : view(),
     mContents(),
-    mAlignment(AlignLeft)
-{}
+    mWidth(0),
+    mAlignment(AlignLeft),
+    mWordWrap(false)
+{
+  layout();
+}
 
 /**
  * @brief Constructor function.
@@ -116,7 +104,9 @@ text::text()
  * @param location The coordinates of the view.
  * @param attr The attributes to use for the view.
  */
-text::text(const string_t &content, screen_point &location, attr_t attr)
+text::text(const string_t     &content,
+           const screen_point &location,
+           attr_t              attr)
   : view()
 {  
   vs2010_does_not_do_delegated_ctors_hrmph(content,
@@ -133,10 +123,10 @@ text::text(const string_t &content, screen_point &location, attr_t attr)
  * @param width The width of the view.
  * @param attr The attributes to use for the view.
  */
-text::text(const string_t &content,
-           screen_point   &location,
-           std::size_t     width,
-           attr_t          attr)
+text::text(const string_t     &content,
+           const screen_point &location,
+           std::size_t         width,
+           attr_t              attr)
   : view()
 {
   vs2010_does_not_do_delegated_ctors_hrmph(content,
@@ -154,11 +144,11 @@ text::text(const string_t &content,
  * @param alignment The text alignment.
  * @param attr The attributes to use for the view.
  */
-text::text(const string_t &content,
-           screen_point   &location,
-           std::size_t     width,
-           text_align      alignment,
-           attr_t          attr)
+text::text(const string_t     &content,
+           const screen_point &location,
+           std::size_t         width,
+           text_align          alignment,
+           attr_t              attr)
   : view()
 {
   vs2010_does_not_do_delegated_ctors_hrmph(content,
@@ -176,6 +166,7 @@ void
 text::set_attribute(const attr_t attr)
 {
   mInnerAttr = mClientAttr = attr;
+  invalidate();
 }
 
 /**
@@ -195,6 +186,9 @@ void
 text::set_alignment(const text_align alignment)
 {
   mAlignment = alignment;
+
+  layout();
+  invalidate();
 }
 
 /**
@@ -206,6 +200,68 @@ text::get_alignment()
   return mAlignment;
 }
 
+/**
+ * @brief Return the width the text is laid out to.
+ */
+std::size_t
+text::get_width() const
+{
+  return mWidth;
+}
+
+/**
+ * @brief Set the width the text is laid out to.
+ * @param width The width in cells.
+ *
+ * The view is resized to the new width, and the text is laid out
+ * again.
+ */
+void
+text::set_width(std::size_t width)
+{
+  invalidate();
+
+  mWidth                  = width;
+  mInnerRect.extent.width = __CAST(signed, width);
+  mClientRect.extent      = mInnerRect.extent;
+
+  layout();
+  invalidate();
+}
+
+/**
+ * @brief Does the text wrap at word boundaries?
+ */
+bool
+text::get_word_wrap() const
+{
+  return mWordWrap;
+}
+
+/**
+ * @brief Set whether the text wraps at word boundaries.
+ * @param flag @c true to break lines longer than the width at the
+ *             last space that fits; @c false to only break lines at
+ *             newlines and widen the view to fit.
+ */
+void
+text::set_word_wrap(bool flag)
+{
+  mWordWrap = flag;
+
+  layout();
+  invalidate();
+}
+
+/**
+ * @brief Return the laid out lines.
+ */
+const text::line_vector &
+text::get_lines() const
+{
+  return mLines;
+}
+
 /**
  * @brief Append a character to the view.
  * @param ch The character.
@@ -221,14 +277,18 @@ text::append(char_t ch)
  * @param ach The attributed character.
  */
 void
-text::append(achar &ach)
+text::append(const achar &ach)
 {
-  mContents.push_back(ach);
+  std::size_t from = mLines.back().start;
 
-  if (__CAST(std::size_t, mClientRect.extent.width) < mContents.length()) {
-    mInnerRect.extent.width = mContents.length();
-    mClientRect.extent      = mInnerRect.extent;
-  }
+  mContents.push_back(ach.character, ach.attribute);
+
+  // Only the last line can change, so lay out from there.
+  mLines.pop_back();
+  reflow(from);
+  fit();
+
+  invalidate();
 }
 
 /**
@@ -249,20 +309,36 @@ text::append(char_t ch, attr_t attr)
 void
 text::set_text(const string_t &content)
 {
-  std::size_t lines = scan_for_newline(content);
+  set_text(content.c_str(), content.length());
+}
+
+/**
+ * @brief Set the text for the view.
+ * @param content The text, terminated by a null.
+ *
+ * This saves literals from being copied into a string first.
+ */
+void
+text::set_text(const char_t *content)
+{
+  set_text(content, std::char_traits<char_t>::length(content));
+}
 
-  mContents.from_string(content, mInnerAttr);
+/**
+ * @brief Set the text for the view.
+ * @param content The text.
+ * @param length The number of characters.
+ */
+void
+text::set_text(const char_t *content, std::size_t length)
+{
+  // Whatever the old text covered has to be redrawn as well.
+  invalidate();
 
-  if (__CAST(std::size_t, mClientRect.extent.height) < lines) {
-    mInnerRect.extent.height = lines;
-    mClientRect.extent       = mInnerRect.extent;
-  }
+  mContents.assign(content, length, mInnerAttr);
 
-  if (__CAST(std::size_t, mClientRect.extent.width) < mContents.length()) {
-    mInnerRect.extent.width = mContents.length();
-    mClientRect.extent      = mInnerRect.extent;
-    mWidth                  = mInnerRect.extent.width;
-  }
+  layout();
+  invalidate();
 }
 
 /**
@@ -272,20 +348,13 @@ text::set_text(const string_t &content)
 void
 text::set_text(const astring &content)
 {
-  std::size_t lines = scan_for_newline(content.to_string());
+  // Whatever the old text covered has to be redrawn as well.
+  invalidate();
 
-  mContents = content;
+  mContents.assign(content);
 
-  if (__CAST(std::size_t, mClientRect.extent.height) < lines) {
-    mInnerRect.extent.height = lines;
-    mClientRect.extent       = mInnerRect.extent;
-  }
-
-  if (__CAST(std::size_t, mClientRect.extent.width) < mContents.length()) {
-    mInnerRect.extent.width = mContents.length();
-    mClientRect.extent      = mInnerRect.extent;
-    mWidth                  = mInnerRect.extent.width;
-  }
+  layout();
+  invalidate();
 }
 
 /**
@@ -298,40 +367,215 @@ text::get_text()
 }
 
 /**
- * @brief Render the view to a draw buffer.
+ * @brief Return how far into the view a line starts.
+ * @param length The length of the line.
  */
-void
-text::render()
+std::size_t
+text::align_offset(std::size_t length) const
 {
-  extern draw_buffer GlobalDrawBuffer;
+  std::size_t width = __CAST(std::size_t, mClientRect.extent.width);
 
-  std::size_t len = mContents.size();
-  std::size_t pos = mClientRect.origin.x +
-                    mClientRect.origin.y *
-                    screen::get_instance().get_columns();
+  if (length % 2 != 0) {
+    length++;
+  }
 
-  if (len % 2 != 0) {
-    len++;
+  if (length > width) {
+    return 0;
   }
 
   switch (mAlignment) {
     case AlignRight:
-      pos += (mClientRect.extent.width - len);
-      break;
+      return width - length;
 
     case AlignCenter:
-      pos += ((mClientRect.extent.width / 2) - (len / 2));
-      break;
+      return (width / 2) - (length / 2);
 
     case AlignLeft:
     default:
-      /* Do nothing. */
+      return 0;
+  }
+}
+
+/**
+ * @brief Lay the text out from scratch.
+ */
+void
+text::layout()
+{
+  mLines.clear();
+
+  reflow(0);
+  fit();
+}
+
+/**
+ * @brief Lay out the text from the start of a line onwards.
+ * @param from The offset of the first character of the line.
+ *
+ * Lines end at newlines.  With word wrap on, a line longer than the
+ * width is broken at the last space that fits, and the space is
+ * dropped; a word longer than the width is simply cut.  There is
+ * always at least one line, even if it is empty.
+ */
+void
+text::reflow(std::size_t from)
+{
+  const string_t &chars = mContents.characters();
+  std::size_t     len   = chars.length();
+  std::size_t     start = from;
+  std::size_t     stop  = 0;
+  std::size_t     next  = 0;
+  text_line       line;
+
+  for (;;) {
+    for (stop = start; stop < len && chars[stop] != L'\n'; ++stop)
+      ;
+
+    next = stop < len ? stop + 1 : stop;
+
+    if (mWordWrap && mWidth > 0 && stop - start > mWidth) {
+      std::size_t space = start + mWidth;
+
+      while (space > start && chars[space] != L' ') {
+        --space;
+      }
+
+      if (space > start) {
+        stop = space;
+        next = space + 1;
+      } else {
+        stop = start + mWidth;
+        next = stop;
+      }
+    }
+
+    line.start  = start;
+    line.length = stop - start;
+    line.offset = 0;
+
+    mLines.push_back(line);
+
+    if (stop == len || (next >= len && chars[next - 1] != L'\n')) {
       break;
+    }
+
+    start = next;
+  }
+}                                       // text::reflow
+
+/**
+ * @brief Grow the view to fit the layout, and align the lines.
+ *
+ * Views never shrink, so that whatever they covered before is
+ * still redrawn.  Without word wrap the view widens to the longest
+ * line.
+ */
+void
+text::fit()
+{
+  std::size_t widest = 0;
+
+  for (std::size_t i = 0; i < mLines.size(); ++i) {
+    widest = std::max(widest, mLines[i].length);
+  }
+
+  if (__CAST(std::size_t, mInnerRect.extent.height) < mLines.size()) {
+    mInnerRect.extent.height = __CAST(signed, mLines.size());
+    mClientRect.extent       = mInnerRect.extent;
+  }
+
+  if (!mWordWrap &&
+      __CAST(std::size_t, mInnerRect.extent.width) < widest)
+  {
+    mInnerRect.extent.width = __CAST(signed, widest);
+    mClientRect.extent      = mInnerRect.extent;
+    mWidth                  = widest;
+  }
+
+  for (std::size_t i = 0; i < mLines.size(); ++i) {
+    mLines[i].offset = align_offset(mLines[i].length);
+  }
+}
+
+/**
+ * @brief Return the area that the view covers completely.
+ *
+ * Only the cells the text is written to are covered; the rest of
+ * the view shows whatever is underneath.  For text laid out over
+ * several lines this is the columns that every line covers.
+ */
+rect
+text::opaque_rect()
+{
+  std::size_t left  = 0;
+  std::size_t right = 0;
+
+  for (std::size_t i = 0; i < mLines.size(); ++i) {
+    std::size_t start = mLines[i].offset;
+    std::size_t end   = mLines[i].offset + mLines[i].length;
+
+    left  = (i == 0) ? start : std::max(left, start);
+    right = (i == 0) ? end   : std::min(right, end);
+  }
+
+  if (right <= left) {
+    return rect();
+  }
+
+  return rect(mClientRect.left() + __CAST(signed, left),
+              mClientRect.top(),
+              __CAST(signed, right - left),
+              __CAST(signed, mLines.size()));
+}
+
+/**
+ * @brief Take the cells the text is written to out of the damage.
+ * @param damage The damage left for the views underneath.
+ *
+ * Lines of different lengths cover more than their opaque rect, so
+ * each line's span is taken out on its own.
+ */
+void
+text::occlude(region &damage)
+{
+  signed row = mClientRect.top();
+
+  for (std::size_t i = 0; i < mLines.size(); ++i, ++row) {
+    if (mLines[i].length == 0) {
+      continue;
+    }
+
+    damage.subtract(rect(mClientRect.left() +
+                           __CAST(signed, mLines[i].offset),
+                         row,
+                         __CAST(signed, mLines[i].length),
+                         1));
+  }
+}
+
+/**
+ * @brief Render the view to a draw buffer.
+ *
+ * The layout is worked out whenever the text, width or alignment
+ * changes, so this only copies each line's span of characters.
+ */
+void
+text::render()
+{
+  draw_buffer &target = canvas();
+  std::size_t  width  = target.get_size().width;
+  std::size_t  row    = mClientRect.origin.y;
+
+  for (std::size_t i = 0; i < mLines.size(); ++i, ++row) {
+    if (mLines[i].length == 0) {
+      continue;
+    }
+
+    target.move_str(mClientRect.origin.x + mLines[i].offset + row * width,
+                    mContents,
+                    mLines[i].start,
+                    mLines[i].length);
   }
-  
-  GlobalDrawBuffer.move_str(pos,
-                            mContents,
-                            false);
 }
 
 // text.cpp ends here
@@ -39,6 +39,7 @@
  */
  
 #include "view.hpp"
+#include "region.hpp"
 #include "screen.hpp"
 #include "drawbuffer.hpp"
 
@@ -54,6 +55,52 @@ const attr_t DefaultViewClientAttr = fg_white | bg_blue | fg_intense;
  */
 const attr_t DefaultViewInnerAttr  = fg_grey | bg_blue;
 
+/**
+ * @brief The draw buffer views render to, or null for the global
+ *        draw buffer.
+ */
+static draw_buffer *CurrentCanvas = 0;
+
+/**
+ * @brief Return the off-screen buffer that layers are built in.
+ *
+ * It is created the first time a layer is built, and follows the
+ * global draw buffer's size so that views lay out the same way.
+ */
+static
+draw_buffer &
+layer_canvas()
+{
+  static draw_buffer scratch;
+
+  if (scratch.get_size().width  != GlobalDrawBuffer.get_size().width ||
+      scratch.get_size().height != GlobalDrawBuffer.get_size().height)
+  {
+    scratch.resize();
+  }
+
+  return scratch;
+}
+
+/**
+ * @brief Return the draw buffer that views render to.
+ */
+draw_buffer &
+view::canvas()
+{
+  return CurrentCanvas ? *CurrentCanvas : GlobalDrawBuffer;
+}
+
+/**
+ * @brief Set the draw buffer that views render to.
+ * @param target The draw buffer, or null for the global draw buffer.
+ */
+void
+view::set_canvas(draw_buffer *target)
+{
+  CurrentCanvas = target;
+}
+
 /**
  * @brief Default constructor function.
  */
@@ -62,19 +109,29 @@ view::view()
     mInnerRect(rect()),
     mClientAttr(DefaultViewClientAttr),
     mInnerAttr(DefaultViewInnerAttr),
-    mDrawBorder(true)
+    mDrawBorder(true),
+    mInvalid(true),
+    mDirtyRect(mClientRect),
+    mCached(false),
+    mLayerStale(true),
+    mLayer()
 {}
 
 /**
  * @brief Constructor method.
  * @param area The geometry rect for the view.
  */
-view::view(rect &area)
+view::view(const rect &area)
   : mClientRect(area),
     mInnerRect(area.contract_copy(1, 1)),
     mClientAttr(DefaultViewClientAttr),
     mInnerAttr(DefaultViewInnerAttr),
-    mDrawBorder(true)
+    mDrawBorder(true),
+    mInvalid(true),
+    mDirtyRect(mClientRect),
+    mCached(false),
+    mLayerStale(true),
+    mLayer()
 {}
 
 /**
@@ -83,12 +140,17 @@ view::view(rect &area)
  * @param clientAttr Attributes for the client area.
  * @param innerAttr Attributes for the inner area.
  */
-view::view(rect &area, attr_t clientAttr, attr_t innerAttr)
+view::view(const rect &area, attr_t clientAttr, attr_t innerAttr)
   : mClientRect(area),
     mInnerRect(area.contract_copy(1, 1)),
     mClientAttr(clientAttr),
     mInnerAttr(innerAttr),
-    mDrawBorder(true)
+    mDrawBorder(true),
+    mInvalid(true),
+    mDirtyRect(mClientRect),
+    mCached(false),
+    mLayerStale(true),
+    mLayer()
 {}
 
 /**
@@ -115,6 +177,32 @@ view::inner_rect()
   return mInnerRect;
 }
 
+/**
+ * @brief Return the area that the view covers completely.
+ *
+ * Every cell of this area is written when the view is rendered, so
+ * nothing underneath it needs to be drawn.  A plain view fills its
+ * whole client rect.
+ */
+rect
+view::opaque_rect()
+{
+  return mClientRect;
+}
+
+/**
+ * @brief Take the cells the view covers out of the damage.
+ * @param damage The damage left for the views underneath.
+ *
+ * This takes out the opaque rect.  Views that cover a ragged area
+ * can take out more than any one rectangle would.
+ */
+void
+view::occlude(region &damage)
+{
+  damage.subtract(opaque_rect());
+}
+
 /**
  * @brief Return the inner rect attribute.
  */
@@ -140,6 +228,7 @@ void
 view::set_inner_attribute(const attr_t attr)
 {
   mInnerAttr = attr;
+  invalidate();
 }
 
 /**
@@ -149,6 +238,7 @@ void
 view::set_client_attribute(const attr_t attr)
 {
   mClientAttr = attr;
+  invalidate();
 }
 
 /**
@@ -171,6 +261,188 @@ void
 view::set_draw_border(bool flag)
 {
   mDrawBorder = flag;
+  invalidate();
+}
+
+/**
+ * @brief Mark the whole view as needing to be redrawn.
+ */
+void
+view::invalidate()
+{
+  invalidate(mClientRect);
+}
+
+/**
+ * @brief Mark part of the view as changed.
+ * @param area The area, in screen coordinates.
+ *
+ * The cached layer, if there is one, is rebuilt before it is next
+ * drawn.
+ */
+void
+view::invalidate(const rect &area)
+{
+  mLayerStale = true;
+
+  damage(area);
+}
+
+/**
+ * @brief Mark part of the screen as needing to be redrawn.
+ * @param area The area, in screen coordinates.
+ *
+ * Unlike @c invalidate, this does not mean the view has changed, so
+ * a cached layer is kept.
+ *
+ * The dirty rectangle grows to cover every area invalidated since
+ * the view was last drawn.  An empty dirty rectangle, as left by a
+ * view constructed before its geometry was known, is replaced.
+ *
+ * Views that change size should invalidate before and after the
+ * change, so that whatever the old geometry covered is redrawn by
+ * the views underneath.
+ */
+void
+view::damage(const rect &area)
+{
+  if (mInvalid && mDirtyRect.area() > 0) {
+    mDirtyRect = mDirtyRect | area;
+  } else {
+    mDirtyRect = area;
+    mInvalid   = true;
+  }
+}
+
+/**
+ * @brief Move the view.
+ * @param origin The new top-left corner of the client rect.
+ *
+ * Where the view was and where it now is both need redrawing, but
+ * the view itself has not changed, so a cached layer is just drawn
+ * in the new place.
+ */
+void
+view::move_to(const point &origin)
+{
+  signed dx = origin.x - mClientRect.left();
+  signed dy = origin.y - mClientRect.top();
+
+  damage(mClientRect);
+
+  mClientRect.move(dx, dy);
+  mInnerRect.move(dx, dy);
+
+  damage(mClientRect);
+}
+
+/**
+ * @brief Mark the view as drawn.
+ */
+void
+view::validate()
+{
+  mInvalid   = false;
+  mDirtyRect = rect();
+}
+
+/**
+ * @brief Does the view need to be redrawn?
+ * @returns @c true if the view has been invalidated since it was
+ *          last drawn; otherwise @c false is returned.
+ */
+bool
+view::is_invalid() const
+{
+  return mInvalid;
+}
+
+/**
+ * @brief Return the area that needs to be redrawn.
+ */
+const rect &
+view::dirty_rect() const
+{
+  return mDirtyRect;
+}
+
+/**
+ * @brief Does the view keep a cached layer?
+ */
+bool
+view::get_cached() const
+{
+  return mCached;
+}
+
+/**
+ * @brief Set whether the view keeps a cached layer.
+ * @param flag @c true to render the view into an off-screen layer
+ *             that is only rebuilt when the view changes; @c false
+ *             to render it every time it is drawn.
+ *
+ * Caching suits views that are large and rarely change, at the cost
+ * of a picture map the size of the client rect.
+ */
+void
+view::set_cached(bool flag)
+{
+  mCached     = flag;
+  mLayerStale = true;
+
+  if (!mCached) {
+    mLayer = picmap();
+  }
+}
+
+/**
+ * @brief Draw part of the view to the canvas.
+ * @param area The area to draw, in screen coordinates.
+ *
+ * An uncached view is rendered with the canvas clipped to the area.
+ * A cached view has its layer rebuilt if it has changed, and the
+ * opaque part of the layer within the area is copied to the canvas.
+ */
+void
+view::paint(const rect &area)
+{
+  rect         opaque = opaque_rect();
+  screen_size  extent;
+  draw_buffer &target = canvas();
+
+  if (!mCached) {
+    target.set_clip(area);
+    render();
+    return;
+  }
+
+  if (mLayerStale) {
+    draw_buffer &scratch  = layer_canvas();
+    draw_buffer *previous = CurrentCanvas;
+
+    CurrentCanvas = &scratch;
+    scratch.set_clip(mClientRect);
+    render();
+    scratch.reset_clip();
+    CurrentCanvas = previous;
+
+    scratch.copy_to(mLayer, mClientRect);
+    mLayerStale = false;
+  }
+
+  if (!area.touches(opaque)) {
+    return;
+  }
+
+  extent = mLayer.get_size();
+
+  target.set_clip(area & opaque);
+  target.blit(mLayer,
+              rect(0,
+                   0,
+                   __CAST(signed, extent.width),
+                   __CAST(signed, extent.height)),
+              point(mClientRect.left(), mClientRect.top()));
 }
 
 /**
@@ -179,16 +451,55 @@ view::set_draw_border(bool flag)
 void
 view::render()
 {
-  extern draw_buffer GlobalDrawBuffer;
+  // The border ring takes the client attribute and everything
+  // inside it the inner attribute, in one pass.
+  canvas().draw_rect(mClientRect, mClientAttr, mInnerAttr, mDrawBorder);
+}
 
-  GlobalDrawBuffer.draw_rect(mClientRect,
-                             mClientAttr,
-                             mClientAttr,
-                             mDrawBorder);
-  
-  GlobalDrawBuffer.draw_rect(mInnerRect,
-                             mInnerAttr,
-                             mInnerAttr);
+/**
+ * @brief Render the view everywhere except a hole.
+ * @param hole The area to leave alone.
+ *
+ * Views that draw something of their own over part of the base view
+ * use this so that the cells underneath are not written twice.  The
+ * draw buffer's clip rectangle is split around the hole and put
+ * back afterwards.
+ *
+ * The pieces are worked out in a region that is kept from call to
+ * call, so that drawing a frame does not allocate.
+ */
+void
+view::render_around(const rect &hole)
+{
+  static region parts;
+
+  draw_buffer &target = canvas();
+  rect         saved  = target.get_clip();
+
+  parts.clear();
+  parts.add(saved);
+  parts.subtract(hole);
+
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    target.set_clip(parts[i]);
+    view::render();
+  }
+
+  target.set_clip(saved);
+}
+
+/**
+ * @brief The screen has been resized.
+ * @param extent The new screen size.
+ *
+ * Views are laid out in absolute coordinates, so there is nothing
+ * to do here.  Views that want to follow the screen size can
+ * override this.
+ */
+void
+view::resized(const screen_size &extent)
+{
+  (void)extent;
 }
 
 // view.cpp ends here